@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_frames) : replacer_size_(num_frames), entries_(num_frames) {}
+
+auto ARCReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  if (curr_size_ == 0) {
+    return false;
+  }
+  // Shrink T1 while it is above its target, otherwise shrink T2. Pinned frames cannot be evicted, so fall back to the
+  // other list if the preferred one has no evictable frame.
+  if (t1_.size() > target_t1_size_ || t2_.empty()) {
+    return EvictFrom(&t1_, &b1_, frame_id) || EvictFrom(&t2_, &b2_, frame_id);
+  }
+  return EvictFrom(&t2_, &b2_, frame_id) || EvictFrom(&t1_, &b1_, frame_id);
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+
+  auto &entry = entries_[frame_id];
+  if (entry.list_ == ListType::T1) {
+    t2_.splice(t2_.begin(), t1_, entry.pos_);
+    entry.list_ = ListType::T2;
+    return;
+  }
+  if (entry.list_ == ListType::T2) {
+    t2_.splice(t2_.begin(), t2_, entry.pos_);
+    return;
+  }
+
+  // A page that is not resident. If it was evicted recently, adapt the target size of T1 towards the list that
+  // should have kept it, and admit it straight into T2.
+  auto ghost = entry.page_id_ == INVALID_PAGE_ID ? ghosts_.end() : ghosts_.find(entry.page_id_);
+  if (ghost == ghosts_.end()) {
+    t1_.push_front(frame_id);
+    entry.list_ = ListType::T1;
+  } else {
+    if (ghost->second.first) {
+      const size_t delta = std::max<size_t>(b2_.size() / b1_.size(), 1);
+      target_t1_size_ = std::min(target_t1_size_ + delta, replacer_size_);
+    } else {
+      const size_t delta = std::max<size_t>(b1_.size() / b2_.size(), 1);
+      target_t1_size_ = target_t1_size_ > delta ? target_t1_size_ - delta : 0;
+    }
+    EraseGhost(entry.page_id_);
+    t2_.push_front(frame_id);
+    entry.list_ = ListType::T2;
+  }
+  entry.pos_ = entry.list_ == ListType::T1 ? t1_.begin() : t2_.begin();
+  TrimGhosts();
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+
+  auto &entry = entries_[frame_id];
+  if (entry.list_ == ListType::NONE || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+    return;
+  }
+  auto &entry = entries_[frame_id];
+  if (entry.list_ == ListType::NONE || !entry.evictable_) {
+    return;
+  }
+  // The page is gone for good, so it is not remembered in a ghost list.
+  (entry.list_ == ListType::T1 ? t1_ : t2_).erase(entry.pos_);
+  entry = ArcEntry{};
+  curr_size_--;
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+void ARCReplacer::SetPageId(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  entries_[frame_id].page_id_ = page_id;
+}
+
+auto ARCReplacer::GetTargetT1Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return target_t1_size_;
+}
+
+auto ARCReplacer::EvictFrom(std::list<frame_id_t> *list, std::list<page_id_t> *ghost, frame_id_t *frame_id) -> bool {
+  for (auto it = list->rbegin(); it != list->rend(); ++it) {
+    auto &entry = entries_[*it];
+    if (!entry.evictable_) {
+      continue;
+    }
+    *frame_id = *it;
+    list->erase(std::next(it).base());
+    if (entry.page_id_ != INVALID_PAGE_ID) {
+      ghost->push_front(entry.page_id_);
+      ghosts_[entry.page_id_] = {ghost == &b1_, ghost->begin()};
+    }
+    entry = ArcEntry{};
+    curr_size_--;
+    TrimGhosts();
+    return true;
+  }
+  return false;
+}
+
+void ARCReplacer::EraseGhost(page_id_t page_id) {
+  auto ghost = ghosts_.find(page_id);
+  if (ghost == ghosts_.end()) {
+    return;
+  }
+  (ghost->second.first ? b1_ : b2_).erase(ghost->second.second);
+  ghosts_.erase(ghost);
+}
+
+void ARCReplacer::TrimGhosts() {
+  while (t1_.size() + b1_.size() > replacer_size_ && !b1_.empty()) {
+    ghosts_.erase(b1_.back());
+    b1_.pop_back();
+  }
+  while (t1_.size() + t2_.size() + b1_.size() + b2_.size() > 2 * replacer_size_ && !(b1_.empty() && b2_.empty())) {
+    auto &victim_list = b2_.empty() ? b1_ : b2_;
+    ghosts_.erase(victim_list.back());
+    victim_list.pop_back();
+  }
+}
+
+}  // namespace bustub
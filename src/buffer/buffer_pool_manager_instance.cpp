@@ -12,6 +12,8 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/macros.h"
@@ -19,15 +21,33 @@
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
-  replacer_ = new LRUKReplacer(pool_size, replacer_k);
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager, replacer_type) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      drain_from_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      replacer_type_(replacer_type),
+      replacer_k_(replacer_k) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 0.");
+  page_table_ = new PageTable(pool_size_);
+  replacer_ = Replacer::Create(replacer_type, pool_size, replacer_k);
 
   // Initially, every page is in the free list.
+  arena_.Reserve(pool_size_);
   for (size_t i = 0; i < pool_size_; ++i) {
+    pages_.emplace_back(arena_.FrameData(i));
+    frame_io_.emplace_back();
     free_list_.emplace_back(static_cast<int>(i));
   }
 
@@ -40,56 +60,125 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManag
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
-  delete[] pages_;
+  StopBackgroundWriter();
+  // Let the prefetches in flight land before their frames go away.
+  disk_scheduler_.reset();
   delete page_table_;
-  delete replacer_;
 }
 
-auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
-  std::scoped_lock<std::mutex> lock(latch_);
+auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * { return NewPgInRingImp(page_id, nullptr); }
+
+auto BufferPoolManagerInstance::NewPgInRingImp(page_id_t *page_id, BufferRing *ring) -> Page * {
+  auto lock = LockLatch();
 
-  // std::cout << "[BPM:NewPg]" << std::endl;
   frame_id_t frame_id;
-  auto *page = GetVictimPage(&frame_id, INVALID_PAGE_ID);
+  auto *page = AcquireFrame(lock, &frame_id, INVALID_PAGE_ID, ring);
   if (page == nullptr) {
     return nullptr;
   }
 
+  page->ResetMemory();
+  FinishFrameIo(frame_id);
   *page_id = page->GetPageId();
   return page;
 }
 
-auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
-  std::scoped_lock<std::mutex> lock(latch_);
+auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * { return FetchPgInRingImp(page_id, nullptr); }
+
+auto BufferPoolManagerInstance::FetchPgInRingImp(page_id_t page_id, BufferRing *ring) -> Page * {
+  ValidatePageId(page_id);
+  auto lock = LockLatch();
 
   frame_id_t frame_id;
-  if (page_table_->Find(page_id, frame_id)) {
+  if (FindFrame(lock, page_id, &frame_id)) {
+    stats_.hits_.Add();
+    // A page someone else needs must not be recycled by the ring that loaded it.
+    if (ring == nullptr) {
+      frame_io_[frame_id].in_ring_ = false;
+    }
     pages_[frame_id].pin_count_++;
     replacer_->RecordAccess(frame_id);
     replacer_->SetEvictable(frame_id, false);
-    // std::cout << "[BPM:FetchPg] page_id: " << page_id << " in buffer pool" << std::endl;
     return &pages_[frame_id];
   }
 
-  auto *page = GetVictimPage(&frame_id, page_id);
+  stats_.misses_.Add();
+  auto *page = AcquireFrame(lock, &frame_id, page_id, ring);
   if (page == nullptr) {
     return nullptr;
   }
 
-  // std::cout << "[BPM:FetchPg] page_id: " << page_id << " fetch from disk" << std::endl;
-  char page_data[BUSTUB_PAGE_SIZE];
-  disk_manager_->ReadPage(page_id, page_data);
-  memcpy(page->data_, page_data, BUSTUB_PAGE_SIZE);
+  // The frame is reserved for page_id and marked as "I/O in progress", so the read can run without the latch.
+  lock.unlock();
+  disk_manager_->ReadPage(page_id, page->data_);
+  lock.lock();
 
+  FinishFrameIo(frame_id);
   return page;
 }
 
+void BufferPoolManagerInstance::PrefetchPgImp(page_id_t page_id, BufferRing *ring) {
+  ValidatePageId(page_id);
+  auto lock = LockLatch();
+
+  frame_id_t frame_id;
+  if (page_table_->Find(page_id, frame_id)) {
+    return;
+  }
+  if (AcquireFrame(lock, &frame_id, page_id, ring) == nullptr) {
+    return;
+  }
+
+  // Nobody asked for the page yet, so drop the pin of AcquireFrame() once it is in.
+  ScheduleRead(frame_id, [this, frame_id] {
+    auto lock = LockLatch();
+    FinishFrameIo(frame_id);
+    if (--pages_[frame_id].pin_count_ == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  });
+}
+
+auto BufferPoolManagerInstance::FetchPgAsyncImp(page_id_t page_id) -> std::future<Page *> {
+  ValidatePageId(page_id);
+  auto promise = std::make_shared<std::promise<Page *>>();
+  auto future = promise->get_future();
+  auto lock = LockLatch();
+
+  frame_id_t frame_id;
+  if (FindFrame(lock, page_id, &frame_id)) {
+    stats_.hits_.Add();
+    frame_io_[frame_id].in_ring_ = false;
+    pages_[frame_id].pin_count_++;
+    replacer_->RecordAccess(frame_id);
+    replacer_->SetEvictable(frame_id, false);
+    promise->set_value(&pages_[frame_id]);
+    return future;
+  }
+
+  stats_.misses_.Add();
+  auto *page = AcquireFrame(lock, &frame_id, page_id, nullptr);
+  if (page == nullptr) {
+    promise->set_value(nullptr);
+    return future;
+  }
+
+  // The pin of AcquireFrame() is handed over to the caller.
+  ScheduleRead(frame_id, [this, frame_id, page, promise] {
+    {
+      auto lock = LockLatch();
+      FinishFrameIo(frame_id);
+    }
+    promise->set_value(page);
+  });
+  return future;
+}
+
 auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  auto lock = LockLatch();
 
   frame_id_t frame_id;
-  if (!page_table_->Find(page_id, frame_id)) {
-    // std::cout << "[BPM:UnpinPg] page_id: " << page_id << "not in page_table" << std::endl;
+  if (!FindFrame(lock, page_id, &frame_id)) {
     return false;
   }
 
@@ -101,48 +190,71 @@ auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) ->
   page->pin_count_--;
   if (page->GetPinCount() == 0) {
     replacer_->SetEvictable(frame_id, true);
+    if (static_cast<size_t>(frame_id) >= drain_from_) {
+      drain_cv_.notify_all();
+    }
   }
 
   if (is_dirty) {
-    page->is_dirty_ = true;
+    SetDirty(page, true);
   }
 
-  // std::cout << "[BPM:UnpinPg] page_id: " << page_id << " unpin success, new pin count: " << page->pin_count_
-  //            << std::endl;
   return true;
 }
 
 auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  auto lock = LockLatch();
 
   frame_id_t frame_id;
-  if (!page_table_->Find(page_id, frame_id)) {
-    // std::cout << "[BPM:FlushPg] page_id: %d" << page_id << " not in page_table" << std::endl;
+  if (!FindFrame(lock, page_id, &frame_id)) {
     return false;
   }
 
-  Page *page = &pages_[frame_id];
-  disk_manager_->WritePage(page_id, page->GetData());
-  page->is_dirty_ = false;
-  // std::cout << "[BPM:FlushPg] page_id: " << page_id << " flush success" << '\n';
+  WriteBackFrame(lock, frame_id);
   return true;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
-  std::scoped_lock<std::mutex> lock(latch_);
+  auto lock = LockLatch();
 
+  // The frames are written in batches without the latch, so the pool stays usable during a checkpoint. A page that is
+  // dirtied again after its frame was visited stays dirty.
+  std::vector<frame_id_t> batch;
   for (size_t i = 0; i < pool_size_; i++) {
-    Page *page = &pages_[i];
-    disk_manager_->WritePage(page->GetPageId(), page->GetData());
-    page->is_dirty_ = false;
+    auto frame_id = static_cast<frame_id_t>(i);
+    if (frame_io_[frame_id].in_progress_) {
+      // Never wait while holding the frames of a batch, or two concurrent flushes could wait for each other.
+      WriteBackFrames(lock, &batch);
+      while (frame_io_[frame_id].in_progress_) {
+        frame_io_[frame_id].cv_.wait(lock);
+      }
+      // A shrinking Resize() may have removed the frame meanwhile.
+      if (i >= pool_size_) {
+        break;
+      }
+    }
+    if (pages_[frame_id].GetPageId() == INVALID_PAGE_ID) {
+      continue;
+    }
+    BeginWriteBack(frame_id);
+    batch.push_back(frame_id);
+    if (batch.size() == WRITE_BACK_BATCH_SIZE) {
+      WriteBackFrames(lock, &batch);
+    }
   }
+  WriteBackFrames(lock, &batch);
+  lock.unlock();
+  disk_manager_->FlushFreePageMap();
 }
 
 auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  auto lock = LockLatch();
 
   frame_id_t frame_id;
-  if (!page_table_->Find(page_id, frame_id)) {
+  if (!FindFrame(lock, page_id, &frame_id)) {
+    if (page_id != INVALID_PAGE_ID) {
+      DeallocatePage(page_id);
+    }
     return true;
   }
 
@@ -153,14 +265,379 @@ auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
 
   page_table_->Remove(page_id);
   replacer_->Remove(frame_id);
-  free_list_.push_back(frame_id);
+  if (static_cast<size_t>(frame_id) < drain_from_) {
+    free_list_.push_back(frame_id);
+  }
   page->ResetMemory();
-  page->is_dirty_ = false;
+  page->page_id_ = INVALID_PAGE_ID;
+  SetDirty(page, false);
   DeallocatePage(page_id);
 
   return true;
 }
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
+auto BufferPoolManagerInstance::AcquireFrame(std::unique_lock<std::mutex> &lock, frame_id_t *frame_id,
+                                             page_id_t page_id, BufferRing *ring) -> Page * {
+  bool found = ring != nullptr && RecycleRingFrame(ring, frame_id);
+  if (!found && !free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    found = true;
+  }
+  if (!found && !replacer_->Evict(frame_id)) {
+    return nullptr;
+  }
+
+  Page *page = &pages_[*frame_id];
+  const page_id_t old_page_id = page->GetPageId();
+  const bool old_is_dirty = page->IsDirty();
+
+  if (page_id == INVALID_PAGE_ID) {
+    page_id = AllocatePage();
+  }
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  SetDirty(page, false);
+  frame_io_[*frame_id].in_progress_ = true;
+  frame_io_[*frame_id].in_ring_ = ring != nullptr;
+  if (ring != nullptr) {
+    ring->Advance(this, *frame_id, page_id);
+  }
+
+  page_table_->Insert(page_id, *frame_id);
+  replacer_->SetPageId(*frame_id, page_id);
+  replacer_->RecordAccess(*frame_id);
+  replacer_->SetEvictable(*frame_id, false);
+
+  if (old_page_id != INVALID_PAGE_ID) {
+    stats_.evictions_.Add();
+  }
+  if (old_is_dirty) {
+    stats_.dirty_write_backs_.Add();
+    lock.unlock();
+    disk_manager_->WritePage(old_page_id, page->GetData());
+    lock.lock();
+  }
+  if (old_page_id != INVALID_PAGE_ID) {
+    page_table_->Remove(old_page_id);
+  }
+  return page;
+}
+
+auto BufferPoolManagerInstance::RecycleRingFrame(BufferRing *ring, frame_id_t *frame_id) -> bool {
+  const auto &slot = ring->CurrentSlot();
+  // Slots filled by another instance of a parallel buffer pool are not ours to recycle.
+  if (slot.owner_ != this || static_cast<size_t>(slot.frame_id_) >= drain_from_) {
+    return false;
+  }
+  const Page &page = pages_[slot.frame_id_];
+  const FrameIoState &state = frame_io_[slot.frame_id_];
+  if (page.page_id_ != slot.page_id_ || page.pin_count_ > 0 || state.in_progress_ || !state.in_ring_) {
+    return false;
+  }
+  // The frame is unpinned, so it is evictable and Remove() takes it out of the replacer.
+  replacer_->Remove(slot.frame_id_);
+  *frame_id = slot.frame_id_;
+  return true;
+}
+
+auto BufferPoolManagerInstance::FindFrame(std::unique_lock<std::mutex> &lock, page_id_t page_id, frame_id_t *frame_id)
+    -> bool {
+  // The frame may be rebound to another page while we wait, so look the page up again after every wakeup.
+  while (page_table_->Find(page_id, *frame_id)) {
+    if (!frame_io_[*frame_id].in_progress_) {
+      return true;
+    }
+    stats_.pin_waits_.Add();
+    frame_io_[*frame_id].cv_.wait(lock);
+  }
+  return false;
+}
+
+void BufferPoolManagerInstance::FinishFrameIo(frame_id_t frame_id) {
+  frame_io_[frame_id].in_progress_ = false;
+  frame_io_[frame_id].cv_.notify_all();
+  if (static_cast<size_t>(frame_id) >= drain_from_) {
+    drain_cv_.notify_all();
+  }
+}
+
+void BufferPoolManagerInstance::ScheduleRead(frame_id_t frame_id, std::function<void()> on_read) {
+  if (disk_scheduler_ == nullptr) {
+    disk_scheduler_ = std::make_unique<DiskScheduler>(disk_manager_, PREFETCH_IO_THREADS);
+  }
+  Page *page = &pages_[frame_id];
+  disk_scheduler_->Schedule(DiskRequest{false, page->data_, page->page_id_, std::move(on_read)});
+}
+
+void BufferPoolManagerInstance::WriteBackFrame(std::unique_lock<std::mutex> &lock, frame_id_t frame_id) {
+  std::vector<frame_id_t> frames{frame_id};
+  BeginWriteBack(frame_id);
+  WriteBackFrames(lock, &frames);
+}
+
+void BufferPoolManagerInstance::BeginWriteBack(frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  if (page->is_dirty_) {
+    stats_.dirty_write_backs_.Add();
+  }
+  SetDirty(page, false);
+  page->pin_count_++;
+  replacer_->SetEvictable(frame_id, false);
+  frame_io_[frame_id].in_progress_ = true;
+}
+
+void BufferPoolManagerInstance::WriteBackFrames(std::unique_lock<std::mutex> &lock, std::vector<frame_id_t> *frames) {
+  if (frames->empty()) {
+    return;
+  }
+  std::vector<DiskManager::PageIo> pages;
+  pages.reserve(frames->size());
+  for (auto frame_id : *frames) {
+    pages.push_back({pages_[frame_id].GetPageId(), pages_[frame_id].GetData()});
+  }
+
+  lock.unlock();
+  disk_manager_->WritePages(pages);
+  lock.lock();
+
+  for (auto frame_id : *frames) {
+    FinishFrameIo(frame_id);
+    if (--pages_[frame_id].pin_count_ == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+  frames->clear();
+}
+
+auto BufferPoolManagerInstance::LockLatch() -> std::unique_lock<std::mutex> {
+  std::unique_lock<std::mutex> lock(latch_, std::try_to_lock);
+  // Only a contended latch is timed, the clock is not free either.
+  if (!lock.owns_lock()) {
+    const auto start = std::chrono::steady_clock::now();
+    lock.lock();
+    const auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    stats_.latch_waits_.Add();
+    stats_.latch_wait_ns_.Add(waited.count());
+  }
+  return lock;
+}
+
+auto BufferPoolManagerInstance::GetStats() -> BufferPoolStats {
+  BufferPoolStats stats;
+  stats.pool_size_ = pool_size_;
+  stats.hits_ = stats_.hits_.Get();
+  stats.misses_ = stats_.misses_.Get();
+  stats.evictions_ = stats_.evictions_.Get();
+  stats.dirty_write_backs_ = stats_.dirty_write_backs_.Get();
+  stats.pin_waits_ = stats_.pin_waits_.Get();
+  stats.latch_waits_ = stats_.latch_waits_.Get();
+  stats.latch_wait_ns_ = stats_.latch_wait_ns_.Get();
+  return stats;
+}
+
+void BufferPoolManagerInstance::SetDirty(Page *page, bool is_dirty) {
+  if (page->is_dirty_ == is_dirty) {
+    return;
+  }
+  page->is_dirty_ = is_dirty;
+  if (!is_dirty) {
+    num_dirty_frames_--;
+    return;
+  }
+  // Wake up the writer when the watermark is crossed, not on every page dirtied above it.
+  if (++num_dirty_frames_ == dirty_high_watermark_ + 1 && background_writer_enabled_) {
+    background_writer_cv_.notify_one();
+  }
+}
+
+void BufferPoolManagerInstance::StartBackgroundWriter(std::chrono::milliseconds interval,
+                                                      double dirty_high_watermark) {
+  auto lock = LockLatch();
+  if (background_writer_enabled_) {
+    return;
+  }
+  background_writer_enabled_ = true;
+  dirty_high_watermark_ = static_cast<size_t>(static_cast<double>(pool_size_) * dirty_high_watermark);
+  background_writer_ = std::thread(&BufferPoolManagerInstance::RunBackgroundWriter, this, interval);
+}
+
+void BufferPoolManagerInstance::StopBackgroundWriter() {
+  {
+    auto lock = LockLatch();
+    if (!background_writer_enabled_) {
+      return;
+    }
+    background_writer_enabled_ = false;
+    background_writer_cv_.notify_one();
+  }
+  background_writer_.join();
+}
+
+void BufferPoolManagerInstance::RunBackgroundWriter(std::chrono::milliseconds interval) {
+  auto lock = LockLatch();
+  while (background_writer_enabled_) {
+    background_writer_cv_.wait_for(lock, interval);
+    // Pinned pages are still in use and likely to be dirtied again, so only unpinned pages are written ahead.
+    std::vector<frame_id_t> batch;
+    for (size_t i = 0; i < pool_size_ && background_writer_enabled_; i++) {
+      auto frame_id = static_cast<frame_id_t>(i);
+      const Page &page = pages_[frame_id];
+      if (page.is_dirty_ && page.pin_count_ == 0 && !frame_io_[frame_id].in_progress_) {
+        BeginWriteBack(frame_id);
+        batch.push_back(frame_id);
+      }
+      if (batch.size() == WRITE_BACK_BATCH_SIZE) {
+        WriteBackFrames(lock, &batch);
+      }
+    }
+    WriteBackFrames(lock, &batch);
+  }
+}
+
+auto BufferPoolManagerInstance::ResizeImp(size_t pool_size) -> bool {
+  BUSTUB_ASSERT(pool_size > 0, "a buffer pool needs at least one frame");
+  std::scoped_lock<std::mutex> resize_lock(resize_latch_);
+  auto lock = LockLatch();
+  const size_t old_pool_size = pool_size_;
+
+  if (pool_size > old_pool_size) {
+    arena_.Reserve(pool_size);
+    RebuildReplacer(pool_size);
+    for (size_t i = old_pool_size; i < pool_size; i++) {
+      pages_.emplace_back(arena_.FrameData(i));
+      frame_io_.emplace_back();
+      free_list_.push_back(static_cast<frame_id_t>(i));
+      // Publish the new frames in chunks, letting fetches in between on a large growth.
+      if ((i + 1) % RESIZE_CHUNK_SIZE == 0 || i + 1 == pool_size) {
+        drain_from_ = pool_size_ = i + 1;
+        lock.unlock();
+        lock.lock();
+      }
+    }
+  } else if (pool_size < old_pool_size) {
+    // The frames to remove take no new pages from now on, but may still get some through the replacer; DrainFrames()
+    // keeps emptying them until none is left.
+    drain_from_ = pool_size;
+    const auto in_tail = [pool_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= pool_size; };
+    free_list_.remove_if(in_tail);
+    if (!DrainFrames(lock, pool_size)) {
+      drain_from_ = old_pool_size;
+      // Hand the frames that were emptied so far back to the free list.
+      free_list_.remove_if(in_tail);
+      for (size_t i = pool_size; i < old_pool_size; i++) {
+        if (pages_[i].page_id_ == INVALID_PAGE_ID) {
+          free_list_.push_back(static_cast<frame_id_t>(i));
+        }
+      }
+      return false;
+    }
+    free_list_.remove_if(in_tail);
+    RebuildReplacer(pool_size);
+    pool_size_ = pool_size;
+    while (pages_.size() > pool_size) {
+      pages_.pop_back();
+      frame_io_.pop_back();
+    }
+    arena_.Release(pool_size);
+  }
+
+  dirty_high_watermark_ = static_cast<size_t>(static_cast<double>(dirty_high_watermark_) *
+                                              static_cast<double>(pool_size) / static_cast<double>(old_pool_size));
+  return true;
+}
+
+auto BufferPoolManagerInstance::DrainFrames(std::unique_lock<std::mutex> &lock, size_t pool_size) -> bool {
+  const auto deadline = std::chrono::steady_clock::now() + buffer_pool_resize_timeout;
+  while (true) {
+    std::vector<frame_id_t> batch;
+    bool busy = false;
+    for (size_t i = pool_size; i < pool_size_; i++) {
+      auto frame_id = static_cast<frame_id_t>(i);
+      Page *page = &pages_[frame_id];
+      if (page->page_id_ == INVALID_PAGE_ID) {
+        continue;
+      }
+      if (page->pin_count_ > 0 || frame_io_[frame_id].in_progress_) {
+        busy = true;
+        continue;
+      }
+      if (page->is_dirty_) {
+        // Evicted in the next pass, unless it gets pinned again meanwhile.
+        BeginWriteBack(frame_id);
+        batch.push_back(frame_id);
+        continue;
+      }
+      replacer_->Remove(frame_id);
+      page_table_->Remove(page->page_id_);
+      page->ResetMemory();
+      page->page_id_ = INVALID_PAGE_ID;
+    }
+    if (!busy && batch.empty()) {
+      return true;
+    }
+    WriteBackFrames(lock, &batch);
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    if (busy) {
+      drain_cv_.wait_until(lock, deadline);
+    }
+  }
+}
+
+void BufferPoolManagerInstance::RebuildReplacer(size_t pool_size) {
+  // Draining the old replacer yields the evictable frames from the coldest to the hottest.
+  std::vector<frame_id_t> victims;
+  frame_id_t frame_id;
+  while (replacer_->Evict(&frame_id)) {
+    victims.push_back(frame_id);
+  }
+
+  auto replacer = Replacer::Create(replacer_type_, pool_size, replacer_k_);
+  const size_t num_frames = std::min<size_t>(pool_size, pool_size_);
+  const auto track = [&](frame_id_t tracked) {
+    replacer->SetPageId(tracked, pages_[tracked].page_id_);
+    replacer->RecordAccess(tracked);
+    replacer->SetEvictable(tracked, pages_[tracked].pin_count_ == 0);
+  };
+  std::vector<bool> is_victim(num_frames, false);
+  for (auto victim : victims) {
+    if (static_cast<size_t>(victim) < num_frames) {
+      is_victim[victim] = true;
+    }
+  }
+  for (size_t i = 0; i < num_frames; i++) {
+    if (!is_victim[i] && pages_[i].page_id_ != INVALID_PAGE_ID) {
+      track(static_cast<frame_id_t>(i));
+    }
+  }
+  for (auto victim : victims) {
+    if (static_cast<size_t>(victim) < num_frames && pages_[victim].page_id_ != INVALID_PAGE_ID) {
+      track(victim);
+    }
+  }
+  replacer_ = std::move(replacer);
+}
+
+auto BufferPoolManagerInstance::AllocatePage() -> page_id_t {
+  const auto stride = static_cast<page_id_t>(num_instances_);
+  // Only the ids below next_page_id_ were handed out by this run, so only those can be reused safely.
+  const page_id_t free_page_id =
+      disk_manager_->AllocateFreePage(next_page_id_, stride, static_cast<page_id_t>(instance_index_));
+  if (free_page_id != INVALID_PAGE_ID) {
+    ValidatePageId(free_page_id);
+    return free_page_id;
+  }
+  const page_id_t next_page_id = next_page_id_.fetch_add(stride);
+  ValidatePageId(next_page_id);
+  disk_manager_->MarkPageAllocated(next_page_id);
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  // allocated pages mod back to this BPI
+  BUSTUB_ASSERT(page_id % num_instances_ == instance_index_, "page id is routed to the wrong BPI");
+}
 
 }  // namespace bustub
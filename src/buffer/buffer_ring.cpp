@@ -0,0 +1,35 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring.cpp
+//
+// Identification: src/buffer/buffer_ring.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_ring.h"
+
+namespace bustub {
+
+BufferRing::BufferRing(BufferPoolManager *bpm, RingType ring_type)
+    : BufferRing(bpm, ring_type == RingType::BULK_READ ? BULK_READ_RING_SIZE : BULK_WRITE_RING_SIZE) {}
+
+BufferRing::BufferRing(BufferPoolManager *bpm, size_t ring_size) : bpm_(bpm), slots_(ring_size) {
+  BUSTUB_ASSERT(ring_size > 0, "a buffer ring needs at least one frame");
+}
+
+auto BufferRing::FetchPage(page_id_t page_id) -> Page * { return bpm_->FetchPgInRingImp(page_id, this); }
+
+auto BufferRing::NewPage(page_id_t *page_id) -> Page * { return bpm_->NewPgInRingImp(page_id, this); }
+
+void BufferRing::PrefetchPage(page_id_t page_id) { bpm_->PrefetchPgImp(page_id, this); }
+
+void BufferRing::Advance(const BufferPoolManager *owner, frame_id_t frame_id, page_id_t page_id) {
+  slots_[next_slot_] = Slot{owner, frame_id, page_id};
+  next_slot_ = (next_slot_ + 1) % slots_.size();
+}
+
+}  // namespace bustub
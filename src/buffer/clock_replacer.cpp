@@ -14,16 +14,77 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : replacer_size_(num_pages), entries_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+  if (curr_size_ == 0) {
+    return false;
+  }
+  // The first sweep clears every reference bit it passes, so the second sweep is guaranteed to find a victim.
+  for (size_t i = 0; i <= 2 * replacer_size_; i++) {
+    auto &entry = entries_[hand_];
+    const auto current = static_cast<frame_id_t>(hand_);
+    hand_ = (hand_ + 1) % replacer_size_;
+    if (!entry.tracked_ || !entry.evictable_) {
+      continue;
+    }
+    if (entry.referenced_) {
+      entry.referenced_ = false;
+      continue;
+    }
+    entry = ClockEntry{};
+    curr_size_--;
+    *frame_id = current;
+    return true;
+  }
+  UNREACHABLE("clock sweep found no victim although the replacer is not empty");
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+  entries_[frame_id].tracked_ = true;
+  entries_[frame_id].referenced_ = true;
+}
+
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+
+  auto &entry = entries_[frame_id];
+  if (!entry.tracked_ || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+    return;
+  }
+  auto &entry = entries_[frame_id];
+  if (!entry.tracked_ || !entry.evictable_) {
+    return;
+  }
+  entry = ClockEntry{};
+  curr_size_--;
+}
+
+auto ClockReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
 
 }  // namespace bustub
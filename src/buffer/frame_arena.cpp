@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+
+#include <cstdint>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+static_assert(HUGE_PAGE_SIZE % BUSTUB_PAGE_SIZE == 0, "a huge page must hold whole frames");
+
+FrameArena::FrameArena(bool use_huge_pages) : use_huge_pages_(use_huge_pages) {}
+
+FrameArena::~FrameArena() {
+  for (const auto &chunk : chunks_) {
+    munmap(chunk.data_, chunk.bytes_);
+  }
+}
+
+void FrameArena::Reserve(size_t num_frames) {
+  if (num_frames > capacity_) {
+    MapChunk(num_frames - capacity_);
+  }
+}
+
+void FrameArena::Release(size_t num_frames) {
+  while (!chunks_.empty() && chunks_.back().first_frame_ >= num_frames) {
+    munmap(chunks_.back().data_, chunks_.back().bytes_);
+    capacity_ = chunks_.back().first_frame_;
+    chunks_.pop_back();
+  }
+  if (chunks_.empty() || capacity_ <= num_frames) {
+    return;
+  }
+  // The last chunk is only partly released: keep it mapped, but drop its pages. Explicit huge pages can only be
+  // dropped whole, so they stay.
+  const auto &chunk = chunks_.back();
+  if (!chunk.huge_tlb_) {
+    const size_t offset = (num_frames - chunk.first_frame_) * BUSTUB_PAGE_SIZE;
+    madvise(chunk.data_ + offset, chunk.bytes_ - offset, MADV_DONTNEED);
+  }
+}
+
+auto FrameArena::FrameData(size_t frame) -> char * {
+  BUSTUB_ASSERT(frame < capacity_, "frame out of range");
+  // There are only a few chunks: one per growth of the buffer pool.
+  for (const auto &chunk : chunks_) {
+    if (frame < chunk.first_frame_ + chunk.num_frames_) {
+      return chunk.data_ + (frame - chunk.first_frame_) * BUSTUB_PAGE_SIZE;
+    }
+  }
+  UNREACHABLE("frame out of range");
+}
+
+auto FrameArena::GetMappedBytes() const -> size_t {
+  size_t bytes = 0;
+  for (const auto &chunk : chunks_) {
+    bytes += chunk.bytes_;
+  }
+  return bytes;
+}
+
+auto FrameArena::GetHugeTlbBytes() const -> size_t {
+  size_t bytes = 0;
+  for (const auto &chunk : chunks_) {
+    bytes += chunk.huge_tlb_ ? chunk.bytes_ : 0;
+  }
+  return bytes;
+}
+
+/**
+ * Map a chunk of frames.
+ */
+void FrameArena::MapChunk(size_t num_frames) {
+  size_t bytes = num_frames * BUSTUB_PAGE_SIZE;
+  const bool huge = use_huge_pages_ && bytes >= HUGE_PAGE_SIZE;
+  if (huge) {
+    bytes = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  }
+
+  void *data = MAP_FAILED;
+  bool huge_tlb = false;
+#ifdef MAP_HUGETLB
+  if (huge) {
+    data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    huge_tlb = data != MAP_FAILED;
+  }
+#endif
+  if (data == MAP_FAILED && huge) {
+    // No huge pages reserved: map a huge page more than needed, and trim it to a huge page boundary, so that the
+    // kernel can back the chunk by transparent huge pages.
+    void *raw = mmap(nullptr, bytes + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw != MAP_FAILED) {
+      const auto start = reinterpret_cast<uintptr_t>(raw);
+      const auto aligned = (start + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+      if (aligned > start) {
+        munmap(raw, aligned - start);
+      }
+      munmap(reinterpret_cast<char *>(aligned) + bytes, start + HUGE_PAGE_SIZE - aligned);
+      data = reinterpret_cast<void *>(aligned);
+#ifdef MADV_HUGEPAGE
+      madvise(data, bytes, MADV_HUGEPAGE);
+#endif
+    }
+  } else if (data == MAP_FAILED) {
+    data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  if (data == MAP_FAILED) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot map the frames of the buffer pool");
+  }
+  LOG_DEBUG("mapped %zu frames%s", bytes / BUSTUB_PAGE_SIZE, huge_tlb ? " on huge pages" : "");
+
+  chunks_.push_back({static_cast<char *>(data), capacity_, bytes / BUSTUB_PAGE_SIZE, bytes, huge_tlb});
+  capacity_ += bytes / BUSTUB_PAGE_SIZE;
+}
+
+}  // namespace bustub
@@ -11,117 +11,89 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/lru_k_replacer.h"
-#include <algorithm>
+
 #include "common/exception.h"
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_(num_frames), k_(k), entries_(num_frames), history_(num_frames * k) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+}
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
   std::scoped_lock<std::mutex> lock(latch_);
 
-  for (auto it = less_than_k_frames_.begin(); it != less_than_k_frames_.end(); ++it) {
-    auto entry = lru_entry_hash_[*it];
-    if (entry.evictable_) {
-      *frame_id = *it;
-      //      std::cout << "LRUKReplacer::Evict frame id: " << *frame_id << std::endl;
-
-      lru_entry_hash_.erase(*it);
-      frame_iterator_map_.erase(*it);
-      less_than_k_frames_.erase(it);
-
-      curr_size_--;
-      //      PrintDebug();
-      return true;
-    }
+  if (evictable_frames_.empty()) {
+    return false;
   }
 
-  std::sort(more_than_k_frames_.begin(), more_than_k_frames_.end(),
-            [&](frame_id_t a, frame_id_t b) { return GetLastKAccessTime(a) < GetLastKAccessTime(b); });
-
-  for (auto it = more_than_k_frames_.begin(); it != more_than_k_frames_.end(); ++it) {
-    auto entry = lru_entry_hash_[*it];
-    if (entry.evictable_) {
-      *frame_id = *it;
-      //      std::cout << "LRUKReplacer::Evict frame id: " << *frame_id << std::endl;
-
-      lru_entry_hash_.erase(*it);
-      more_than_k_frames_.erase(it);
-
-      curr_size_--;
-      //      PrintDebug();
-      return true;
-    }
-  }
-
-  return false;
+  *frame_id = std::get<2>(*evictable_frames_.begin());
+  evictable_frames_.erase(evictable_frames_.begin());
+  ResetEntry(*frame_id);
+  return true;
 }
 
 void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
   std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
 
-  //  std::cout << "[LRUKReplacer::RecordAccess] "
-  //            << "frame id: " << frame_id << std::endl;
-  current_timestamp_++;
+  auto &entry = entries_[frame_id];
+  if (entry.evictable_) {
+    evictable_frames_.erase(GetEvictionKey(frame_id));
+  }
 
-  LruEntry entry;
-  if (lru_entry_hash_.find(frame_id) != lru_entry_hash_.end()) {
-    entry = lru_entry_hash_[frame_id];
+  auto *ring = &history_[frame_id * k_];
+  if (entry.access_count_ < k_) {
+    // The ring is not full yet, head_ stays on the first access.
+    ring[entry.access_count_++] = current_timestamp_;
   } else {
-    entry = LruEntry{};
-    less_than_k_frames_.push_back(frame_id);
-    frame_iterator_map_[frame_id] = std::prev(less_than_k_frames_.end());
+    // Overwrite the oldest timestamp, the next oldest becomes the k-th most recent access.
+    ring[entry.head_] = current_timestamp_;
+    entry.head_ = (entry.head_ + 1) % k_;
   }
+  current_timestamp_++;
 
-  entry.access_count_++;
-  hist_[std::make_pair(frame_id, entry.access_count_)] = current_timestamp_;
-
-  if (entry.access_count_ == k_) {
-    less_than_k_frames_.erase(frame_iterator_map_[frame_id]);
-    frame_iterator_map_.erase(frame_id);
-    more_than_k_frames_.push_back(frame_id);
+  if (entry.evictable_) {
+    evictable_frames_.insert(GetEvictionKey(frame_id));
   }
-
-  lru_entry_hash_[frame_id] = entry;
-  //  PrintDebug();
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
   std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
 
-  if (lru_entry_hash_.find(frame_id) == lru_entry_hash_.end()) {
+  auto &entry = entries_[frame_id];
+  if (entry.access_count_ == 0 || entry.evictable_ == set_evictable) {
     return;
   }
-  if (!lru_entry_hash_[frame_id].evictable_ && set_evictable) {
-    curr_size_++;
-    lru_entry_hash_[frame_id].evictable_ = true;
-  }
-  if (lru_entry_hash_[frame_id].evictable_ && !set_evictable) {
-    curr_size_--;
-    lru_entry_hash_[frame_id].evictable_ = false;
+
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    evictable_frames_.insert(GetEvictionKey(frame_id));
+  } else {
+    evictable_frames_.erase(GetEvictionKey(frame_id));
   }
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
   std::scoped_lock<std::mutex> lock(latch_);
 
-  if (lru_entry_hash_.find(frame_id) == lru_entry_hash_.end() || !lru_entry_hash_[frame_id].evictable_) {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
     return;
   }
-
-  if (frame_iterator_map_.find(frame_id) != frame_iterator_map_.end()) {
-    less_than_k_frames_.erase(frame_iterator_map_[frame_id]);
-  } else {
-    auto remove_it = std::remove(more_than_k_frames_.begin(), more_than_k_frames_.end(), frame_id);
-    more_than_k_frames_.erase(remove_it, more_than_k_frames_.end());
+  const auto &entry = entries_[frame_id];
+  if (entry.access_count_ == 0 || !entry.evictable_) {
+    return;
   }
 
-  lru_entry_hash_.erase(frame_id);
-  curr_size_--;
-  replacer_size_--;
+  evictable_frames_.erase(GetEvictionKey(frame_id));
+  ResetEntry(frame_id);
 }
 
-auto LRUKReplacer::Size() -> size_t { return curr_size_; }
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return evictable_frames_.size();
+}
 
 }  // namespace bustub
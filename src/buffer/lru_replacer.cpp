@@ -14,16 +14,68 @@
 
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages) : replacer_size_(num_pages), entries_(num_pages) {}
 
 LRUReplacer::~LRUReplacer() = default;
 
-auto LRUReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto LRUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
 
-void LRUReplacer::Pin(frame_id_t frame_id) {}
+  if (evictable_frames_.empty()) {
+    return false;
+  }
+  *frame_id = evictable_frames_.begin()->second;
+  evictable_frames_.erase(evictable_frames_.begin());
+  entries_[*frame_id] = LruEntry{};
+  return true;
+}
 
-void LRUReplacer::Unpin(frame_id_t frame_id) {}
+void LRUReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
 
-auto LRUReplacer::Size() -> size_t { return 0; }
+  auto &entry = entries_[frame_id];
+  if (entry.evictable_) {
+    evictable_frames_.erase({entry.last_access_, frame_id});
+    evictable_frames_.emplace(current_timestamp_, frame_id);
+  }
+  entry.tracked_ = true;
+  entry.last_access_ = current_timestamp_++;
+}
+
+void LRUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+
+  auto &entry = entries_[frame_id];
+  if (!entry.tracked_ || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    evictable_frames_.emplace(entry.last_access_, frame_id);
+  } else {
+    evictable_frames_.erase({entry.last_access_, frame_id});
+  }
+}
+
+void LRUReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+    return;
+  }
+  auto &entry = entries_[frame_id];
+  if (!entry.tracked_ || !entry.evictable_) {
+    return;
+  }
+  evictable_frames_.erase({entry.last_access_, frame_id});
+  entry = LruEntry{};
+}
+
+auto LRUReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return evictable_frames_.size();
+}
 
 }  // namespace bustub
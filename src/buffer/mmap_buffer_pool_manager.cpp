@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mmap_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/mmap_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/mmap_buffer_pool_manager.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+MmapBufferPoolManager::MmapBufferPoolManager(const std::string &db_file) {
+  fd_ = open(db_file.c_str(), O_RDONLY);  // NOLINT
+  if (fd_ < 0) {
+    LOG_DEBUG("can't open %s: %s", db_file.c_str(), strerror(errno));
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) != 0) {
+    close(fd_);
+    throw Exception("can't stat db file");
+  }
+  num_pages_ = static_cast<size_t>(stat_buf.st_size) / BUSTUB_PAGE_SIZE;
+  if (num_pages_ > 0) {
+    void *data = mmap(nullptr, num_pages_ * BUSTUB_PAGE_SIZE, PROT_READ, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      LOG_DEBUG("can't map %s: %s", db_file.c_str(), strerror(errno));
+      close(fd_);
+      throw Exception("can't map db file");
+    }
+    data_ = static_cast<char *>(data);
+  }
+  pages_ = std::make_unique<std::atomic<Page *>[]>(num_pages_);
+  LOG_DEBUG("mapped %zu pages of %s read-only", num_pages_, db_file.c_str());
+}
+
+MmapBufferPoolManager::~MmapBufferPoolManager() {
+  for (size_t i = 0; i < num_pages_; i++) {
+    delete pages_[i].load(std::memory_order_relaxed);
+  }
+  if (data_ != nullptr) {
+    munmap(data_, num_pages_ * BUSTUB_PAGE_SIZE);
+  }
+  close(fd_);
+}
+
+auto MmapBufferPoolManager::GetStats() -> BufferPoolStats {
+  BufferPoolStats stats;
+  stats.pool_size_ = num_pages_;
+  stats.hits_ = hits_.Get();
+  return stats;
+}
+
+auto MmapBufferPoolManager::FetchPgImp(page_id_t page_id) -> Page * {
+  if (page_id < 0 || static_cast<size_t>(page_id) >= num_pages_) {
+    return nullptr;
+  }
+  hits_.Add();
+  Page *page = pages_[page_id].load(std::memory_order_acquire);
+  if (page != nullptr) {
+    return page;
+  }
+  // First fetch of the page: attach a page object to the mapping. If another thread races us, keep its object.
+  auto *created = new Page(data_ + static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE);
+  created->page_id_ = page_id;
+  if (pages_[page_id].compare_exchange_strong(page, created, std::memory_order_acq_rel)) {
+    return created;
+  }
+  delete created;
+  return page;
+}
+
+auto MmapBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  return page_id >= 0 && static_cast<size_t>(page_id) < num_pages_;
+}
+
+auto MmapBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  return page_id >= 0 && static_cast<size_t>(page_id) < num_pages_;
+}
+
+auto MmapBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * { return nullptr; }
+
+auto MmapBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool { return false; }
+
+void MmapBufferPoolManager::PrefetchPgImp(page_id_t page_id, BufferRing *ring) {
+  if (page_id >= 0 && static_cast<size_t>(page_id) < num_pages_) {
+    madvise(data_ + static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE, MADV_WILLNEED);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+#include <utility>
+
+namespace bustub {
+
+PageTable::PageTable(size_t expected_size) : stripes_(std::make_unique<Stripe[]>(NUM_STRIPES)) {
+  // Keep every stripe at most half full when the entries spread evenly.
+  size_t capacity = MIN_STRIPE_CAPACITY;
+  while (capacity < 2 * expected_size / NUM_STRIPES) {
+    capacity *= 2;
+  }
+  for (size_t i = 0; i < NUM_STRIPES; i++) {
+    stripes_[i].slots_.resize(capacity);
+  }
+}
+
+auto PageTable::Find(page_id_t page_id, frame_id_t &frame_id) -> bool {
+  const uint64_t hash = Hash(page_id);
+  Stripe &stripe = GetStripe(hash);
+  std::scoped_lock<std::mutex> lock(stripe.latch_);
+  const Slot &slot = stripe.slots_[Probe(stripe, page_id, hash)];
+  if (slot.page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  frame_id = slot.frame_id_;
+  return true;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot map the invalid page id");
+  const uint64_t hash = Hash(page_id);
+  Stripe &stripe = GetStripe(hash);
+  std::scoped_lock<std::mutex> lock(stripe.latch_);
+  Slot *slot = &stripe.slots_[Probe(stripe, page_id, hash)];
+  if (slot->page_id_ == INVALID_PAGE_ID) {
+    if (2 * (stripe.size_ + 1) > stripe.slots_.size()) {
+      Grow(stripe);
+      slot = &stripe.slots_[Probe(stripe, page_id, hash)];
+    }
+    slot->page_id_ = page_id;
+    stripe.size_++;
+  }
+  slot->frame_id_ = frame_id;
+}
+
+auto PageTable::Remove(page_id_t page_id) -> bool {
+  const uint64_t hash = Hash(page_id);
+  Stripe &stripe = GetStripe(hash);
+  std::scoped_lock<std::mutex> lock(stripe.latch_);
+  auto &slots = stripe.slots_;
+  const size_t mask = slots.size() - 1;
+  size_t hole = Probe(stripe, page_id, hash);
+  if (slots[hole].page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+
+  // Backward shift deletion: move later entries of the probe sequence into the hole, so that lookups never need
+  // tombstones to get past it.
+  for (size_t i = (hole + 1) & mask; slots[i].page_id_ != INVALID_PAGE_ID; i = (i + 1) & mask) {
+    const size_t home = Hash(slots[i].page_id_) & mask;
+    // The entry may move to the hole only if the hole lies on its probe path, i.e. between home and i (cyclically).
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      slots[hole] = slots[i];
+      hole = i;
+    }
+  }
+  slots[hole] = Slot{};
+  stripe.size_--;
+  return true;
+}
+
+auto PageTable::Size() -> size_t {
+  size_t size = 0;
+  for (size_t i = 0; i < NUM_STRIPES; i++) {
+    std::scoped_lock<std::mutex> lock(stripes_[i].latch_);
+    size += stripes_[i].size_;
+  }
+  return size;
+}
+
+auto PageTable::Hash(page_id_t page_id) -> uint64_t {
+  // Fibonacci hashing spreads the mostly consecutive page ids over all stripes and slots.
+  return static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL;
+}
+
+auto PageTable::Probe(Stripe &stripe, page_id_t page_id, uint64_t hash) -> size_t {
+  const size_t mask = stripe.slots_.size() - 1;
+  size_t i = hash & mask;
+  while (stripe.slots_[i].page_id_ != page_id && stripe.slots_[i].page_id_ != INVALID_PAGE_ID) {
+    i = (i + 1) & mask;
+  }
+  return i;
+}
+
+void PageTable::Grow(Stripe &stripe) {
+  std::vector<Slot> old_slots(stripe.slots_.size() * 2);
+  std::swap(old_slots, stripe.slots_);
+  for (const auto &slot : old_slots) {
+    if (slot.page_id_ != INVALID_PAGE_ID) {
+      stripe.slots_[Probe(stripe, slot.page_id_, Hash(slot.page_id_))] = slot;
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     size_t replacer_k, LogManager *log_manager,
+                                                     ReplacerType replacer_type) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel BPM needs at least one instance");
+  // Allocate and create individual BufferPoolManagerInstances
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, replacer_k,
+        log_manager, replacer_type));
+  }
+}
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t {
+  size_t pool_size = 0;
+  for (auto &instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+auto ParallelBufferPoolManager::GetStats() -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (auto &instance : instances_) {
+    stats += instance->GetStats();
+  }
+  return stats;
+}
+
+void ParallelBufferPoolManager::StartBackgroundWriter(std::chrono::milliseconds interval,
+                                                      double dirty_high_watermark) {
+  for (auto &instance : instances_) {
+    instance->StartBackgroundWriter(interval, dirty_high_watermark);
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  for (auto &instance : instances_) {
+    instance->StopBackgroundWriter();
+  }
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
+  // Get BufferPoolManager responsible for handling given page id.
+  if (page_id < 0) {
+    return nullptr;
+  }
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) -> Page * {
+  auto *instance = GetBufferPoolManager(page_id);
+  return instance == nullptr ? nullptr : instance->FetchPage(page_id);
+}
+
+auto ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  auto *instance = GetBufferPoolManager(page_id);
+  return instance != nullptr && instance->UnpinPage(page_id, is_dirty);
+}
+
+auto ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  auto *instance = GetBufferPoolManager(page_id);
+  return instance != nullptr && instance->FlushPage(page_id);
+}
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * { return NewPgInRingImp(page_id, nullptr); }
+
+auto ParallelBufferPoolManager::NewPgInRingImp(page_id_t *page_id, BufferRing *ring) -> Page * {
+  // Probe every instance at most once, starting from a rotating index so that allocations spread evenly over the
+  // shards. The starting index moves forward on every call, regardless of which instance succeeds.
+  const size_t num_instances = instances_.size();
+  const size_t start = next_instance_.fetch_add(1) % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    auto *page = instances_[(start + i) % num_instances]->NewPgInRingImp(page_id, ring);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
+  auto *instance = GetBufferPoolManager(page_id);
+  return instance != nullptr && instance->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  for (auto &instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+auto ParallelBufferPoolManager::FetchPgInRingImp(page_id_t page_id, BufferRing *ring) -> Page * {
+  auto *instance = GetBufferPoolManager(page_id);
+  return instance == nullptr ? nullptr : instance->FetchPgInRingImp(page_id, ring);
+}
+
+void ParallelBufferPoolManager::PrefetchPgImp(page_id_t page_id, BufferRing *ring) {
+  if (auto *instance = GetBufferPoolManager(page_id); instance != nullptr) {
+    instance->PrefetchPgImp(page_id, ring);
+  }
+}
+
+auto ParallelBufferPoolManager::FetchPgAsyncImp(page_id_t page_id) -> std::future<Page *> {
+  auto *instance = GetBufferPoolManager(page_id);
+  if (instance == nullptr) {
+    std::promise<Page *> promise;
+    promise.set_value(nullptr);
+    return promise.get_future();
+  }
+  return instance->FetchPgAsyncImp(page_id);
+}
+
+auto ParallelBufferPoolManager::ResizeImp(size_t pool_size) -> bool {
+  const size_t num_instances = instances_.size();
+  if (pool_size < num_instances) {
+    return false;
+  }
+  std::vector<size_t> old_pool_sizes;
+  old_pool_sizes.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    old_pool_sizes.push_back(instances_[i]->GetPoolSize());
+    // The first pool_size % num_instances instances take one frame more.
+    const size_t instance_pool_size = pool_size / num_instances + (i < pool_size % num_instances ? 1 : 0);
+    if (!instances_[i]->Resize(instance_pool_size)) {
+      // Only a shrink fails, so the instances resized before it shrank too, and growing them back cannot fail.
+      for (size_t j = 0; j < i; j++) {
+        instances_[j]->Resize(old_pool_sizes[j]);
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
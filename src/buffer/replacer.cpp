@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer.cpp
+//
+// Identification: src/buffer/replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/exception.h"
+#include "common/util/string_util.h"
+
+namespace bustub {
+
+auto Replacer::Create(ReplacerType replacer_type, size_t num_frames, size_t k) -> std::unique_ptr<Replacer> {
+  switch (replacer_type) {
+    case ReplacerType::LRU:
+      return std::make_unique<LRUReplacer>(num_frames);
+    case ReplacerType::CLOCK:
+      return std::make_unique<ClockReplacer>(num_frames);
+    case ReplacerType::LRU_K:
+      return std::make_unique<LRUKReplacer>(num_frames, k);
+    case ReplacerType::ARC:
+      return std::make_unique<ARCReplacer>(num_frames);
+    case ReplacerType::TWO_QUEUE:
+      return std::make_unique<TwoQueueReplacer>(num_frames);
+  }
+  UNREACHABLE("unknown replacer type");
+}
+
+auto Replacer::ParseReplacerType(const std::string &name) -> ReplacerType {
+  auto lower = StringUtil::Lower(name);
+  if (lower == "lru") {
+    return ReplacerType::LRU;
+  }
+  if (lower == "clock") {
+    return ReplacerType::CLOCK;
+  }
+  if (lower == "lru-k" || lower == "lru_k" || lower == "lruk") {
+    return ReplacerType::LRU_K;
+  }
+  if (lower == "arc") {
+    return ReplacerType::ARC;
+  }
+  if (lower == "2q" || lower == "two_queue") {
+    return ReplacerType::TWO_QUEUE;
+  }
+  throw Exception(ExceptionType::INVALID, "unknown replacement policy: " + name);
+}
+
+auto Replacer::ReplacerTypeToString(ReplacerType replacer_type) -> std::string {
+  switch (replacer_type) {
+    case ReplacerType::LRU:
+      return "lru";
+    case ReplacerType::CLOCK:
+      return "clock";
+    case ReplacerType::LRU_K:
+      return "lru-k";
+    case ReplacerType::ARC:
+      return "arc";
+    case ReplacerType::TWO_QUEUE:
+      return "2q";
+  }
+  UNREACHABLE("unknown replacer type");
+}
+
+}  // namespace bustub
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace bustub {
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : replacer_size_(num_frames),
+      kin_(std::max<size_t>(num_frames / 4, 1)),
+      kout_(std::max<size_t>(num_frames / 2, 1)),
+      entries_(num_frames) {}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  if (curr_size_ == 0) {
+    return false;
+  }
+  if (a1in_.size() > kin_ || am_.empty()) {
+    return EvictFrom(&a1in_, frame_id) || EvictFrom(&am_, frame_id);
+  }
+  return EvictFrom(&am_, frame_id) || EvictFrom(&a1in_, frame_id);
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+
+  auto &entry = entries_[frame_id];
+  if (entry.queue_ == QueueType::AM) {
+    am_.splice(am_.begin(), am_, entry.pos_);
+    return;
+  }
+  if (entry.queue_ == QueueType::A1IN) {
+    // Correlated references while the page sits in A1in do not count as reuse.
+    return;
+  }
+
+  auto ghost = entry.page_id_ == INVALID_PAGE_ID ? a1out_pos_.end() : a1out_pos_.find(entry.page_id_);
+  if (ghost != a1out_pos_.end()) {
+    a1out_.erase(ghost->second);
+    a1out_pos_.erase(ghost);
+    am_.push_front(frame_id);
+    entry.queue_ = QueueType::AM;
+    entry.pos_ = am_.begin();
+  } else {
+    a1in_.push_front(frame_id);
+    entry.queue_ = QueueType::A1IN;
+    entry.pos_ = a1in_.begin();
+  }
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+
+  auto &entry = entries_[frame_id];
+  if (entry.queue_ == QueueType::NONE || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+    return;
+  }
+  auto &entry = entries_[frame_id];
+  if (entry.queue_ == QueueType::NONE || !entry.evictable_) {
+    return;
+  }
+  (entry.queue_ == QueueType::A1IN ? a1in_ : am_).erase(entry.pos_);
+  entry = TwoQueueEntry{};
+  curr_size_--;
+}
+
+auto TwoQueueReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+void TwoQueueReplacer::SetPageId(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  entries_[frame_id].page_id_ = page_id;
+}
+
+auto TwoQueueReplacer::EvictFrom(std::list<frame_id_t> *queue, frame_id_t *frame_id) -> bool {
+  for (auto it = queue->rbegin(); it != queue->rend(); ++it) {
+    auto &entry = entries_[*it];
+    if (!entry.evictable_) {
+      continue;
+    }
+    *frame_id = *it;
+    queue->erase(std::next(it).base());
+    // Only pages leaving A1in are remembered; pages leaving Am have had their chance.
+    if (queue == &a1in_ && entry.page_id_ != INVALID_PAGE_ID) {
+      a1out_.push_front(entry.page_id_);
+      a1out_pos_[entry.page_id_] = a1out_.begin();
+      if (a1out_.size() > kout_) {
+        a1out_pos_.erase(a1out_.back());
+        a1out_.pop_back();
+      }
+    }
+    entry = TwoQueueEntry{};
+    curr_size_--;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace bustub
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -12,6 +15,7 @@
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/mmap_buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
 #include "common/bustub_instance.h"
@@ -32,20 +36,61 @@
 #include "recovery/checkpoint_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_compressed.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_uring.h"
+#include "storage/page/header_page.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
+namespace {
+
+/** `SHOW BUFFER POOL STATS` is not SQL the parser knows, so it is recognized before parsing. */
+auto IsShowBufferPoolStats(const std::string &sql) -> bool {
+  std::string normalized = StringUtil::Lower(StringUtil::Strip(sql, ';'));
+  std::replace_if(normalized.begin(), normalized.end(), [](char c) { return std::isspace(c) != 0; }, ' ');
+  return StringUtil::Join(StringUtil::Split(normalized, " "), " ") == "show buffer pool stats";
+}
+
+/** @return true if a statement of this type writes to the database, i.e. it cannot run in a read-only instance */
+auto IsWriteStatement(StatementType type) -> bool {
+  switch (type) {
+    case StatementType::INSERT_STATEMENT:
+    case StatementType::UPDATE_STATEMENT:
+    case StatementType::DELETE_STATEMENT:
+    case StatementType::CREATE_STATEMENT:
+    case StatementType::DROP_STATEMENT:
+    case StatementType::INDEX_STATEMENT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+BustubInstance::BustubInstance(const std::string &db_file_name, const BustubInstanceOptions &options)
+    : read_only_(options.read_only_) {
+  if (read_only_ && (options.compress_pages_ || options.use_io_uring_)) {
+    throw Exception("a read-only instance maps the database file as is, it cannot use compressed pages or io_uring");
+  }
   enable_logging = false;
 
-  // Storage related.
-  disk_manager_ = new DiskManager(db_file_name);
+  // Storage related. A read-only instance never writes, not even a log or a free page map next to the database file.
+  if (read_only_) {
+    disk_manager_ = new DiskManagerUnlimitedMemory();
+  } else if (options.compress_pages_) {
+    disk_manager_ = new DiskManagerCompressed(db_file_name);
+  } else if (options.use_io_uring_) {
+    disk_manager_ = new DiskManagerUring(db_file_name);
+  } else {
+    disk_manager_ = new DiskManager(db_file_name);
+  }
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
@@ -53,12 +98,29 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    if (read_only_) {
+      buffer_pool_manager_ = new MmapBufferPoolManager(db_file_name);
+    } else {
+      auto *bpm = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+      // Keep the eviction victims clean, so that queries do not wait for page writes.
+      bpm->StartBackgroundWriter();
+      buffer_pool_manager_ = bpm;
+    }
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
   }
 
+  // A database created with another page size is rejected right away, before any of its pages is misread.
+  try {
+    CheckPageSize();
+  } catch (Exception &e) {
+    delete buffer_pool_manager_;
+    delete log_manager_;
+    delete disk_manager_;
+    throw;
+  }
+
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
   txn_manager_ = new TransactionManager(lock_manager_, log_manager_);
@@ -73,6 +135,25 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
+void BustubInstance::CheckPageSize() {
+  HeaderPage header_page;
+  if (read_only_) {
+    // The disk manager of a read-only instance is not backed by the database file, only the mapping is.
+    if (buffer_pool_manager_ == nullptr) {
+      return;
+    }
+    Page *page = buffer_pool_manager_->FetchPage(HEADER_PAGE_ID);
+    if (page == nullptr) {
+      return;
+    }
+    memcpy(header_page.GetData(), page->GetData(), BUSTUB_PAGE_SIZE);
+    buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, false);
+  } else {
+    disk_manager_->ReadPage(HEADER_PAGE_ID, header_page.GetData());
+  }
+  header_page.ValidatePageSize();
+}
+
 BustubInstance::BustubInstance() {
   enable_logging = false;
 
@@ -105,6 +186,31 @@ BustubInstance::BustubInstance() {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
+void BustubInstance::ResizeBufferPool(const std::string &value) {
+  if (buffer_pool_manager_ == nullptr) {
+    throw Exception("there is no buffer pool to resize");
+  }
+  if (read_only_) {
+    throw Exception("the buffer pool of a read-only instance maps the whole database file, it cannot be resized");
+  }
+  size_t pool_size = 0;
+  try {
+    size_t end;
+    pool_size = std::stoul(value, &end);
+    if (end != value.size()) {
+      pool_size = 0;
+    }
+  } catch (std::logic_error &e) {
+    pool_size = 0;
+  }
+  if (pool_size == 0) {
+    throw Exception(fmt::format("invalid buffer pool size: {}", value));
+  }
+  if (!buffer_pool_manager_->Resize(pool_size)) {
+    throw Exception(fmt::format("cannot resize the buffer pool to {} frames, pages are still pinned", pool_size));
+  }
+}
+
 void BustubInstance::CmdDisplayTables(ResultWriter &writer) {
   auto table_names = catalog_->GetTableNames();
   writer.BeginTable(false);
@@ -146,6 +252,36 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.EndTable();
 }
 
+void BustubInstance::CmdDisplayBufferPoolStats(ResultWriter &writer) {
+  const auto stats = buffer_pool_manager_->GetStats();
+  const auto disk_stats = disk_manager_->GetStats();
+  const std::vector<std::pair<std::string, std::string>> rows{
+      {"pool_size", fmt::format("{}", stats.pool_size_)},
+      {"hits", fmt::format("{}", stats.hits_)},
+      {"misses", fmt::format("{}", stats.misses_)},
+      {"hit_ratio", fmt::format("{:.4f}", stats.HitRatio())},
+      {"evictions", fmt::format("{}", stats.evictions_)},
+      {"dirty_write_backs", fmt::format("{}", stats.dirty_write_backs_)},
+      {"pin_waits", fmt::format("{}", stats.pin_waits_)},
+      {"latch_waits", fmt::format("{}", stats.latch_waits_)},
+      {"latch_wait_ms", fmt::format("{:.3f}", static_cast<double>(stats.latch_wait_ns_) / 1e6)},
+      {"disk_reads", disk_stats.reads_.ToString()},
+      {"disk_writes", disk_stats.writes_.ToString()},
+  };
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("name");
+  writer.WriteHeaderCell("value");
+  writer.EndHeader();
+  for (const auto &[name, value] : rows) {
+    writer.BeginRow();
+    writer.WriteCell(name);
+    writer.WriteCell(value);
+    writer.EndRow();
+  }
+  writer.EndTable();
+}
+
 void BustubInstance::WriteOneCell(const std::string &cell, ResultWriter &writer) {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -160,6 +296,7 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 \dt: show all tables
 \di: show all indices
 \help: show this message again
+SHOW BUFFER POOL STATS: show the buffer pool and disk I/O statistics
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
 up a doc describing the current status later. It will silently ignore some parts
@@ -197,6 +334,10 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
     }
     throw Exception(fmt::format("unsupported internal command: {}", sql));
   }
+  if (IsShowBufferPoolStats(sql)) {
+    CmdDisplayBufferPoolStats(writer);
+    return true;
+  }
 
   bool is_successful = true;
 
@@ -207,6 +348,9 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
 
   for (auto *stmt : binder.statement_nodes_) {
     auto statement = binder.BindStatement(stmt);
+    if (read_only_ && IsWriteStatement(statement->type_)) {
+      throw Exception(fmt::format("the database is open read-only, cannot execute a {} statement", statement->type_));
+    }
     switch (statement->type_) {
       case StatementType::CREATE_STATEMENT: {
         const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
@@ -251,12 +395,18 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       }
       case StatementType::VARIABLE_SHOW_STATEMENT: {
         const auto &show_stmt = dynamic_cast<const VariableShowStatement &>(*statement);
-        auto content = GetSessionVariable(show_stmt.variable_);
+        auto content = show_stmt.variable_ == "buffer_pool_size" && buffer_pool_manager_ != nullptr
+                           ? std::to_string(buffer_pool_manager_->GetPoolSize())
+                           : GetSessionVariable(show_stmt.variable_);
         WriteOneCell(fmt::format("{}={}", show_stmt.variable_, content), writer);
         continue;
       }
       case StatementType::VARIABLE_SET_STATEMENT: {
         const auto &set_stmt = dynamic_cast<const VariableSetStatement &>(*statement);
+        if (set_stmt.variable_ == "buffer_pool_size") {
+          ResizeBufferPool(set_stmt.value_);
+          continue;
+        }
         session_variables_[set_stmt.variable_] = set_stmt.value_;
         continue;
       }
@@ -356,6 +506,9 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
  * create / drop table and insert for now. Should remove it in the future.
  */
 void BustubInstance::GenerateTestTable() {
+  if (read_only_) {
+    throw Exception("cannot generate test tables in a read-only instance");
+  }
   auto txn = txn_manager_->Begin();
   auto exec_ctx = MakeExecutorContext(txn);
   TableGenerator gen{exec_ctx.get()};
@@ -20,4 +20,12 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds background_writer_interval = std::chrono::milliseconds(200);
+
+std::chrono::milliseconds buffer_pool_resize_timeout = std::chrono::milliseconds(1000);
+
+std::atomic<bool> buffer_pool_huge_pages(true);
+
+std::atomic<bool> simd_key_search(true);
+
 }  // namespace bustub
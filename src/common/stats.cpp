@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// stats.cpp
+//
+// Identification: src/common/stats.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/stats.h"
+
+#include <algorithm>
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+namespace {
+
+std::atomic<size_t> next_stat_shard{0};
+
+/** Format a latency with a unit that keeps it short. */
+auto FormatNs(uint64_t ns) -> std::string {
+  if (ns < 10'000) {
+    return fmt::format("{}ns", ns);
+  }
+  if (ns < 10'000'000) {
+    return fmt::format("{}us", ns / 1'000);
+  }
+  return fmt::format("{}ms", ns / 1'000'000);
+}
+
+}  // namespace
+
+auto StatShard() -> size_t {
+  thread_local size_t shard = next_stat_shard.fetch_add(1, std::memory_order_relaxed) % STAT_SHARDS;
+  return shard;
+}
+
+auto HistogramSnapshot::PercentileNs(double percentile) const -> uint64_t {
+  if (count_ == 0) {
+    return 0;
+  }
+  // The rank of the percentile, rounded up so that p100 is the largest latency.
+  auto rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count_) + 0.999999);
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return (uint64_t{1} << (i + 1)) - 1;
+    }
+  }
+  return (uint64_t{1} << NUM_BUCKETS) - 1;
+}
+
+auto HistogramSnapshot::operator+=(const HistogramSnapshot &other) -> HistogramSnapshot & {
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  sum_ns_ += other.sum_ns_;
+  return *this;
+}
+
+auto HistogramSnapshot::ToString() const -> std::string {
+  return fmt::format("count={} mean={} p50={} p99={} max={}", count_, FormatNs(MeanNs()), FormatNs(PercentileNs(50)),
+                     FormatNs(PercentileNs(99)), FormatNs(PercentileNs(100)));
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) {
+  const auto ns = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+  // The bucket is the position of the highest set bit.
+  size_t bucket = ns == 0 ? 0 : 63 - __builtin_clzll(ns);
+  bucket = std::min(bucket, HistogramSnapshot::NUM_BUCKETS - 1);
+  Shard &shard = shards_[StatShard()];
+  shard.buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  shard.sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::Snapshot() const -> HistogramSnapshot {
+  HistogramSnapshot snapshot;
+  for (const auto &shard : shards_) {
+    for (size_t i = 0; i < HistogramSnapshot::NUM_BUCKETS; i++) {
+      const uint64_t count = shard.buckets_[i].load(std::memory_order_relaxed);
+      snapshot.buckets_[i] += count;
+      snapshot.count_ += count;
+    }
+    snapshot.sum_ns_ += shard.sum_ns_.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+}  // namespace bustub
@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compress_util.cpp
+//
+// Identification: src/common/util/compress_util.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/compress_util.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+// The constants of the LZ4 block format.
+constexpr size_t MIN_MATCH = 4;
+// The last match starts at least MF_LIMIT bytes and ends at least LAST_LITERALS bytes before the end of the input.
+constexpr size_t MF_LIMIT = 12;
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MAX_OFFSET = 65535;
+// A length of 15 in a token half continues in the following bytes.
+constexpr size_t RUN_MASK = 15;
+
+constexpr int HASH_LOG = 12;
+
+auto Read32(const uint8_t *p) -> uint32_t {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+auto Hash(uint32_t seq) -> uint32_t { return (seq * 2654435761U) >> (32 - HASH_LOG); }
+
+/** The most bytes a literal run and a match of the given lengths take in the output. */
+auto SequenceBound(size_t literals, size_t match) -> size_t {
+  return 1 + literals / 255 + 1 + literals + 2 + match / 255 + 1;
+}
+
+/** Write the bytes that continue a length of at least RUN_MASK. */
+auto PutLength(size_t len, uint8_t *op) -> uint8_t * {
+  len -= RUN_MASK;
+  while (len >= 255) {
+    *op++ = 255;
+    len -= 255;
+  }
+  *op++ = static_cast<uint8_t>(len);
+  return op;
+}
+
+/** Write a literal run and, unless `match` is 0, the match that follows it. @return the end of the output */
+auto PutSequence(const uint8_t *literals, size_t num_literals, size_t offset, size_t match, uint8_t *op) -> uint8_t * {
+  uint8_t *token = op++;
+  const size_t match_code = match == 0 ? 0 : match - MIN_MATCH;
+  *token = static_cast<uint8_t>((std::min(num_literals, RUN_MASK) << 4) | std::min(match_code, RUN_MASK));
+  if (num_literals >= RUN_MASK) {
+    op = PutLength(num_literals, op);
+  }
+  memcpy(op, literals, num_literals);
+  op += num_literals;
+  if (match == 0) {
+    return op;
+  }
+  *op++ = static_cast<uint8_t>(offset);
+  *op++ = static_cast<uint8_t>(offset >> 8);
+  if (match_code >= RUN_MASK) {
+    op = PutLength(match_code, op);
+  }
+  return op;
+}
+
+}  // namespace
+
+auto CompressUtil::Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t {
+  if (size > MAX_INPUT_SIZE) {
+    return 0;
+  }
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  uint8_t *op = out;
+  size_t anchor = 0;
+
+  if (size > MF_LIMIT) {
+    std::array<int32_t, 1 << HASH_LOG> table;
+    table.fill(-1);
+    const size_t match_end_limit = size - LAST_LITERALS;
+    size_t ip = 0;
+    while (ip < size - MF_LIMIT) {
+      const uint32_t seq = Read32(in + ip);
+      const uint32_t h = Hash(seq);
+      const int32_t ref = table[h];
+      table[h] = static_cast<int32_t>(ip);
+      if (ref < 0 || ip - ref > MAX_OFFSET || Read32(in + ref) != seq) {
+        ip++;
+        continue;
+      }
+      size_t match = MIN_MATCH;
+      while (ip + match < match_end_limit && in[ref + match] == in[ip + match]) {
+        match++;
+      }
+      if (static_cast<size_t>(op - out) + SequenceBound(ip - anchor, match) > capacity) {
+        return 0;
+      }
+      op = PutSequence(in + anchor, ip - anchor, ip - ref, match, op);
+      ip += match;
+      anchor = ip;
+    }
+  }
+
+  // The input always ends with a run of literals.
+  if (static_cast<size_t>(op - out) + SequenceBound(size - anchor, 0) > capacity) {
+    return 0;
+  }
+  op = PutSequence(in + anchor, size - anchor, 0, 0, op);
+  return op - out;
+}
+
+auto CompressUtil::Decompress(const char *src, size_t size, char *dst, size_t capacity) -> int64_t {
+  const auto *ip = reinterpret_cast<const uint8_t *>(src);
+  const uint8_t *const end = ip + size;
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  uint8_t *op = out;
+  uint8_t *const out_end = out + capacity;
+
+  // Read the bytes that continue a length of RUN_MASK; @return false if the input ends first.
+  auto get_length = [&](size_t *len) {
+    uint8_t b;
+    do {
+      if (ip == end) {
+        return false;
+      }
+      b = *ip++;
+      *len += b;
+    } while (b == 255);
+    return true;
+  };
+
+  while (ip < end) {
+    const uint8_t token = *ip++;
+    size_t num_literals = token >> 4;
+    if (num_literals == RUN_MASK && !get_length(&num_literals)) {
+      return -1;
+    }
+    if (num_literals > static_cast<size_t>(end - ip) || num_literals > static_cast<size_t>(out_end - op)) {
+      return -1;
+    }
+    memcpy(op, ip, num_literals);
+    ip += num_literals;
+    op += num_literals;
+    if (ip == end) {
+      // The last sequence has no match.
+      break;
+    }
+
+    if (end - ip < 2) {
+      return -1;
+    }
+    const size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - out)) {
+      return -1;
+    }
+    size_t match = token & RUN_MASK;
+    if (match == RUN_MASK && !get_length(&match)) {
+      return -1;
+    }
+    match += MIN_MATCH;
+    if (match > static_cast<size_t>(out_end - op)) {
+      return -1;
+    }
+    // The match may overlap the bytes it produces, e.g. a run of one repeated byte has offset 1.
+    const uint8_t *ref = op - offset;
+    for (size_t i = 0; i < match; i++) {
+      op[i] = ref[i];
+    }
+    op += match;
+  }
+  return op - out;
+}
+
+}  // namespace bustub
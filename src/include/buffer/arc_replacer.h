@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo & Modha, FAST '03).
+ *
+ * Resident frames are split into T1 (pages seen once recently) and T2 (pages seen at least twice recently). The ids
+ * of pages recently evicted from T1 and T2 are remembered in the ghost lists B1 and B2. A page that comes back while
+ * it is in B1 means T1 was too small, one that comes back while in B2 means T2 was too small, and the target size p
+ * of T1 adapts accordingly. The victim is the least recently used evictable frame of T1 if T1 is larger than p, and
+ * of T2 otherwise.
+ *
+ * Ghost lists need page ids, so the buffer pool reports the page of a frame through SetPageId(). Frames whose page
+ * is unknown are still managed, but are not remembered once evicted.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_frames the maximum number of frames the ARCReplacer will be required to store
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ARCReplacer);
+
+  ~ARCReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  void SetPageId(frame_id_t frame_id, page_id_t page_id) override;
+
+  /** @return the current target size of T1. For testing only. */
+  auto GetTargetT1Size() -> size_t;
+
+ private:
+  enum class ListType { NONE, T1, T2 };
+
+  struct ArcEntry {
+    ListType list_{ListType::NONE};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  /** Evict the least recently used evictable frame of `list`, remembering its page in `ghost`. */
+  auto EvictFrom(std::list<frame_id_t> *list, std::list<page_id_t> *ghost, frame_id_t *frame_id) -> bool;
+
+  /** Drop a page from whichever ghost list it is in. */
+  void EraseGhost(page_id_t page_id);
+
+  /** Trim the ghost lists so that |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c. */
+  void TrimGhosts();
+
+  size_t replacer_size_;
+  /** Number of tracked, evictable frames. */
+  size_t curr_size_{0};
+  /** Target size of T1, between 0 and replacer_size_. */
+  size_t target_t1_size_{0};
+  std::mutex latch_;
+
+  /** Per-frame metadata, indexed by frame id. */
+  std::vector<ArcEntry> entries_;
+  /** Resident lists, most recently used at the front. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  /** Ghost lists of evicted page ids, most recently evicted at the front. */
+  std::list<page_id_t> b1_;
+  std::list<page_id_t> b2_;
+  /** Position of every ghost page, and whether it is in B1 (true) or B2 (false). */
+  std::unordered_map<page_id_t, std::pair<bool, std::list<page_id_t>::iterator>> ghosts_;
+};
+
+}  // namespace bustub
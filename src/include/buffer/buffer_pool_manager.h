@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <future>  // NOLINT
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
@@ -23,6 +24,43 @@
 
 namespace bustub {
 
+class BufferRing;
+
+/** A snapshot of the statistics of a buffer pool, see BufferPoolManager::GetStats(). */
+struct BufferPoolStats {
+  size_t pool_size_{0};
+  /** Fetches of pages that were in the buffer pool. */
+  uint64_t hits_{0};
+  /** Fetches of pages that had to be read from disk. */
+  uint64_t misses_{0};
+  /** Pages evicted to make room for other pages. */
+  uint64_t evictions_{0};
+  /** Dirty pages written back, by evictions, flushes and the background writer. */
+  uint64_t dirty_write_backs_{0};
+  /** Page lookups that waited for a read or write of the page by another thread. */
+  uint64_t pin_waits_{0};
+  /** Acquisitions of the buffer pool latch that had to wait, and how long they waited in total. */
+  uint64_t latch_waits_{0};
+  uint64_t latch_wait_ns_{0};
+
+  /** @return the fraction of fetches that hit, 0 if there were none */
+  auto HitRatio() const -> double {
+    return hits_ + misses_ == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(hits_ + misses_);
+  }
+
+  auto operator+=(const BufferPoolStats &other) -> BufferPoolStats & {
+    pool_size_ += other.pool_size_;
+    hits_ += other.hits_;
+    misses_ += other.misses_;
+    evictions_ += other.evictions_;
+    dirty_write_backs_ += other.dirty_write_backs_;
+    pin_waits_ += other.pin_waits_;
+    latch_waits_ += other.latch_waits_;
+    latch_wait_ns_ += other.latch_wait_ns_;
+    return *this;
+  }
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
@@ -84,10 +122,46 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Start reading a page into the buffer pool in the background, so that a later FetchPage() of it does not stall on
+   * the disk. This is only a hint: nothing happens if the page is already resident or every frame is pinned. The
+   * prefetched page is not pinned.
+   * @param page_id id of page to be prefetched
+   */
+  void PrefetchPage(page_id_t page_id) { PrefetchPgImp(page_id, nullptr); }
+
+  /**
+   * Fetch a page without waiting for the disk read. The page is pinned like with FetchPage() once the future is ready.
+   * @param page_id id of page to be fetched
+   * @return a future of nullptr if page_id cannot be fetched, otherwise of the pinned page
+   */
+  auto FetchPageAsync(page_id_t page_id) -> std::future<Page *> { return FetchPgAsyncImp(page_id); }
+
+  /**
+   * Grow or shrink the buffer pool while it is in use. Growing adds free frames. Shrinking evicts the pages of the
+   * frames that go away, writing them back if they are dirty, and fails if some of them stay pinned.
+   * @param pool_size the new number of frames, at least 1
+   * @return true if the buffer pool now has pool_size frames
+   */
+  auto Resize(size_t pool_size) -> bool { return ResizeImp(pool_size); }
+
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /**
+   * Take a snapshot of the statistics of the buffer pool since it was created. Buffer pools that do not keep
+   * statistics only report their size.
+   * @return the statistics
+   */
+  virtual auto GetStats() -> BufferPoolStats {
+    BufferPoolStats stats;
+    stats.pool_size_ = GetPoolSize();
+    return stats;
+  }
+
  protected:
+  friend class BufferRing;
+
   /**
    * Grading function. Do not modify!
    * Invokes the callback function if it is not null.
@@ -141,5 +215,51 @@ class BufferPoolManager {
    * Flushes all the pages in the buffer pool to disk.
    */
   virtual void FlushAllPgsImp() = 0;
+
+  /**
+   * Fetch the requested page, recycling a frame of `ring` on a miss. See BufferRing.
+   * Buffer pools that do not support rings fetch the page as usual.
+   * @param page_id id of page to be fetched
+   * @param ring the ring of the calling bulk operation, or nullptr to fetch the page as usual
+   * @return the requested page
+   */
+  virtual auto FetchPgInRingImp(page_id_t page_id, BufferRing *ring) -> Page * { return FetchPgImp(page_id); }
+
+  /**
+   * Creates a new page in a recycled frame of `ring`. See BufferRing.
+   * Buffer pools that do not support rings create the page as usual.
+   * @param[out] page_id id of created page
+   * @param ring the ring of the calling bulk operation, or nullptr to create the page as usual
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPgInRingImp(page_id_t *page_id, BufferRing *ring) -> Page * { return NewPgImp(page_id); }
+
+  /**
+   * Start reading the requested page in the background, into a frame of `ring` if given.
+   * Buffer pools that do not support prefetching ignore the hint.
+   * @param page_id id of page to be prefetched
+   * @param ring the ring of the calling bulk operation, or nullptr to prefetch into the shared pool
+   */
+  virtual void PrefetchPgImp(page_id_t page_id, BufferRing *ring) {}
+
+  /**
+   * Fetch the requested page without waiting for the disk read.
+   * Buffer pools that do not support asynchronous fetches fetch the page synchronously.
+   * @param page_id id of page to be fetched
+   * @return a future of the requested page
+   */
+  virtual auto FetchPgAsyncImp(page_id_t page_id) -> std::future<Page *> {
+    std::promise<Page *> promise;
+    promise.set_value(FetchPgImp(page_id));
+    return promise.get_future();
+  }
+
+  /**
+   * Change the number of frames of the buffer pool.
+   * Buffer pools that cannot be resized refuse.
+   * @param pool_size the new number of frames
+   * @return true if the buffer pool was resized
+   */
+  virtual auto ResizeImp(size_t pool_size) -> bool { return false; }
 };
 }  // namespace bustub
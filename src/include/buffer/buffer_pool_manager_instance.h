@@ -12,16 +12,25 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
-#include <mutex>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_k_replacer.h"
+#include "buffer/buffer_ring.h"
+#include "buffer/frame_arena.h"
+#include "buffer/page_table.h"
+#include "buffer/replacer.h"
+#include "common/stats.h"
 #include "common/config.h"
-#include "container/hash/extendible_hash_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
 #include "storage/page/page.h"
 
 namespace bustub {
@@ -37,9 +46,24 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy used to pick victim frames
    */
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU_K);
+
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a ParallelBufferPoolManager.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPMs in the parallel BPM
+   * @param instance_index index of this BPM in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy used to pick victim frames
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU_K);
 
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
@@ -49,10 +73,37 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t override { return pool_size_; }
 
-  /** @brief Return the pointer to all the pages in the buffer pool. */
-  auto GetPages() -> Page * { return pages_; }
+  /** @brief Return the statistics of the buffer pool. Cheap enough to poll, it does not take the latch. */
+  auto GetStats() -> BufferPoolStats override;
+
+  /**
+   * @brief Return the page in a frame of the buffer pool. The frames are not contiguous, since the pool can grow.
+   * @param frame_id the frame, below GetPoolSize()
+   */
+  auto GetFramePage(frame_id_t frame_id) -> Page * {
+    std::scoped_lock<std::mutex> lock(latch_);
+    return &pages_[frame_id];
+  }
+
+  /** @brief Return the arena that holds the data of the frames. Must not be called during a Resize(). */
+  auto GetFrameArena() -> const FrameArena & { return arena_; }
+
+  /**
+   * @brief Start a background thread that writes dirty, unpinned pages back to disk ahead of demand, so that the
+   * victims picked by fetches are mostly clean. The thread sweeps the pool every `interval`, and as soon as more than
+   * `dirty_high_watermark` of the frames are dirty. Does nothing if the writer is already running.
+   * @param interval how long the writer sleeps between two sweeps
+   * @param dirty_high_watermark fraction of dirty frames above which the writer is woken up early
+   */
+  void StartBackgroundWriter(std::chrono::milliseconds interval = background_writer_interval,
+                             double dirty_high_watermark = DIRTY_PAGE_HIGH_WATERMARK);
+
+  /** @brief Stop the background writer, waiting for the write in flight if any. */
+  void StopBackgroundWriter();
 
  protected:
+  friend class ParallelBufferPoolManager;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -65,7 +116,7 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    *
    * Remember to "Pin" the frame by calling replacer.SetEvictable(frame_id, false)
    * so that the replacer wouldn't evict the frame before the buffer pool manager "Unpin"s it.
-   * Also, remember to record the access history of the frame in the replacer for the lru-k algorithm to work.
+   * Also, remember to record the access history of the frame in the replacer for the replacement policy to work.
    *
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
@@ -140,81 +191,255 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto DeletePgImp(page_id_t page_id) -> bool override;
 
-  auto GetVictimPage(frame_id_t *frame_id, page_id_t page_id) -> Page * {
-    //    std::cout << "[BPM:NewPageFromFreeListOrReplacer] free_list size:" << free_list_.size()
-    //              << ", replacer size:" << replacer_->Size() << std::endl;
-
-    if (free_list_.empty() && replacer_->Size() == 0) {
-      return nullptr;
-    }
-
-    if (!free_list_.empty()) {
-      *frame_id = free_list_.front();
-      free_list_.pop_front();
-    } else {
-      replacer_->Evict(frame_id);
-    }
-
-    Page *page = &pages_[*frame_id];
-    //    std::cout << "[BPM:NewPageFromFreeListOrReplacer] page table remove page id: " << page->GetPageId() <<
-    //    std::endl;
-    page_table_->Remove(page->GetPageId());
-
-    if (page->IsDirty()) {
-      disk_manager_->WritePage(page->GetPageId(), page->GetData());
-      page->is_dirty_ = false;
-      page->ResetMemory();
-    }
-
-    page->pin_count_ = 1;
-
-    if (page_id == INVALID_PAGE_ID) {
-      page_id = AllocatePage();
-      //      std::cout << "[BPM:NewPageFromFreeListOrReplacer] allocate page id: " << page_id << std::endl;
-    }
-    page->page_id_ = page_id;
-
-    page_table_->Insert(page_id, *frame_id);
-    replacer_->SetEvictable(*frame_id, false);
-    replacer_->RecordAccess(*frame_id);
-    return page;
-  }
+  /**
+   * @brief Fetch the requested page like FetchPgImp(). On a miss, the frame loaded by `ring` the longest time ago is
+   * recycled if nobody else uses it, instead of a victim of the replacer.
+   * @param page_id id of page to be fetched
+   * @param ring the ring of the calling bulk operation, or nullptr to fetch the page as usual
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPgInRingImp(page_id_t page_id, BufferRing *ring) -> Page * override;
 
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
-  /** Bucket size for the extendible hash table */
-  const size_t bucket_size_ = 4;
+  /**
+   * @brief Create a new page like NewPgImp(), in a recycled frame of `ring` if possible.
+   * @param[out] page_id id of created page
+   * @param ring the ring of the calling bulk operation, or nullptr to create the page as usual
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgInRingImp(page_id_t *page_id, BufferRing *ring) -> Page * override;
+
+  /**
+   * @brief Start reading page_id into a frame on a background thread. The frame is picked like for FetchPgInRingImp()
+   * and stays pinned and marked as "I/O in progress" until the read is done, so concurrent fetchers wait for it
+   * instead of reading the page a second time. Does nothing if page_id is resident or every frame is pinned.
+   * @param page_id id of page to be prefetched
+   * @param ring the ring of the calling bulk operation, or nullptr to prefetch into the shared pool
+   */
+  void PrefetchPgImp(page_id_t page_id, BufferRing *ring) override;
+
+  /**
+   * @brief Fetch the requested page like FetchPgImp(), but read it on a background thread on a miss. If another
+   * thread is already reading the page, this call waits for that read.
+   * @param page_id id of page to be fetched
+   * @return a future of nullptr if page_id cannot be fetched, otherwise of the pinned page
+   */
+  auto FetchPgAsyncImp(page_id_t page_id) -> std::future<Page *> override;
 
-  /** Array of buffer pool pages. */
-  Page *pages_;
+  /**
+   * @brief Pick a frame for page_id from the free list or the replacer and bind it to page_id. Caller must hold the
+   * latch through `lock`.
+   *
+   * The returned frame is pinned once and marked as "I/O in progress", and page_id is already visible in the page
+   * table, so concurrent fetchers of page_id wait on this frame instead of reading the page a second time. If the
+   * victim is dirty, the latch is released while it is written back; the victim's old page id stays mapped to the
+   * frame until the write completes, so nobody can read a stale copy of it from disk in the meantime. The caller must
+   * finish the I/O with FinishFrameIo().
+   *
+   * With a ring, the next frame of the ring is recycled first if possible, and the picked frame joins the ring.
+   *
+   * @param lock the held buffer pool latch
+   * @param[out] frame_id id of the frame that was picked
+   * @param page_id id of the page to bind, or INVALID_PAGE_ID to allocate a new page
+   * @param ring the ring of the calling bulk operation, or nullptr
+   * @return nullptr if all frames are pinned, otherwise the frame's page
+   */
+  auto AcquireFrame(std::unique_lock<std::mutex> &lock, frame_id_t *frame_id, page_id_t page_id, BufferRing *ring)
+      -> Page *;
+
+  /**
+   * @brief Take the next frame of `ring` out of the replacer if the ring can recycle it, i.e. it still holds the page
+   * the ring loaded, is unpinned, and was not hit by a regular fetch since. Caller must hold the latch.
+   * @param ring the ring of the calling bulk operation
+   * @param[out] frame_id the recycled frame
+   * @return true if a frame was recycled
+   */
+  auto RecycleRingFrame(BufferRing *ring, frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Look up page_id in the page table, waiting for any I/O in flight on its frame. Caller must hold the latch
+   * through `lock`, which is released while waiting.
+   * @param lock the held buffer pool latch
+   * @param page_id id of the page to look up
+   * @param[out] frame_id the frame holding page_id
+   * @return true if page_id is resident and no I/O is in flight on its frame
+   */
+  auto FindFrame(std::unique_lock<std::mutex> &lock, page_id_t page_id, frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Clear the "I/O in progress" mark of a frame and wake up the threads waiting on it. Caller must hold the
+   * latch.
+   * @param frame_id the frame whose I/O finished
+   */
+  void FinishFrameIo(frame_id_t frame_id);
+
+  /**
+   * @brief Read the page bound to a frame returned by AcquireFrame() on a background thread. `on_read` runs on that
+   * thread once the data is in the frame, without the latch held; it must finish the I/O with FinishFrameIo(). Caller
+   * must hold the latch.
+   * @param frame_id the frame to read into
+   * @param on_read the completion callback
+   */
+  void ScheduleRead(frame_id_t frame_id, std::function<void()> on_read);
+
+  /**
+   * @brief Write the page of a frame back to disk, regardless of its dirty flag. The latch is released during the
+   * write; the frame is pinned and marked as "I/O in progress" meanwhile, so that it is neither evicted nor fetched.
+   * Caller must hold the latch through `lock`, and no I/O may be in flight on the frame.
+   * @param lock the held buffer pool latch
+   * @param frame_id the frame to write back
+   */
+  void WriteBackFrame(std::unique_lock<std::mutex> &lock, frame_id_t frame_id);
+
+  /**
+   * @brief Prepare a frame for WriteBackFrames(): clear its dirty flag, pin it and mark it as "I/O in progress". Caller
+   * must hold the latch, and no I/O may be in flight on the frame.
+   * @param frame_id the frame to write back
+   */
+  void BeginWriteBack(frame_id_t frame_id);
+
+  /**
+   * @brief Write the pages of frames prepared with BeginWriteBack() in a single batch of the disk manager, release the
+   * frames and clear `frames`. Caller must hold the latch through `lock`, which is released during the writes.
+   * @param lock the held buffer pool latch
+   * @param frames the frames to write back
+   */
+  void WriteBackFrames(std::unique_lock<std::mutex> &lock, std::vector<frame_id_t> *frames);
+
+  /**
+   * @brief Set the dirty flag of a page and keep the count of dirty frames up to date. Caller must hold the latch.
+   * @param page the page
+   * @param is_dirty the new dirty flag
+   */
+  void SetDirty(Page *page, bool is_dirty);
+
+  /**
+   * @brief Add frames to or remove frames from the end of the pool.
+   * @param pool_size the new number of frames
+   * @return true if the buffer pool was resized
+   */
+  auto ResizeImp(size_t pool_size) -> bool override;
+
+  /**
+   * @brief Empty the frames at and above `pool_size`, so that they can be removed. Caller must hold the latch through
+   * `lock`, which is released while pages are written back and while pinned pages are waited for.
+   * @param lock the held buffer pool latch
+   * @param pool_size the first frame to empty
+   * @return false if some of the frames stayed in use until the resize timed out
+   */
+  auto DrainFrames(std::unique_lock<std::mutex> &lock, size_t pool_size) -> bool;
+
+  /**
+   * @brief Replace the replacer by one sized for `pool_size` frames. The frames in use are handed over, the evictable
+   * ones in the order the old replacer would have evicted them, so that the coldest pages still go first. Caller must
+   * hold the latch.
+   * @param pool_size the number of frames of the new replacer
+   */
+  void RebuildReplacer(size_t pool_size);
+
+  /** @brief Take the buffer pool latch, accounting for the time spent waiting for it. */
+  auto LockLatch() -> std::unique_lock<std::mutex>;
+
+  /** @brief Body of the background writer thread. */
+  void RunBackgroundWriter(std::chrono::milliseconds interval);
+
+  /** A growing Resize() releases the latch after adding this many frames. */
+  static constexpr size_t RESIZE_CHUNK_SIZE = 1024;
+
+  /** Per-frame state, used to wait for a single frame without holding the buffer pool latch. */
+  struct FrameIoState {
+    /** True while the frame is being read from or written to disk without the latch held. */
+    bool in_progress_{false};
+    /** Signalled, under the latch, when in_progress_ goes back to false. */
+    std::condition_variable cv_;
+    /** True if the frame was loaded through a BufferRing and no regular fetch has hit it since. */
+    bool in_ring_{false};
+  };
+
+  /** Number of pages in the buffer pool. Changed under the latch by Resize(), but read without it. */
+  std::atomic<size_t> pool_size_;
+  /** Frames at and above this index are being drained by a shrinking Resize() and must not be recycled. */
+  size_t drain_from_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
+  /** The next page id to be allocated, always congruent to instance_index_ modulo num_instances_ */
+  std::atomic<page_id_t> next_page_id_ = instance_index_;
+
+  /** The data of the frames. Declared before pages_, which points into it. */
+  FrameArena arena_;
+  /**
+   * The metadata of the frames, one cache-line-aligned Page per frame whose data lives in arena_. A deque, so that
+   * Resize() can add and remove frames without moving the others.
+   */
+  std::deque<Page> pages_;
+  /** Per-frame I/O states, parallel to pages_. */
+  std::deque<FrameIoState> frame_io_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
   /** Page table for keeping track of buffer pool pages. */
-  ExtendibleHashTable<page_id_t, frame_id_t> *page_table_;
+  PageTable *page_table_;
+  /** Background readers of prefetched pages, started by the first prefetch. */
+  std::unique_ptr<DiskScheduler> disk_scheduler_;
   /** Replacer to find unpinned pages for replacement. */
-  LRUKReplacer *replacer_;
+  std::unique_ptr<Replacer> replacer_;
+  /** The policy and lookback constant of replacer_, to rebuild it when the pool is resized. */
+  const ReplacerType replacer_type_;
+  const size_t replacer_k_;
+  /** Statistics, see GetStats(). */
+  struct {
+    StatCounter hits_;
+    StatCounter misses_;
+    StatCounter evictions_;
+    StatCounter dirty_write_backs_;
+    StatCounter pin_waits_;
+    StatCounter latch_waits_;
+    StatCounter latch_wait_ns_;
+  } stats_;
+  /** Resize() calls run one at a time. */
+  std::mutex resize_latch_;
+  /** Signalled when a frame being drained by Resize() is unpinned. */
+  std::condition_variable drain_cv_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** Number of frames whose page is dirty. */
+  size_t num_dirty_frames_{0};
+  /** The background writer is woken up early when more than this many frames are dirty. */
+  size_t dirty_high_watermark_{0};
+  /** The background writer, if running. */
+  std::thread background_writer_;
+  /** True while the background writer should keep running. */
+  bool background_writer_enabled_{false};
+  /** Wakes up the background writer, signalled under the latch. */
+  std::condition_variable background_writer_cv_;
+  /**
+   * This latch protects the page table, the free list, the replacer, the frame metadata (page id, pin count, dirty
+   * flag, I/O state) and the state of the background writer. It is never held during disk I/O.
+   */
   std::mutex latch_;
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk, reusing the lowest page this instance deallocated if there is one. Caller should
+   * acquire the latch before calling this function.
    * @return the id of the allocated page
    */
   auto AllocatePage() -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk, so that AllocatePage() can hand out its id again. Caller should acquire the latch
+   * before calling this function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
+
+  /**
+   * @brief Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions to
+   * validate input data and ensure that a parallel BPM is routing requests to the correct BPI.
+   * @param page_id the page id to validate
+   */
+  void ValidatePageId(page_id_t page_id) const;
 
   // TODO(student): You may add additional private members and helper functions
 };
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring.h
+//
+// Identification: src/include/buffer/buffer_ring.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * BufferRing is a small private set of frames that a bulk operation (a full table scan, a bulk insert) recycles
+ * instead of evicting pages from the shared buffer pool, in the spirit of PostgreSQL's buffer access strategies.
+ *
+ * Pages that miss the buffer pool are loaded through the ring. Once the ring is full, the frame it loaded
+ * `GetRingSize()` misses ago is reused for the next miss, so the operation touches at most that many frames no matter
+ * how many pages it reads, and the hot working set of the other transactions survives. A ring frame is given back to
+ * the shared pool, and never recycled, when it is still pinned or when it was hit by a regular fetch in the meantime.
+ * Pages that are already resident are used in place and do not join the ring.
+ *
+ * Pages fetched through the ring are unpinned through the buffer pool as usual. A ring is not thread-safe; it belongs
+ * to a single operation and must outlive every page fetched through it.
+ */
+class BufferRing {
+ public:
+  /** The kinds of bulk operations, which differ in their ring size. */
+  enum class RingType { BULK_READ, BULK_WRITE };
+
+  /**
+   * Create a ring sized for the given kind of operation.
+   * @param bpm the buffer pool to read pages from
+   * @param ring_type the kind of bulk operation
+   */
+  BufferRing(BufferPoolManager *bpm, RingType ring_type);
+
+  /**
+   * Create a ring of the given size.
+   * @param bpm the buffer pool to read pages from
+   * @param ring_size the number of frames the ring recycles
+   */
+  BufferRing(BufferPoolManager *bpm, size_t ring_size);
+
+  DISALLOW_COPY_AND_MOVE(BufferRing);
+
+  ~BufferRing() = default;
+
+  /**
+   * Fetch a page like BufferPoolManager::FetchPage(), recycling a frame of the ring on a miss.
+   * @param page_id id of the page to fetch
+   * @return nullptr if the page could not be fetched, otherwise the pinned page
+   */
+  auto FetchPage(page_id_t page_id) -> Page *;
+
+  /**
+   * Create a page like BufferPoolManager::NewPage(), recycling a frame of the ring.
+   * @param[out] page_id id of the created page
+   * @return nullptr if no page could be created, otherwise the pinned page
+   */
+  auto NewPage(page_id_t *page_id) -> Page *;
+
+  /**
+   * Start reading a page in the background like BufferPoolManager::PrefetchPage(), into a recycled frame of the ring.
+   * @param page_id id of the page to prefetch
+   */
+  void PrefetchPage(page_id_t page_id);
+
+  /** @return the number of frames the ring recycles */
+  auto GetRingSize() const -> size_t { return slots_.size(); }
+
+ private:
+  friend class BufferPoolManagerInstance;
+
+  /** A frame loaded through the ring. */
+  struct Slot {
+    /** The buffer pool instance that owns the frame, nullptr while the slot is empty. */
+    const BufferPoolManager *owner_{nullptr};
+    frame_id_t frame_id_{-1};
+    /** The page the ring loaded into the frame, used to notice that the frame was reused by somebody else. */
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /** @return the slot whose frame is recycled next */
+  auto CurrentSlot() -> Slot & { return slots_[next_slot_]; }
+
+  /** Remember the frame just loaded through the ring in the current slot, and move on to the next slot. */
+  void Advance(const BufferPoolManager *owner, frame_id_t frame_id, page_id_t page_id);
+
+  BufferPoolManager *bpm_;
+  std::vector<Slot> slots_;
+  size_t next_slot_{0};
+};
+
+}  // namespace bustub
@@ -12,17 +12,20 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
 #include "buffer/replacer.h"
 #include "common/config.h"
+#include "common/macros.h"
 
 namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Every access sets the reference bit of a frame. The clock hand sweeps over the frames in frame id order, clearing
+ * the reference bits of evictable frames, and evicts the first evictable frame whose bit is already clear.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -32,21 +35,38 @@ class ClockReplacer : public Replacer {
    */
   explicit ClockReplacer(size_t num_pages);
 
+  DISALLOW_COPY_AND_MOVE(ClockReplacer);
+
   /**
    * Destroys the ClockReplacer.
    */
   ~ClockReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id) override;
 
-  void Pin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
  private:
-  // TODO(student): implement me!
+  struct ClockEntry {
+    bool tracked_{false};
+    bool evictable_{false};
+    bool referenced_{false};
+  };
+
+  size_t replacer_size_;
+  /** Number of tracked, evictable frames. */
+  size_t curr_size_{0};
+  /** The frame the clock hand points to. */
+  size_t hand_{0};
+  std::mutex latch_;
+  /** The clock, indexed by frame id. */
+  std::vector<ClockEntry> entries_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrameArena holds the page data of the frames of a buffer pool, BUSTUB_PAGE_SIZE bytes per frame, in a few large
+ * anonymous mappings instead of one allocation per frame. Frame data is aligned for O_DIRECT and starts out zeroed.
+ *
+ * With huge pages enabled, a mapping of at least HUGE_PAGE_SIZE bytes is backed by explicit huge pages (MAP_HUGETLB)
+ * if the OS has some reserved, and otherwise aligned to HUGE_PAGE_SIZE and offered to transparent huge pages. A fetch
+ * then costs one TLB entry per 512 frames instead of one per frame.
+ *
+ * The arena grows by adding mappings, so the data of existing frames never moves. It is not thread-safe: the buffer
+ * pool calls it under its latch.
+ */
+class FrameArena {
+ public:
+  /**
+   * Creates an empty arena.
+   * @param use_huge_pages true to back large mappings by huge pages when possible
+   */
+  explicit FrameArena(bool use_huge_pages = buffer_pool_huge_pages);
+
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /**
+   * Make room for `num_frames` frames in total. Throws an Exception if the memory cannot be mapped.
+   * @param num_frames the number of frames
+   */
+  void Reserve(size_t num_frames);
+
+  /**
+   * Give back the memory of the frames at and above `num_frames` to the OS. Their data reads as zeros if they are
+   * reserved again.
+   * @param num_frames the number of frames to keep
+   */
+  void Release(size_t num_frames);
+
+  /** @return the data of a frame, below GetCapacity() */
+  auto FrameData(size_t frame) -> char *;
+
+  /** @return the number of frames the arena has room for */
+  auto GetCapacity() const -> size_t { return capacity_; }
+
+  /** @return the number of bytes mapped by the arena */
+  auto GetMappedBytes() const -> size_t;
+
+  /** @return the number of bytes mapped by the arena that are backed by explicit huge pages */
+  auto GetHugeTlbBytes() const -> size_t;
+
+ private:
+  /** One anonymous mapping, holding consecutive frames. */
+  struct Chunk {
+    char *data_;
+    size_t first_frame_;
+    size_t num_frames_;
+    size_t bytes_;
+    bool huge_tlb_;
+  };
+
+  /** Map a chunk of at least `num_frames` frames after the last one. */
+  void MapChunk(size_t num_frames);
+
+  const bool use_huge_pages_;
+  std::vector<Chunk> chunks_;
+  size_t capacity_{0};
+};
+
+}  // namespace bustub
@@ -12,14 +12,12 @@
 
 #pragma once
 
-#include <iostream>
-#include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
-#include <utility>
+#include <set>
+#include <tuple>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
@@ -35,8 +33,13 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Evictable frames are kept in an ordered set keyed by backward k-distance, and every
+ * frame keeps only a fixed ring of its last k timestamps, so Evict, RecordAccess,
+ * SetEvictable and Remove run in O(log n) and memory does not grow with the number of
+ * accesses.
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
    *
@@ -54,7 +57,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
    * TODO(P1): Add implementation
@@ -72,7 +75,7 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
@@ -85,7 +88,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame that received a new access.
    */
-  void RecordAccess(frame_id_t frame_id);
+  void RecordAccess(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -104,7 +107,7 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
    * TODO(P1): Add implementation
@@ -123,7 +126,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -132,67 +135,46 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() -> size_t;
-
-  void PrintDebug() {
-    std::cout << "front<--------------->back" << std::endl;
-    std::cout << "less_than_k_frames_: ";
-    for (int &it : less_than_k_frames_) {
-      std::cout << it << " ";
-    }
-    std::cout << std::endl << "more_than_k_frames_: ";
-    for (int &it : more_than_k_frames_) {
-      std::cout << it << " ";
-    }
-    std::cout << std::endl;
-  }
+  auto Size() -> size_t override;
+
+ private:
+  /** Eviction order of an evictable frame: (has k accesses, oldest of its last k timestamps, frame id). */
+  using EvictionKey = std::tuple<bool, size_t, frame_id_t>;
 
-  auto GetLastKAccessTime(const frame_id_t x) const -> size_t {
-    const auto last_k = lru_entry_hash_.at(x).access_count_ - k_ + 1;
-    return hist_.at(std::make_pair(x, last_k));
+  /** @return the eviction key of a tracked frame. Caller must hold the latch. */
+  auto GetEvictionKey(frame_id_t frame_id) const -> EvictionKey {
+    const auto &entry = entries_[frame_id];
+    return {entry.access_count_ >= k_, history_[frame_id * k_ + entry.head_], frame_id};
   }
 
- private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
+  /** Forget the access history of a frame. Caller must hold the latch. */
+  void ResetEntry(frame_id_t frame_id) { entries_[frame_id] = LruEntry{}; }
+
   size_t current_timestamp_{0};
-  size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_{0};
+  size_t replacer_size_;
   size_t k_;
   std::mutex latch_;
 
   struct LruEntry {
     bool evictable_{false};
+    /** Number of recorded accesses, saturated at k. Zero means the frame is not tracked. */
     size_t access_count_{0};
+    /** Slot of the oldest timestamp among the frame's last k accesses in its history ring. */
+    size_t head_{0};
   };
-  std::unordered_map<frame_id_t, LruEntry> lru_entry_hash_;
-
-  std::list<frame_id_t> less_than_k_frames_;
-  std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> frame_iterator_map_;
-
-  struct PairHash {
-    auto operator()(const std::pair<frame_id_t, size_t> &p) const -> std::size_t {
-      // 使用 std::hash 计算哈希值
-      std::size_t h1 = std::hash<frame_id_t>{}(p.first);
-      std::size_t h2 = std::hash<size_t>{}(p.second);
-      return h1 ^ (h2 << 1);  // 可以使用异或和位移等运算来组合哈希值
-    }
-  };
-  std::unordered_map<std::pair<frame_id_t, size_t>, size_t, PairHash> hist_;
-
-  //  struct AccessTimeCompare {
-  //    explicit AccessTimeCompare(LRUKReplacer& replacer) : replacer_(replacer) {}
-  //    auto GetLastKAccessTime(const frame_id_t x) const -> size_t {
-  //      const auto last_k = replacer_.lru_entry_hash_.at(x).access_count_ - replacer_.k_ + 1;
-  //      return replacer_.hist_.at(std::make_pair(x, last_k));
-  //    }
-  //    auto operator()(const frame_id_t a, const frame_id_t b) const -> bool {
-  //      return GetLastKAccessTime(a) < GetLastKAccessTime(b);
-  //    }
-  //    const LRUKReplacer& replacer_;
-  //  };
-  //  std::set<frame_id_t, AccessTimeCompare> more_than_k_frames_{AccessTimeCompare(*this)};
-  std::vector<frame_id_t> more_than_k_frames_;
+  /** Per-frame metadata, indexed by frame id. */
+  std::vector<LruEntry> entries_;
+  /**
+   * Ring buffers of the last k access timestamps of every frame, frame i owns slots [i * k, (i + 1) * k). Once a frame
+   * has k accesses, the slot at head_ holds its k-th most recent access; before that, it holds its first access.
+   */
+  std::vector<size_t> history_;
+  /**
+   * Evictable frames ordered by eviction priority. Frames with less than k accesses (+inf backward k-distance) come
+   * first, ordered by their earliest access; the rest follow ordered by their k-th most recent access, i.e. by
+   * decreasing backward k-distance. The victim is always the first element.
+   */
+  std::set<EvictionKey> evictable_frames_;
 };
 
 }  // namespace bustub
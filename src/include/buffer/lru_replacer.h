@@ -12,17 +12,20 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "buffer/replacer.h"
 #include "common/config.h"
+#include "common/macros.h"
 
 namespace bustub {
 
 /**
- * LRUReplacer implements the Least Recently Used replacement policy.
+ * LRUReplacer implements the Least Recently Used replacement policy: the victim is the evictable frame whose most
+ * recent access is the oldest.
  */
 class LRUReplacer : public Replacer {
  public:
@@ -32,21 +35,37 @@ class LRUReplacer : public Replacer {
    */
   explicit LRUReplacer(size_t num_pages);
 
+  DISALLOW_COPY_AND_MOVE(LRUReplacer);
+
   /**
    * Destroys the LRUReplacer.
    */
   ~LRUReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id) override;
 
-  void Pin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
  private:
-  // TODO(student): implement me!
+  struct LruEntry {
+    bool tracked_{false};
+    bool evictable_{false};
+    size_t last_access_{0};
+  };
+
+  size_t current_timestamp_{0};
+  size_t replacer_size_;
+  std::mutex latch_;
+  /** Per-frame metadata, indexed by frame id. */
+  std::vector<LruEntry> entries_;
+  /** Evictable frames ordered by (last access, frame id); the victim is the first element. */
+  std::set<std::pair<size_t, frame_id_t>> evictable_frames_;
 };
 
 }  // namespace bustub
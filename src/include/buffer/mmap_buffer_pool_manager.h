@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mmap_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/mmap_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "common/stats.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * MmapBufferPoolManager serves the pages of a database file that nobody writes to, e.g. a snapshot copied to a
+ * reporting replica. The file is mapped read-only, and FetchPage() hands out pages that point straight into the
+ * mapping: there is no frame to copy a page into, no replacer and no buffer pool latch, and the OS page cache does the
+ * caching. Pages are never evicted, so pins are not tracked.
+ *
+ * The pool cannot create, modify or delete pages: NewPage() returns nullptr, DeletePage() returns false, and writing
+ * to a page faults. The file must not shrink while it is mapped.
+ */
+class MmapBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Map a database file. Throws an Exception if the file cannot be opened or mapped.
+   * @param db_file the database file, its size is rounded down to whole pages
+   */
+  explicit MmapBufferPoolManager(const std::string &db_file);
+
+  ~MmapBufferPoolManager() override;
+
+  DISALLOW_COPY_AND_MOVE(MmapBufferPoolManager);
+
+  /** @return the number of pages in the mapped file */
+  auto GetPoolSize() -> size_t override { return num_pages_; }
+
+  /** Every fetch of an existing page counts as a hit; the OS page cache misses are not visible here. */
+  auto GetStats() -> BufferPoolStats override;
+
+ protected:
+  /**
+   * @param page_id id of page to be fetched
+   * @return nullptr if page_id is beyond the end of the file, otherwise the page in the mapping
+   */
+  auto FetchPgImp(page_id_t page_id) -> Page * override;
+
+  /** Pages are not pinned: returns true if page_id is in the file. A page cannot have been modified. */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /** There is nothing to flush: returns true if page_id is in the file. */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /** @return nullptr, the file is read-only */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /** @return false, the file is read-only */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  void FlushAllPgsImp() override {}
+
+  /** Ask the OS to read the page ahead. */
+  void PrefetchPgImp(page_id_t page_id, BufferRing *ring) override;
+
+ private:
+  int fd_{-1};
+  char *data_{nullptr};
+  size_t num_pages_{0};
+  /** The page objects, created by the first fetch of each page. */
+  std::unique_ptr<std::atomic<Page *>[]> pages_;
+  StatCounter hits_;
+};
+
+}  // namespace bustub
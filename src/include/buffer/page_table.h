@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the ids of the pages in a buffer pool to the frames that hold them.
+ *
+ * The table is split into stripes by the hash of the page id. Each stripe is a flat open addressing table with linear
+ * probing, guarded by its own latch, so a lookup touches one latch and usually one cache line of slots, and operations
+ * on different stripes never wait for each other. A stripe doubles its capacity when it gets half full and never
+ * shrinks, so the table settles at the size the buffer pool needs.
+ */
+class PageTable {
+ public:
+  /**
+   * @brief Create a new page table.
+   * @param expected_size the number of entries the table should hold without growing, usually the pool size
+   */
+  explicit PageTable(size_t expected_size);
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  ~PageTable() = default;
+
+  /**
+   * @brief Find the frame that holds a page.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame that holds page_id
+   * @return true if page_id is in the table
+   */
+  auto Find(page_id_t page_id, frame_id_t &frame_id) -> bool;
+
+  /**
+   * @brief Map a page to a frame, replacing the previous mapping of the page if any.
+   * @param page_id the page, cannot be INVALID_PAGE_ID
+   * @param frame_id the frame that holds page_id
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Remove the mapping of a page.
+   * @param page_id the page to remove
+   * @return true if page_id was in the table
+   */
+  auto Remove(page_id_t page_id) -> bool;
+
+  /** @return the number of pages in the table */
+  auto Size() -> size_t;
+
+ private:
+  /** The stripe of a page is picked by the top STRIPE_BITS bits of its hash. */
+  static constexpr size_t STRIPE_BITS = 4;
+  static constexpr size_t NUM_STRIPES = 1U << STRIPE_BITS;
+  /** Smallest capacity of a stripe, a power of two. */
+  static constexpr size_t MIN_STRIPE_CAPACITY = 8;
+
+  struct Slot {
+    page_id_t page_id_{INVALID_PAGE_ID};
+    frame_id_t frame_id_{-1};
+  };
+
+  /** One lock-protected open addressing table. Aligned to keep the latches of the stripes in separate cache lines. */
+  struct alignas(64) Stripe {
+    std::mutex latch_;
+    /** Slots with page_id_ == INVALID_PAGE_ID are empty. The size is a power of two. */
+    std::vector<Slot> slots_;
+    size_t size_{0};
+  };
+
+  /** @return a well-mixed hash of page_id; the top bits pick the stripe, the rest the home slot */
+  static auto Hash(page_id_t page_id) -> uint64_t;
+
+  auto GetStripe(uint64_t hash) -> Stripe & { return stripes_[hash >> (64 - STRIPE_BITS)]; }
+
+  /** @return the slot that holds page_id, or the empty slot where the probe for page_id ends */
+  static auto Probe(Stripe &stripe, page_id_t page_id, uint64_t hash) -> size_t;
+
+  /** Double the capacity of a stripe and re-insert its entries. Caller must hold the stripe latch. */
+  static void Grow(Stripe &stripe);
+
+  std::unique_ptr<Stripe[]> stripes_;
+};
+
+}  // namespace bustub
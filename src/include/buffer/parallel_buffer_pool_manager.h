@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards pages across several BufferPoolManagerInstances by page_id % num_instances, so that
+ * operations on independent pages never contend on the same instance latch.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of every instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of every instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU_K);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override = default;
+
+  /** @return size of the buffer pool, i.e. the number of frames summed over all instances */
+  auto GetPoolSize() -> size_t override;
+
+  /** @return the statistics summed over all instances */
+  auto GetStats() -> BufferPoolStats override;
+
+  /** @return the number of BufferPoolManagerInstances */
+  auto GetNumInstances() const -> size_t { return instances_.size(); }
+
+  /**
+   * Start the background writer of every instance. See BufferPoolManagerInstance::StartBackgroundWriter().
+   * @param interval how long the writers sleep between two sweeps
+   * @param dirty_high_watermark fraction of dirty frames of an instance above which its writer is woken up early
+   */
+  void StartBackgroundWriter(std::chrono::milliseconds interval = background_writer_interval,
+                             double dirty_high_watermark = DIRTY_PAGE_HIGH_WATERMARK);
+
+  /** Stop the background writer of every instance. */
+  void StopBackgroundWriter();
+
+ protected:
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling given page id, or nullptr for an
+   * invalid page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /**
+   * Fetch the requested page from the buffer pool.
+   * @param page_id id of page to be fetched
+   * @return the requested page
+   */
+  auto FetchPgImp(page_id_t page_id) -> Page * override;
+
+  /**
+   * Unpin the target page from the buffer pool.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /**
+   * Flushes the target page to disk.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Creates a new page in the buffer pool. Instances are tried in round robin order starting from a rotating index,
+   * and the first instance that is able to allocate a page wins.
+   * @param[out] page_id id of created page
+   * @return nullptr if no instance could create a new page, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /**
+   * Deletes a page from the buffer pool.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Flushes all the pages in the buffer pool to disk.
+   */
+  void FlushAllPgsImp() override;
+
+  /**
+   * Fetch the requested page from the instance that owns it, recycling a frame of `ring` on a miss.
+   * @param page_id id of page to be fetched
+   * @param ring the ring of the calling bulk operation, or nullptr to fetch the page as usual
+   * @return the requested page
+   */
+  auto FetchPgInRingImp(page_id_t page_id, BufferRing *ring) -> Page * override;
+
+  /**
+   * Creates a new page like NewPgImp(), in a recycled frame of `ring` if possible.
+   * @param[out] page_id id of created page
+   * @param ring the ring of the calling bulk operation, or nullptr to create the page as usual
+   * @return nullptr if no instance could create a new page, otherwise pointer to new page
+   */
+  auto NewPgInRingImp(page_id_t *page_id, BufferRing *ring) -> Page * override;
+
+  /**
+   * Start reading the requested page in the background in the instance that owns it.
+   * @param page_id id of page to be prefetched
+   * @param ring the ring of the calling bulk operation, or nullptr to prefetch into the shared pool
+   */
+  void PrefetchPgImp(page_id_t page_id, BufferRing *ring) override;
+
+  /**
+   * Fetch the requested page from the instance that owns it without waiting for the disk read.
+   * @param page_id id of page to be fetched
+   * @return a future of the requested page
+   */
+  auto FetchPgAsyncImp(page_id_t page_id) -> std::future<Page *> override;
+
+  /**
+   * Resize every instance, splitting the frames evenly between them. If an instance cannot shrink, the instances
+   * already resized get their old size back, and the pool keeps its old size.
+   * @param pool_size the new number of frames summed over all instances, at least the number of instances
+   * @return true if every instance was resized
+   */
+  auto ResizeImp(size_t pool_size) -> bool override;
+
+ private:
+  /** The shards, instance i owns every page id with page_id % num_instances == i. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  /** Instance that the next NewPgImp call starts probing from. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
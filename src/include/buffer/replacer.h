@@ -12,12 +12,21 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a buffer pool can be built with. */
+enum class ReplacerType { LRU, CLOCK, LRU_K, ARC, TWO_QUEUE };
+
 /**
  * Replacer is an abstract class that tracks page usage.
+ *
+ * A frame is tracked from its first RecordAccess() until it is evicted or removed. Only tracked frames that are
+ * marked as evictable are candidates for eviction.
  */
 class Replacer {
  public:
@@ -25,26 +34,57 @@ class Replacer {
   virtual ~Replacer() = default;
 
   /**
-   * Remove the victim frame as defined by the replacement policy.
-   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
+   * Remove the victim frame as defined by the replacement policy, along with its access history.
+   * @param[out] frame_id id of frame that was removed
    * @return true if a victim frame was found, false otherwise
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
+   * Record the event that the given frame is accessed now. Starts tracking the frame if it is not tracked yet.
+   * @param frame_id the id of the frame that received a new access
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  virtual void RecordAccess(frame_id_t frame_id) = 0;
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
+   * Toggle whether a tracked frame is evictable. Does nothing for frames that are not tracked.
+   * @param frame_id the id of the frame whose evictable status will be modified
+   * @param set_evictable whether the given frame is evictable or not
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
+
+  /**
+   * Stop tracking an evictable frame without counting it as an eviction, e.g. because its page was deleted.
+   * Does nothing if the frame is not tracked or not evictable.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
 
   /** @return the number of elements in the replacer that can be victimized */
   virtual auto Size() -> size_t = 0;
+
+  /**
+   * Tell the replacer which page a frame is about to hold, before the first RecordAccess() of that frame. Policies
+   * that remember recently evicted pages (ARC, 2Q) use it to recognize a page that comes back; the others ignore it.
+   * @param frame_id the id of the frame
+   * @param page_id the id of the page loaded into the frame
+   */
+  virtual void SetPageId(frame_id_t frame_id, page_id_t page_id) {}
+
+  /**
+   * Create a replacer implementing the given policy.
+   * @param replacer_type the replacement policy
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   * @param k the lookback constant, only used by the LRU-K policy
+   * @return the new replacer
+   */
+  static auto Create(ReplacerType replacer_type, size_t num_frames, size_t k) -> std::unique_ptr<Replacer>;
+
+  /** @return the replacement policy named by `name` (lru, clock, lru-k, arc, 2q), case insensitive */
+  static auto ParseReplacerType(const std::string &name) -> ReplacerType;
+
+  /** @return the name of the given replacement policy */
+  static auto ReplacerTypeToString(ReplacerType replacer_type) -> std::string;
 };
 
 }  // namespace bustub
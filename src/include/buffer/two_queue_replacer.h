@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full 2Q replacement policy (Johnson & Shasha, VLDB '94).
+ *
+ * Pages seen for the first time enter A1in, a FIFO queue; hitting them again while they are in A1in does not promote
+ * them, so a single scan cannot flush the hot set. When a page is evicted from A1in, its id is remembered in the ghost
+ * queue A1out. A page that comes back while it is in A1out has proven to be reused and enters Am, an LRU list. The
+ * victim comes from A1in while A1in holds more than Kin frames, and from Am otherwise.
+ *
+ * Recognizing returning pages needs page ids, so the buffer pool reports the page of a frame through SetPageId().
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TwoQueueReplacer with the tuning recommended in the paper: Kin = 25% and Kout = 50% of the frames.
+   * @param num_frames the maximum number of frames the TwoQueueReplacer will be required to store
+   */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQueueReplacer);
+
+  ~TwoQueueReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  void SetPageId(frame_id_t frame_id, page_id_t page_id) override;
+
+ private:
+  enum class QueueType { NONE, A1IN, AM };
+
+  struct TwoQueueEntry {
+    QueueType queue_{QueueType::NONE};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  /** Evict the oldest evictable frame of `queue`. */
+  auto EvictFrom(std::list<frame_id_t> *queue, frame_id_t *frame_id) -> bool;
+
+  size_t replacer_size_;
+  /** Maximum number of frames in A1in before it is preferred for eviction. */
+  size_t kin_;
+  /** Maximum number of page ids remembered in A1out. */
+  size_t kout_;
+  /** Number of tracked, evictable frames. */
+  size_t curr_size_{0};
+  std::mutex latch_;
+
+  /** Per-frame metadata, indexed by frame id. */
+  std::vector<TwoQueueEntry> entries_;
+  /** Resident queues, newest at the front. */
+  std::list<frame_id_t> a1in_;
+  std::list<frame_id_t> am_;
+  /** Ghost queue of page ids evicted from A1in, newest at the front, and their positions. */
+  std::list<page_id_t> a1out_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> a1out_pos_;
+};
+
+}  // namespace bustub
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_ring.h"
 #include "catalog/schema.h"
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree_index.h"
@@ -228,12 +229,15 @@ class Catalog {
     // TODO(chi): support both hash index and btree index
     auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap, sorted and packed into the tree bottom-up
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    // A full scan of a large table would flush everybody else's pages out of the buffer pool.
+    BufferRing ring(bpm_, BufferRing::RingType::BULK_READ);
+    for (auto tuple = heap->Begin(txn, &ring); tuple != heap->End(); ++tuple) {
+      index->AddBulkLoadEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid());
     }
+    index->FinishBulkLoad();
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
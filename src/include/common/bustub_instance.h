@@ -203,6 +203,21 @@ class FortTableWriter : public ResultWriter {
   std::vector<std::string> tables_;
 };
 
+/**
+ * How a BusTub instance backed by a database file stores its pages.
+ */
+struct BustubInstanceOptions {
+  /** Batch the disk I/O through io_uring, falling back to synchronous I/O if io_uring is unavailable. */
+  bool use_io_uring_{false};
+  /** Store the pages compressed in the database file; takes precedence over use_io_uring_. */
+  bool compress_pages_{false};
+  /**
+   * Serve the pages straight from a read-only mapping of the database file, see MmapBufferPoolManager, and reject the
+   * statements that write. The mapping reads the file as is, so this cannot be combined with the other options.
+   */
+  bool read_only_{false};
+};
+
 class BustubInstance {
  private:
   /**
@@ -210,8 +225,18 @@ class BustubInstance {
    */
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
+  /**
+   * Check that the database file was created with the page size of this build, throw an Exception if not.
+   */
+  void CheckPageSize();
+
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /**
+   * Create a BusTub instance backed by a database file.
+   * @param db_file_name the database file
+   * @param options how to store the pages, throws an Exception if they do not go together
+   */
+  explicit BustubInstance(const std::string &db_file_name, const BustubInstanceOptions &options = {});
 
   BustubInstance();
 
@@ -231,6 +256,7 @@ class BustubInstance {
    * FOR TEST ONLY. Generate test tables in this BusTub instance.
    * It's used in the shell to predefine some tables, as we don't support
    * create / drop table and insert for now. Should remove it in the future.
+   * Throws an Exception in a read-only instance.
    */
   void GenerateTestTable();
 
@@ -270,8 +296,13 @@ class BustubInstance {
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
+  void CmdDisplayBufferPoolStats(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
+  /** Handle `SET buffer_pool_size = ...`; throws if the size is invalid or the buffer pool cannot shrink to it. */
+  void ResizeBufferPool(const std::string &value);
   std::unordered_map<std::string, std::string> session_variables_;
+  /** True if the database file is mapped read-only, see BustubInstanceOptions::read_only_. */
+  bool read_only_{false};
 };
 
 }  // namespace bustub
@@ -14,8 +14,14 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
+// The page size is chosen when configuring the build, see BUSTUB_PAGE_SIZE in CMakeLists.txt.
+#ifndef BUSTUB_CONFIG_PAGE_SIZE
+#define BUSTUB_CONFIG_PAGE_SIZE 4096
+#endif
+
 namespace bustub {
 
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
@@ -27,15 +33,46 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** The background writer of a buffer pool looks for dirty pages every BACKGROUND_WRITER_INTERVAL milliseconds. */
+extern std::chrono::milliseconds background_writer_interval;
+
+/** A buffer pool gives up shrinking if the frames to remove stay pinned for BUFFER_POOL_RESIZE_TIMEOUT. */
+extern std::chrono::milliseconds buffer_pool_resize_timeout;
+
+/** True if the frames of a buffer pool should be backed by huge pages when the OS provides them. */
+extern std::atomic<bool> buffer_pool_huge_pages;
+
+/**
+ * True if B+ tree nodes with integer keys should search their encoded keys in place, with SIMD instructions when the
+ * CPU has them, instead of decoding each key they compare.
+ */
+extern std::atomic<bool> simd_key_search;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
-static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int BUSTUB_PAGE_SIZE = BUSTUB_CONFIG_PAGE_SIZE;                     // size of a data page in byte
+static constexpr int DIRECT_IO_ALIGNMENT = 512;                                      // alignment of O_DIRECT buffers
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int BULK_READ_RING_SIZE = 16;   // frames recycled by a bulk read buffer ring
+static constexpr int BULK_WRITE_RING_SIZE = 32;  // frames recycled by a bulk write buffer ring
+static constexpr int PREFETCH_IO_THREADS = 2;    // background threads that read prefetched pages
+static constexpr double DIRTY_PAGE_HIGH_WATERMARK = 0.5;  // dirty fraction of the pool that wakes the writer early
+static constexpr uint32_t IO_URING_QUEUE_DEPTH = 64;    // requests in flight in one io_uring submission
+static constexpr int WRITE_BACK_BATCH_SIZE = 32;         // dirty pages written back to disk in one batch
+static constexpr int COMPRESSED_SLOT_SIZE = 512;         // allocation unit of a compressed database file
+static constexpr int CACHE_LINE_SIZE = 64;                // alignment of per-frame metadata
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;  // size of a huge page backing buffer pool frames
+static constexpr size_t EXTERNAL_SORT_MEMORY = 64 * 1024 * 1024;  // bytes an external sort holds in memory
+static constexpr double BULK_LOAD_FILL_FACTOR = 0.9;  // fraction of each B+ tree node filled by a bulk load
+static constexpr int KEY_SEARCH_WINDOW = 16;  // B+ tree node entries compared at once at the end of a key search
+
+static_assert(BUSTUB_PAGE_SIZE >= 4096 && BUSTUB_PAGE_SIZE <= 65536 && (BUSTUB_PAGE_SIZE & (BUSTUB_PAGE_SIZE - 1)) == 0,
+              "the page size must be a power of two between 4 KB and 64 KB");
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
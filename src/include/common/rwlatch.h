@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>  // NOLINT
 #include <shared_mutex>
 
@@ -21,18 +23,64 @@ namespace bustub {
 
 /**
  * Reader-Writer latch backed by std::mutex.
+ *
+ * Besides the shared and exclusive modes, the latch can be read optimistically: the writers bump a version counter
+ * when they take and when they release the latch, so a reader that saw the same even version before and after its
+ * reads knows that no writer got in between, without writing to the latch itself.
  */
 class ReaderWriterLatch {
  public:
   /**
    * Acquire a write latch.
    */
-  void WLock() { mutex_.lock(); }
+  void WLock() {
+    mutex_.lock();
+    // An odd version tells optimistic readers that a write is in progress. The fence keeps the writes that follow
+    // from being seen before the version.
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  /**
+   * Acquire a write latch if nobody holds the latch.
+   * @return false if the latch is held, it is not acquired then
+   */
+  auto TryWLock() -> bool {
+    if (!mutex_.try_lock()) {
+      return false;
+    }
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+  }
 
   /**
    * Release a write latch.
    */
-  void WUnlock() { mutex_.unlock(); }
+  void WUnlock() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    mutex_.unlock();
+  }
+
+  /**
+   * Start an optimistic read, which takes no latch at all.
+   * @param[out] version the version to validate the read with
+   * @return false if a writer holds the latch, the read cannot succeed then
+   */
+  auto OptimisticRLock(uint64_t *version) const -> bool {
+    *version = version_.load(std::memory_order_acquire);
+    return (*version & 1) == 0;
+  }
+
+  /**
+   * Check that no writer took the latch since OptimisticRLock() returned `version`. The data read in between may have
+   * been torn by a writer if this fails, and must be discarded.
+   * @return true if the reads since OptimisticRLock() are consistent
+   */
+  auto Validate(uint64_t version) const -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
 
   /**
    * Acquire a read latch.
@@ -46,6 +94,8 @@ class ReaderWriterLatch {
 
  private:
   std::shared_mutex mutex_;
+  /** Odd while a writer holds the latch. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
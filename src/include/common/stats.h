@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// stats.h
+//
+// Identification: src/include/common/stats.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/** Number of shards of the statistics, threads are spread over them. */
+static constexpr size_t STAT_SHARDS = 16;
+
+/** @return the shard of the calling thread, assigned round-robin on the first call */
+auto StatShard() -> size_t;
+
+/**
+ * StatCounter is a counter that many threads bump on hot paths. Every thread adds to its own cache line (one of
+ * STAT_SHARDS, so threads rarely share one), and the shards are only summed up when the counter is read.
+ */
+class StatCounter {
+ public:
+  StatCounter() = default;
+  DISALLOW_COPY_AND_MOVE(StatCounter);
+
+  void Add(uint64_t n = 1) { shards_[StatShard()].value_.fetch_add(n, std::memory_order_relaxed); }
+
+  /** @return the sum of all the additions so far; concurrent additions may or may not be included */
+  auto Get() const -> uint64_t {
+    uint64_t sum = 0;
+    for (const auto &shard : shards_) {
+      sum += shard.value_.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value_{0};
+  };
+  std::array<Shard, STAT_SHARDS> shards_;
+};
+
+/** A point-in-time copy of a LatencyHistogram. */
+struct HistogramSnapshot {
+  /** Bucket i counts the latencies in [2^i, 2^(i+1)) nanoseconds; bucket 0 also counts 0. */
+  static constexpr size_t NUM_BUCKETS = 40;
+
+  std::array<uint64_t, NUM_BUCKETS> buckets_{};
+  uint64_t count_{0};
+  uint64_t sum_ns_{0};
+
+  /** @return the mean latency in nanoseconds, 0 if nothing was recorded */
+  auto MeanNs() const -> uint64_t { return count_ == 0 ? 0 : sum_ns_ / count_; }
+
+  /**
+   * @param percentile between 0 and 100
+   * @return an upper bound of the latency at `percentile`, in nanoseconds, 0 if nothing was recorded
+   */
+  auto PercentileNs(double percentile) const -> uint64_t;
+
+  auto operator+=(const HistogramSnapshot &other) -> HistogramSnapshot &;
+
+  /** @return e.g. "count=12 mean=8us p50=8us p99=32us" */
+  auto ToString() const -> std::string;
+};
+
+/**
+ * LatencyHistogram records latencies into power-of-two buckets. Like StatCounter, it is sharded by thread and cheap to
+ * record into.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram() = default;
+  DISALLOW_COPY_AND_MOVE(LatencyHistogram);
+
+  void Record(std::chrono::nanoseconds latency);
+
+  auto Snapshot() const -> HistogramSnapshot;
+
+ private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, HistogramSnapshot::NUM_BUCKETS> buckets_{};
+    std::atomic<uint64_t> sum_ns_{0};
+  };
+  std::array<Shard, STAT_SHARDS> shards_;
+};
+
+/** Measures the time from its construction to its destruction into a histogram. */
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(LatencyHistogram *histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  DISALLOW_COPY_AND_MOVE(ScopedLatency);
+  ~ScopedLatency() { histogram_->Record(std::chrono::steady_clock::now() - start_); }
+
+ private:
+  LatencyHistogram *histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compress_util.h
+//
+// Identification: src/include/common/util/compress_util.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * CompressUtil compresses buffers in the LZ4 block format: a greedy, single-pass compressor that finds 4-byte matches
+ * within the last 64 KB through a small hash table, and a decompressor that is little more than memcpy. It trades
+ * ratio for speed, which is what a page read or write on the I/O path can afford.
+ */
+class CompressUtil {
+ public:
+  /** The largest input Compress() accepts; positions in the match table are 32 bits. */
+  static constexpr size_t MAX_INPUT_SIZE = INT32_MAX;
+
+  /**
+   * Compress `src` into `dst`.
+   * @param src the input
+   * @param size the size of the input, at most MAX_INPUT_SIZE
+   * @param[out] dst the output buffer
+   * @param capacity the size of the output buffer
+   * @return the size of the compressed data, or 0 if it does not fit into `capacity` bytes
+   */
+  static auto Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t;
+
+  /**
+   * Decompress an LZ4 block. Malformed input is detected, never read or written out of bounds.
+   * @param src the compressed data
+   * @param size the size of the compressed data
+   * @param[out] dst the output buffer
+   * @param capacity the size of the output buffer
+   * @return the size of the decompressed data, or -1 if the input is malformed or does not fit into `capacity` bytes
+   */
+  static auto Decompress(const char *src, size_t size, char *dst, size_t capacity) -> int64_t;
+};
+
+}  // namespace bustub
@@ -0,0 +1,191 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter.h
+//
+// Identification: src/include/common/util/external_sorter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/exception.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ExternalSorter sorts more items than fit in its memory budget. Items are collected in memory until the budget is
+ * used up, then sorted and spilled to a temporary file as a sorted run. Once all items are added, the runs are merged
+ * on the fly as the items are read back in order; a sort that never spilled is served straight from memory.
+ *
+ * The items are written to the runs byte by byte, so they must be trivially copyable.
+ */
+template <typename T, typename Compare = std::less<T>>
+class ExternalSorter {
+  static_assert(std::is_trivially_copyable<T>::value, "spilled items are copied byte by byte");
+
+ public:
+  /**
+   * Creates a new sorter.
+   * @param compare the strict weak order to sort by
+   * @param memory_budget the most bytes of items held in memory, for collecting as well as for merging
+   */
+  explicit ExternalSorter(Compare compare = Compare(), size_t memory_budget = EXTERNAL_SORT_MEMORY)
+      : compare_(std::move(compare)), max_buffered_(std::max<size_t>(memory_budget / sizeof(T), 1)) {}
+
+  ~ExternalSorter() {
+    for (auto &run : runs_) {
+      fclose(run.file_);
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(ExternalSorter);
+
+  /**
+   * Add an item. Not allowed after Sort().
+   * @param item the item
+   */
+  void Add(const T &item) {
+    BUSTUB_ASSERT(!sorted_, "items added after Sort()");
+    buffer_.push_back(item);
+    size_++;
+    if (buffer_.size() >= max_buffered_) {
+      SpillRun();
+    }
+  }
+
+  /**
+   * Sort the added items, after which Next() returns them in order.
+   */
+  void Sort() {
+    BUSTUB_ASSERT(!sorted_, "Sort() called twice");
+    sorted_ = true;
+    if (runs_.empty()) {
+      std::sort(buffer_.begin(), buffer_.end(), compare_);
+      return;
+    }
+    SpillRun();
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    // The budget is split between the read buffers of the runs.
+    const size_t run_buffer_size = std::max<size_t>(max_buffered_ / runs_.size(), 1);
+    for (size_t i = 0; i < runs_.size(); i++) {
+      runs_[i].buffer_.resize(run_buffer_size);
+      rewind(runs_[i].file_);
+      if (Refill(&runs_[i])) {
+        heap_.push(i);
+      }
+    }
+  }
+
+  /**
+   * Get the next item in sorted order.
+   * @param[out] item the item
+   * @return false if all items were returned already
+   */
+  auto Next(T *item) -> bool {
+    BUSTUB_ASSERT(sorted_, "Next() called before Sort()");
+    if (runs_.empty()) {
+      if (next_ == buffer_.size()) {
+        return false;
+      }
+      *item = buffer_[next_++];
+      return true;
+    }
+    if (heap_.empty()) {
+      return false;
+    }
+    const size_t i = heap_.top();
+    heap_.pop();
+    auto &run = runs_[i];
+    *item = run.buffer_[run.pos_++];
+    if (run.pos_ < run.size_ || Refill(&run)) {
+      heap_.push(i);
+    }
+    return true;
+  }
+
+  /** @return the number of items added */
+  auto GetSize() const -> size_t { return size_; }
+
+  /** @return the number of sorted runs spilled to disk, 0 if the items fit in memory */
+  auto GetNumRuns() const -> size_t { return runs_.size(); }
+
+ private:
+  /** A sorted run in a temporary file, and the part of it read back into memory. */
+  struct Run {
+    FILE *file_;
+    std::vector<T> buffer_;
+    size_t pos_{0};
+    size_t size_{0};
+  };
+
+  /** Orders runs by their current item, smallest on top of the heap. */
+  struct RunGreater {
+    const ExternalSorter *sorter_;
+    auto operator()(size_t a, size_t b) const -> bool {
+      const auto &run_a = sorter_->runs_[a];
+      const auto &run_b = sorter_->runs_[b];
+      return sorter_->compare_(run_b.buffer_[run_b.pos_], run_a.buffer_[run_a.pos_]);
+    }
+  };
+
+  /**
+   * Sort the buffered items and write them to a new run.
+   */
+  void SpillRun() {
+    if (buffer_.empty()) {
+      return;
+    }
+    std::sort(buffer_.begin(), buffer_.end(), compare_);
+    FILE *file = tmpfile();
+    if (file == nullptr) {
+      throw Exception("can't create a temporary file for an external sort");
+    }
+    runs_.push_back({file, {}, 0, 0});
+    if (fwrite(buffer_.data(), sizeof(T), buffer_.size(), file) != buffer_.size()) {
+      throw Exception("can't write a sorted run of an external sort");
+    }
+    buffer_.clear();
+  }
+
+  /**
+   * Read the next items of a run into its buffer.
+   * @return false if the run is exhausted
+   */
+  auto Refill(Run *run) -> bool {
+    run->size_ = fread(run->buffer_.data(), sizeof(T), run->buffer_.size(), run->file_);
+    run->pos_ = 0;
+    if (run->size_ == 0 && ferror(run->file_) != 0) {
+      throw Exception("can't read a sorted run of an external sort");
+    }
+    return run->size_ > 0;
+  }
+
+  Compare compare_;
+  const size_t max_buffered_;
+  /** The items not spilled yet, or all of them if nothing was spilled. */
+  std::vector<T> buffer_;
+  size_t size_{0};
+  bool sorted_{false};
+  /** Position of the next item in buffer_, when nothing was spilled. */
+  size_t next_{0};
+  std::vector<Run> runs_;
+  /** The runs that still have items, by their current item. */
+  std::priority_queue<size_t, std::vector<size_t>, RunGreater> heap_{RunGreater{this}};
+};
+
+}  // namespace bustub
@@ -12,32 +12,58 @@
 
 #pragma once
 
+#include <sys/types.h>
+
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
+#include "common/stats.h"
+#include "storage/disk/free_page_map.h"
 
 namespace bustub {
 
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Pages are read and written with positional I/O (pread/pwrite) on a plain file descriptor. There is no shared file
+ * offset, so concurrent page reads and writes run in parallel without any lock.
+ *
+ * Deallocated pages are tracked in a FreePageMap, which is kept in a ".fsm" file next to the database file, so that
+ * their space is reused across restarts.
  */
 class DiskManager {
  public:
+  /** A snapshot of the I/O latencies of a disk manager, see GetStats(). */
+  struct DiskStats {
+    HistogramSnapshot reads_;
+    HistogramSnapshot writes_;
+  };
+
+  /** A page to read or write as part of a batch. */
+  struct PageIo {
+    page_id_t page_id_;
+    /** The page buffer to write from or read into. */
+    char *data_;
+  };
+
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io true to open the database file with O_DIRECT, bypassing the OS page cache. Falls back to
+   * buffered I/O if the file system does not support it.
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool direct_io = false);
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -58,6 +84,50 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Write several pages to the database file. Subclasses may submit the writes together; by default they are written
+   * one after the other.
+   * @param pages the pages to write
+   */
+  virtual void WritePages(const std::vector<PageIo> &pages);
+
+  /**
+   * Read several pages from the database file. Subclasses may submit the reads together; by default they are read one
+   * after the other.
+   * @param pages the pages to read
+   */
+  virtual void ReadPages(const std::vector<PageIo> &pages);
+
+  /**
+   * Give a page back to the database file, so that its space is reused by a later allocation.
+   * @param page_id the page to deallocate
+   */
+  virtual void DeallocatePage(page_id_t page_id);
+
+  /**
+   * Reuse the lowest deallocated page whose id is below `limit` and congruent to `offset` modulo `stride`.
+   * @param limit the first page id that was never allocated
+   * @param stride the number of buffer pool instances sharing the file
+   * @param offset the index of the buffer pool instance
+   * @return the reused page id, or INVALID_PAGE_ID if there is none
+   */
+  auto AllocateFreePage(page_id_t limit, page_id_t stride, page_id_t offset) -> page_id_t;
+
+  /**
+   * Record that a page is in use, in case it was deallocated by an earlier run that allocated further than this one.
+   * @param page_id the newly allocated page
+   */
+  void MarkPageAllocated(page_id_t page_id);
+
+  /** @return the number of deallocated pages waiting to be reused */
+  auto GetNumFreePages() -> size_t { return free_page_map_.Size(); }
+
+  /**
+   * Write the changed parts of the free page map to disk. Called by ShutDown() and by the buffer pool checkpoints.
+   * Subclasses that keep more metadata next to the database file persist it here as well.
+   */
+  virtual void FlushFreePageMap();
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -83,6 +153,12 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /** @return the latencies of the page reads and writes so far */
+  auto GetStats() const -> DiskStats { return {read_latency_.Snapshot(), write_latency_.Snapshot()}; }
+
+  /** @return true if the database file bypasses the OS page cache */
+  auto IsDirectIo() const -> bool { return direct_io_; }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -93,19 +169,38 @@ class DiskManager {
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
  protected:
+  /** pread() until `size` bytes are read or the end of the file is reached. @return the bytes read, or -1 on error */
+  static auto ReadFully(int fd, char *buf, size_t size, off_t offset) -> ssize_t;
+  /** pwrite() all `size` bytes. @return false on error */
+  static auto WriteFully(int fd, const char *buf, size_t size, off_t offset) -> bool;
   auto GetFileSize(const std::string &file_name) -> int;
+  /** Record that the db file now extends at least to `end` bytes. */
+  void ExtendFileSize(int64_t end);
+  /** Load the free page map of an existing database file. */
+  void LoadFreePageMap();
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // descriptor of the db file, only used with positional I/O
+  int db_fd_{-1};
   std::string file_name_;
+  // size of the db file, maintained by WritePage() so that reads need not stat() the file
+  std::atomic<int64_t> db_file_size_{0};
+  // true if db_fd_ was opened with O_DIRECT
+  bool direct_io_{false};
+  // deallocated pages, persisted in fsm_name_
+  FreePageMap free_page_map_;
+  std::string fsm_name_;
+  // descriptor of the free page map file, opened when the map is first flushed
+  int fsm_fd_{-1};
+  std::mutex fsm_latch_;
+  // latencies of the page reads and writes
+  LatencyHistogram read_latency_;
+  LatencyHistogram write_latency_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
-  // With multiple buffer pool instances, need to protect file access
-  std::mutex db_io_latch_;
 };
 
 }  // namespace bustub
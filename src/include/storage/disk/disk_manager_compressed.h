@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.h
+//
+// Identification: src/include/storage/disk/disk_manager_compressed.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerCompressed is a DiskManager that compresses every page it writes with CompressUtil (LZ4 block format).
+ * The buffer pool still reads and writes whole BUSTUB_PAGE_SIZE pages; only the database file holds less.
+ *
+ * The database file is divided into slots of COMPRESSED_SLOT_SIZE bytes, and a page is stored in an extent of
+ * consecutive slots. A page map from page id to extent is kept in a ".map" file next to the database file. A page
+ * that does not compress by at least one slot is stored as is.
+ *
+ * A page is never overwritten in place: each write goes to a new extent, and the old extent is only reused once the
+ * page map no longer points to it on disk, i.e. after the next FlushFreePageMap(). That flush syncs the database file
+ * before it writes the map, and syncs the map before it reuses any extent, so a page map on disk always refers to
+ * complete page images.
+ */
+class DiskManagerCompressed : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that writes compressed pages to the specified database file.
+   * @param db_file the file name of the database file to write to
+   */
+  explicit DiskManagerCompressed(const std::string &db_file);
+
+  ~DiskManagerCompressed() override;
+
+  /**
+   * Compress a page and write it to a new extent of the database file.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page and decompress it. A page that was never written reads as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Deallocate a page and release its extent.
+   * @param page_id the page to deallocate
+   */
+  void DeallocatePage(page_id_t page_id) override;
+
+  /** Write the changed parts of the page map and of the free page map to disk. */
+  void FlushFreePageMap() override;
+
+  /** @return the number of bytes the stored pages take in the database file, without the unused tails of slots */
+  auto GetStoredBytes() -> size_t;
+
+  /** @return the number of slots in the database file, used or not */
+  auto GetNumSlots() -> size_t;
+
+ private:
+  /** The place of a page in the database file, as it is stored in the page map file. */
+  struct Extent {
+    uint32_t first_slot_;
+    /** The size of the stored page: 0 if the page is not stored, BUSTUB_PAGE_SIZE if it is not compressed. */
+    uint32_t size_;
+  };
+  static_assert(sizeof(Extent) == 8, "the page map file stores 8-byte extents");
+
+  static constexpr size_t EXTENTS_PER_MAP_PAGE = BUSTUB_PAGE_SIZE / sizeof(Extent);
+  /** Released slots waiting for a page map flush, beyond which WritePage() flushes the page map itself. */
+  static constexpr size_t MAX_PENDING_SLOTS = 4096;
+
+  /** @return the number of slots a stored page of `size` bytes takes */
+  static auto NumSlots(uint32_t size) -> uint32_t { return (size + COMPRESSED_SLOT_SIZE - 1) / COMPRESSED_SLOT_SIZE; }
+
+  /** Find `num_slots` free consecutive slots, growing the file if needed. Caller must hold the latch. */
+  auto AllocateSlots(uint32_t num_slots) -> uint32_t;
+
+  /** Put free slots back, merged with the free runs next to them. Caller must hold the latch. */
+  void AddFreeSlots(uint32_t first_slot, uint32_t num_slots);
+
+  /** Point a page at a new extent, releasing the old one once the page map is flushed. Caller must hold the latch. */
+  void SetExtent(page_id_t page_id, Extent extent);
+
+  /** Load the page map of an existing database file and rebuild the free runs from the unused slots. */
+  void LoadPageMap();
+
+  std::mutex map_latch_;
+  /** The page map, indexed by page id. */
+  std::vector<Extent> extents_;
+  /** The page map pages (EXTENTS_PER_MAP_PAGE extents each) that changed since the last flush. */
+  std::vector<bool> dirty_;
+  /** Runs of free slots, from their first slot to their number of slots. No two runs are adjacent. */
+  std::map<uint32_t, uint32_t> free_slots_;
+  /** The same runs, ordered by their number of slots and then by their first slot. */
+  std::set<std::pair<uint32_t, uint32_t>> free_slots_by_size_;
+  /** Extents released since the last page map flush; the page map on disk may still point to them. */
+  std::vector<Extent> pending_free_;
+  size_t num_pending_slots_{0};
+  /** The number of slots in the database file. */
+  uint32_t num_slots_{0};
+  size_t stored_bytes_{0};
+  std::string map_name_;
+  int map_fd_{-1};
+};
+
+}  // namespace bustub
@@ -9,6 +9,9 @@
 // Copyright (c) 2015-2020, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+
+#pragma once
+
 #include <array>
 #include <cstring>
 #include <fstream>
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_simulated.h
+//
+// Identification: src/include/storage/disk/disk_manager_simulated.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/**
+ * The performance characteristics of a simulated storage device, see DiskManagerSimulated.
+ */
+struct DiskProfile {
+  /**
+   * Median and 99th percentile of the time the device takes to serve one page read. The latencies are drawn from the
+   * log-normal distribution with these percentiles; equal percentiles give a constant latency.
+   */
+  std::chrono::microseconds read_p50_{0};
+  std::chrono::microseconds read_p99_{0};
+  /** Median and 99th percentile of the time the device takes to serve one page write. */
+  std::chrono::microseconds write_p50_{0};
+  std::chrono::microseconds write_p99_{0};
+  /** The most page reads and writes the device serves per second, 0 for no limit. */
+  uint64_t max_iops_{0};
+  /** The most bytes the device reads and writes per second, 0 for no limit. */
+  uint64_t max_bytes_per_second_{0};
+
+  /**
+   * Look up a predefined profile: "ram" (no delay at all), "nvme", "slow-ssd", or "cloud" (a network block store
+   * with a provisioned IOPS and throughput budget). Throws an Exception for any other name.
+   * @param name the name of the profile
+   * @return the profile
+   */
+  static auto FromName(const std::string &name) -> DiskProfile;
+};
+
+/**
+ * DiskManagerSimulated keeps the pages in memory like DiskManagerUnlimitedMemory, but makes every page I/O take as
+ * long as it would on the device described by a DiskProfile, so that buffer pool policies can be benchmarked against
+ * a given kind of storage on any machine.
+ *
+ * An I/O first waits for the device to have room for it under its IOPS and bandwidth caps, which are shared by all
+ * threads, then for its own latency. The I/Os of one ReadPages() or WritePages() batch are submitted together, so
+ * their latencies overlap like on a device with a deep queue. Latencies below the resolution of the OS timer are
+ * waited for by spinning.
+ */
+class DiskManagerSimulated : public DiskManagerUnlimitedMemory {
+ public:
+  /**
+   * Creates a new simulated device.
+   * @param profile the performance characteristics of the device
+   * @param seed the seed of the latency draws, for reproducible runs
+   */
+  explicit DiskManagerSimulated(const DiskProfile &profile, uint64_t seed = 0);
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void WritePages(const std::vector<PageIo> &pages) override;
+
+  void ReadPages(const std::vector<PageIo> &pages) override;
+
+  /** @return the performance characteristics of the device */
+  auto GetProfile() const -> const DiskProfile & { return profile_; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Reserve the device for `num_ios` page I/Os and draw their latencies.
+   * @return the time the last of the I/Os completes
+   */
+  auto Submit(size_t num_ios, bool is_write) -> Clock::time_point;
+
+  /** Draw one latency from the log-normal distribution with median `p50` and 99th percentile `p99`. */
+  auto DrawLatency(std::chrono::microseconds p50, std::chrono::microseconds p99) -> Clock::duration;
+
+  /** Wait until `deadline`, sleeping while it is far away and spinning the last stretch. */
+  static void WaitUntil(Clock::time_point deadline);
+
+  const DiskProfile profile_;
+  /** Protects the fields below. */
+  std::mutex device_latch_;
+  std::mt19937_64 rng_;
+  std::normal_distribution<double> normal_{0.0, 1.0};
+  /** The earliest time the device may start another I/O without exceeding its IOPS and bandwidth caps. */
+  Clock::time_point next_start_{};
+};
+
+}  // namespace bustub
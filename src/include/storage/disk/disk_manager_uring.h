@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.h
+//
+// Identification: src/include/storage/disk/disk_manager_uring.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerUring is a DiskManager that submits batches of page reads and writes through io_uring, so that a single
+ * thread keeps many requests in flight: flushing N dirty pages or reading N prefetched pages costs one system call
+ * instead of N blocking ones. Single-page ReadPage() and WritePage() keep using pread/pwrite, which lets concurrent
+ * callers run in parallel without sharing the ring.
+ *
+ * If the kernel does not support io_uring (or it is disabled), every batch falls back to the synchronous path of
+ * DiskManager, so this class can be used wherever a DiskManager is expected.
+ */
+class DiskManagerUring : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param direct_io true to open the database file with O_DIRECT
+   * @param queue_depth the number of requests that can be in flight at once; larger batches are submitted in chunks
+   */
+  explicit DiskManagerUring(const std::string &db_file, bool direct_io = false,
+                            uint32_t queue_depth = IO_URING_QUEUE_DEPTH);
+
+  ~DiskManagerUring() override;
+
+  /**
+   * Write several pages with a single submission per `queue_depth` pages.
+   * @param pages the pages to write
+   */
+  void WritePages(const std::vector<PageIo> &pages) override;
+
+  /**
+   * Read several pages with a single submission per `queue_depth` pages.
+   * @param pages the pages to read
+   */
+  void ReadPages(const std::vector<PageIo> &pages) override;
+
+  /** @return true if batches go through io_uring, false if they fall back to synchronous I/O */
+  auto IsUringAvailable() -> bool;
+
+  /** @return the number of io_uring submissions made so far */
+  auto GetNumSubmissions() const -> int { return num_submissions_; }
+
+ private:
+  /** The mapped submission and completion queues. */
+  struct Ring;
+
+  /**
+   * Submit `pages` through the ring and wait for them to complete.
+   * @param pages the pages to read or write
+   * @param is_write true to write the pages, false to read them
+   * @return the indexes, in order and each once, of the pages the ring did not complete, to be retried synchronously
+   */
+  auto SubmitAndWait(const std::vector<PageIo> &pages, bool is_write) -> std::vector<size_t>;
+
+  /** Read or write a batch, through the ring if possible. */
+  void RunBatch(const std::vector<PageIo> &pages, bool is_write);
+
+  /** The ring has a single submitter at a time. */
+  std::mutex ring_latch_;
+  /** nullptr if io_uring is not available, or stopped working. */
+  std::unique_ptr<Ring> ring_;
+  std::atomic<int> num_submissions_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * A page read or write that the DiskScheduler runs in the background.
+ */
+struct DiskRequest {
+  /** True for a write, false for a read. */
+  bool is_write_{false};
+  /** The page buffer to write from or read into. It must stay valid until the callback has run. */
+  char *data_{nullptr};
+  /** The page to read or write. */
+  page_id_t page_id_{INVALID_PAGE_ID};
+  /** Called on the worker thread once the I/O is done. */
+  std::function<void()> callback_;
+};
+
+/**
+ * DiskScheduler runs page reads and writes on a small pool of background threads, so that callers can overlap disk
+ * I/O with their own work. A worker takes all the requests queued at once and hands them to the disk manager as one
+ * batch. Requests are started in the order they were scheduled, but may complete in any order.
+ */
+class DiskScheduler {
+ public:
+  /**
+   * Creates a new disk scheduler and starts its workers.
+   * @param disk_manager the disk manager that performs the I/O
+   * @param num_workers the number of background threads
+   */
+  DiskScheduler(DiskManager *disk_manager, size_t num_workers);
+
+  DISALLOW_COPY_AND_MOVE(DiskScheduler);
+
+  /**
+   * Runs every request that was already scheduled, then stops the workers.
+   */
+  ~DiskScheduler();
+
+  /**
+   * Queue a request for a background worker.
+   * @param request the I/O to perform
+   */
+  void Schedule(DiskRequest request);
+
+ private:
+  /** Worker loop: run requests until the scheduler shuts down and the queue is empty. */
+  void RunWorker();
+
+  DiskManager *disk_manager_;
+  /** Protects queue_ and shutdown_. */
+  std::mutex latch_;
+  /** Signalled when a request is queued or the scheduler shuts down. */
+  std::condition_variable cv_;
+  std::deque<DiskRequest> queue_;
+  bool shutdown_{false};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map.h
+//
+// Identification: src/include/storage/disk/free_page_map.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FreePageMap tracks the deallocated pages of a database file in a bitmap, one bit per page id, so that their space
+ * is reused by later allocations instead of growing the file.
+ *
+ * The bitmap is divided into bitmap pages of BUSTUB_PAGE_SIZE bytes. The map remembers which bitmap pages changed, so
+ * the owner (the DiskManager) persists only those.
+ */
+class FreePageMap {
+ public:
+  /** Number of page ids covered by one bitmap page. */
+  static constexpr page_id_t PAGES_PER_BITMAP_PAGE = BUSTUB_PAGE_SIZE * 8;
+
+  FreePageMap() = default;
+
+  DISALLOW_COPY_AND_MOVE(FreePageMap);
+
+  ~FreePageMap() = default;
+
+  /**
+   * @brief Mark a page as free. Freeing a free page has no effect.
+   * @param page_id the page to free
+   */
+  void Free(page_id_t page_id);
+
+  /**
+   * @brief Take the lowest free page whose id is below `limit` and congruent to `offset` modulo `stride`, so that
+   * each instance of a parallel buffer pool only reuses the page ids it owns.
+   * @param limit the page ids at or above limit are never returned
+   * @param stride the number of buffer pool instances
+   * @param offset the index of the buffer pool instance
+   * @return the page id, or INVALID_PAGE_ID if there is no such free page
+   */
+  auto Take(page_id_t limit, page_id_t stride, page_id_t offset) -> page_id_t;
+
+  /**
+   * @brief Mark a page as in use, e.g. when it is allocated past the end of the file but was freed in an earlier run.
+   * @param page_id the page in use
+   */
+  void Use(page_id_t page_id);
+
+  /** @return the number of free pages */
+  auto Size() -> size_t;
+
+  /** @return the number of bitmap pages needed to hold the map */
+  auto NumBitmapPages() -> size_t;
+
+  /**
+   * @brief Copy a bitmap page out of the map and mark it clean.
+   * @param index the bitmap page
+   * @param[out] data a buffer of BUSTUB_PAGE_SIZE bytes
+   */
+  void ReadBitmapPage(size_t index, char *data);
+
+  /**
+   * @brief Replace a bitmap page, e.g. when the map is loaded from disk. The page is not marked dirty.
+   * @param index the bitmap page
+   * @param data a buffer of BUSTUB_PAGE_SIZE bytes
+   */
+  void WriteBitmapPage(size_t index, const char *data);
+
+  /** @return the bitmap pages that changed since they were last read by ReadBitmapPage() */
+  auto DirtyBitmapPages() -> std::vector<size_t>;
+
+ private:
+  static constexpr size_t WORDS_PER_BITMAP_PAGE = BUSTUB_PAGE_SIZE / sizeof(uint64_t);
+
+  /** Grow the map so that it covers `page_id`. Caller must hold the latch. */
+  void Reserve(page_id_t page_id);
+
+  std::mutex latch_;
+  std::vector<uint64_t> words_;
+  std::vector<bool> dirty_;
+  size_t num_free_{0};
+};
+
+}  // namespace bustub
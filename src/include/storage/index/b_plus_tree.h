@@ -10,13 +10,19 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <optional>
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "common/util/external_sorter.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_key_format.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -29,6 +35,9 @@ enum class Operation {
   Delete
 };
 
+/** The leaf a descent ends at: the one a key belongs in, or either end of the tree. */
+enum class LeafPosition { Key, LeftMost, RightMost };
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
@@ -45,9 +54,44 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  // one entry of a bulk load, see BulkLoad()
+  struct BulkLoadEntry {
+    KeyType key_;
+    ValueType value_;
+  };
+
+  // orders the entries of a bulk load by key
+  struct BulkLoadEntryLess {
+    KeyComparator comparator_;
+    auto operator()(const BulkLoadEntry &a, const BulkLoadEntry &b) const -> bool {
+      return comparator_(a.key_, b.key_) < 0;
+    }
+  };
+
+  using BulkLoadSorter = ExternalSorter<BulkLoadEntry, BulkLoadEntryLess>;
+
+  // The max sizes are capped so that half a node of keys that do not compress at all still fits into a page.
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
                      int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
 
+  ~BPlusTree();
+
+  // Let searches swizzle the inner pages they pass: a swizzled page stays pinned, and the tree keeps a direct pointer
+  // to it next to its parent, so later searches reach it without going through the buffer pool. Leaves are never
+  // swizzled. At most max_swizzled_pages pages are swizzled; they are unswizzled and unpinned again when the buffer
+  // pool runs out of frames for the tree, or when they are deleted.
+  void EnableSwizzling(size_t max_swizzled_pages);
+
+  // Unpin all the swizzled pages. No operation may run on the tree concurrently.
+  void DisableSwizzling();
+
+  // return the number of swizzled pages
+  auto GetNumSwizzledPages() -> size_t;
+
+  // Let Insert() and Remove() descend like searches do, write latching only the leaf, and latch their way down from
+  // the root only if the leaf has to split or merge. On by default.
+  void SetOptimisticWrites(bool optimistic_writes) { optimistic_writes_ = optimistic_writes; }
+
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
@@ -57,12 +101,25 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  // Return a sorter to add the entries of a bulk load to, holding at most memory_budget bytes of them in memory.
+  auto NewBulkLoadSorter(size_t memory_budget = EXTERNAL_SORT_MEMORY) const -> std::unique_ptr<BulkLoadSorter>;
+
+  // Build the tree bottom-up out of all its entries at once, instead of inserting them one by one: the entries are
+  // sorted, packed into leaves filled to fill_factor of their capacity, and each inner level is packed the same way
+  // over the level below. Of entries with equal keys only one is kept, like Insert() would. The tree must be empty,
+  // and no other operation may run on it concurrently.
+  void BulkLoad(BulkLoadSorter *entries, double fill_factor = BULK_LOAD_FILL_FACTOR);
+
   // return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
 
   // return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
+  // return the most entries of a leaf, and the most children of an inner node
+  auto GetLeafMaxSize() const -> int { return leaf_max_size_; }
+  auto GetInternalMaxSize() const -> int { return internal_max_size_; }
+
   // index iterator
   auto Begin() -> INDEXITERATOR_TYPE;
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -90,28 +147,63 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // changed under root_latch_ or the write latch of the old root, read without latches by the optimistic searches
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
+  // how the pages of the tree store its keys
+  KeyFormat key_format_;
   int leaf_max_size_;
   int internal_max_size_;
 
   std::mutex root_latch_;
-
-  auto FindLeafNode(const KeyType &key, Operation op, Transaction *txn, bool left_most=true) -> std::pair<Page*, LeafPage*>;
+  // a search gives up on optimistic reads after this many failed descents and latches its way down instead
+  static constexpr int OPTIMISTIC_SEARCH_ATTEMPTS = 3;
+  // see SetOptimisticWrites()
+  std::atomic<bool> optimistic_writes_{true};
+
+  // a swizzled page, holding one pin, and the references to its swizzled children, one per slot of the page
+  struct SwizzledPage {
+    std::atomic<Page *> page_{nullptr};
+    std::unique_ptr<std::atomic<SwizzledPage *>[]> children_;
+  };
+
+  // swizzling, see EnableSwizzling()
+  std::atomic<bool> swizzling_{false};
+  size_t max_swizzled_pages_{0};
+  // the root, if it is swizzled
+  std::atomic<SwizzledPage *> root_swip_{nullptr};
+  // the swizzled pages
+  std::unordered_map<page_id_t, SwizzledPage *> swizzled_pages_;
+  // A search may still read the entry of a page after it is unswizzled, so the entries are only reused, and freed by
+  // DisableSwizzling().
+  std::vector<std::unique_ptr<SwizzledPage>> swizzled_page_entries_;
+  std::vector<SwizzledPage *> free_swizzled_pages_;
+  std::atomic<size_t> num_swizzled_pages_{0};
+  std::mutex swizzle_latch_;
+
+  auto FindLeafNode(const KeyType &key, Operation op, Transaction *txn, LeafPosition position = LeafPosition::Key)
+      -> std::pair<Page *, LeafPage *>;
+  auto FindLeafNodeOptimistic(const KeyType &key, LeafPosition position, Operation op) -> Page *;
+  auto InsertOptimistic(const KeyType &key, const ValueType &value) -> std::optional<bool>;
+  auto RemoveOptimistic(const KeyType &key) -> bool;
+  auto Swizzle(Page *page, std::atomic<SwizzledPage *> *swip) -> SwizzledPage *;
+  auto DetachSwizzledPage(typename std::unordered_map<page_id_t, SwizzledPage *>::iterator it) -> Page *;
+  void Unswizzle(page_id_t page_id);
+  auto UnswizzleVictim() -> bool;
+  auto FetchPage(page_id_t page_id) -> Page *;
+  auto NewPage(page_id_t *page_id) -> Page *;
   template <typename NodeType>
   auto NewNode() -> NodeType *;
-  template <typename NodeType>
-  auto CopyToMemory(NodeType *node) -> NodeType *;
   void InsertInParent(BPlusTreePage *n, const KeyType &k_new, BPlusTreePage *n_new);
   void NewRoot(const KeyType &key, const ValueType &value);
-  template <typename NodeType>
-  void SplitNodes(NodeType &n, NodeType &n_new);
-  void CoalesceNodes(bool exist_left_sibling, BPlusTreePage *n, BPlusTreePage *sibling_page, const KeyType &parent_key);
-  void DeleteEntry(BPlusTreePage *current, const KeyType &key);
-  void RedistributeNodes(bool exist_left_sibling, BPlusTreePage *n, BPlusTreePage *sibling_page,
-                         InternalPage *parent_page, KeyType parent_key, int parent_idx);
-  void UnlockAndUnpinTxn(Transaction *txn) const;
+  auto CoalesceNodes(BPlusTreePage *left, BPlusTreePage *right, const KeyType &parent_key) -> bool;
+  void DeleteEntry(BPlusTreePage *current, int index, Transaction *txn);
+  void RedistributeNodes(BPlusTreePage *left, BPlusTreePage *right, bool from_left, InternalPage *parent,
+                         int right_idx);
+  static auto NextBulkLoadNodeSize(size_t pending, bool more, size_t fill, size_t max_items) -> size_t;
+  void SetParentPageId(page_id_t page_id, page_id_t parent_page_id);
+  void UnlockAndUnpinTxn(Transaction *txn, bool is_dirty = false) const;
   auto UnlockAndUnpinPage(Page *page, bool is_dirty) const -> void;
   bool IsSafe(BPlusTreePage *page, Operation &op);
 };
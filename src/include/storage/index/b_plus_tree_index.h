@@ -35,6 +35,17 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * Add an entry to the bulk load of an empty index. The entries are only sorted and put into the index by
+   * FinishBulkLoad(), which is far faster than inserting them one by one.
+   */
+  void AddBulkLoadEntry(const Tuple &key, RID rid);
+
+  /**
+   * Build the index out of the entries added by AddBulkLoadEntry(), see BPlusTree::BulkLoad().
+   */
+  void FinishBulkLoad();
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -46,6 +57,8 @@ class BPlusTreeIndex : public Index {
   KeyComparator comparator_;
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
+  // the entries of a bulk load in progress
+  std::unique_ptr<typename BPlusTree<KeyType, ValueType, KeyComparator>::BulkLoadSorter> bulk_load_;
 };
 
 /** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
@@ -72,11 +72,26 @@ class GenericKey {
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Keys made of fixed-width integer columns only are compared without going through Value: the comparator is compiled
+ * from the key schema once, into the offset and width of each column, and compares the integers where they lie in the
+ * key. A key of one integer column thus costs two loads and a compare. Any other key schema falls back to comparing
+ * the deserialized Values column by column.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    if (num_compiled_columns_ > 0) {
+      for (uint32_t i = 0; i < num_compiled_columns_; i++) {
+        const int cmp = CompareIntegerColumn(compiled_columns_[i], lhs.data_, rhs.data_);
+        if (cmp != 0) {
+          return cmp;
+        }
+      }
+      return 0;
+    }
+
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
@@ -94,13 +109,84 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other) = default;
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) { Compile(); }
+
+  /** @return true if the keys are compared as integers, without deserializing them */
+  auto IsCompiled() const -> bool { return num_compiled_columns_ > 0; }
+
+  /** The most key columns compiled into a comparator, wider keys are compared through Value. */
+  static constexpr uint32_t MAX_COMPILED_COLUMNS = 8;
+
+  /** Where an integer column lies in the key. */
+  struct CompiledColumn {
+    uint32_t offset_;
+    TypeId type_;
+  };
+
+  /** @return the number of key columns compared as integers, 0 if the comparator is not compiled */
+  auto GetNumCompiledColumns() const -> uint32_t { return num_compiled_columns_; }
+
+  /** @return the i-th key column compared as an integer */
+  auto GetCompiledColumn(uint32_t i) const -> const CompiledColumn & { return compiled_columns_[i]; }
 
  private:
+  void Compile() {
+    const uint32_t column_count = key_schema_->GetColumnCount();
+    if (column_count == 0 || column_count > MAX_COMPILED_COLUMNS) {
+      return;
+    }
+    for (uint32_t i = 0; i < column_count; i++) {
+      const auto &column = key_schema_->GetColumn(i);
+      switch (column.GetType()) {
+        case TypeId::TINYINT:
+        case TypeId::SMALLINT:
+        case TypeId::INTEGER:
+        case TypeId::BIGINT:
+          if (column.GetOffset() + column.GetFixedLength() > KeySize) {
+            return;
+          }
+          compiled_columns_[i] = {column.GetOffset(), column.GetType()};
+          break;
+        default:
+          return;
+      }
+    }
+    num_compiled_columns_ = column_count;
+  }
+
+  template <typename T>
+  static inline auto CompareInteger(const char *lhs, const char *rhs) -> int {
+    T lhs_value;
+    T rhs_value;
+    memcpy(&lhs_value, lhs, sizeof(T));
+    memcpy(&rhs_value, rhs, sizeof(T));
+    return static_cast<int>(lhs_value > rhs_value) - static_cast<int>(lhs_value < rhs_value);
+  }
+
+  // A NULL is stored as the smallest value of its type, so it sorts before every other value instead of comparing
+  // equal to all of them.
+  static inline auto CompareIntegerColumn(const CompiledColumn &column, const char *lhs, const char *rhs) -> int {
+    lhs += column.offset_;
+    rhs += column.offset_;
+    switch (column.type_) {
+      case TypeId::TINYINT:
+        return CompareInteger<int8_t>(lhs, rhs);
+      case TypeId::SMALLINT:
+        return CompareInteger<int16_t>(lhs, rhs);
+      case TypeId::INTEGER:
+        return CompareInteger<int32_t>(lhs, rhs);
+      default:
+        return CompareInteger<int64_t>(lhs, rhs);
+    }
+  }
+
   Schema *key_schema_;
+  // the key columns, if they are all integers
+  CompiledColumn compiled_columns_[MAX_COMPILED_COLUMNS]{};
+  uint32_t num_compiled_columns_{0};
 };
 
 }  // namespace bustub
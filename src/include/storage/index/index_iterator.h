@@ -43,10 +43,15 @@ class IndexIterator {
   }
 
  private:
+  /** Start reading the leaf after the current one in the background. */
+  void ReadAhead();
+
   // add your own private member variables here
   LeafPage *current_page_{};
   int arr_idx_{0};
   BufferPoolManager *buffer_pool_manager_;
+  // the entry last dereferenced, decoded from the compressed keys of the leaf
+  MappingType entry_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,306 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_compressed_entries.h
+//
+// Identification: src/include/storage/page/b_plus_tree_compressed_entries.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/page/b_plus_tree_key_format.h"
+#include "storage/page/b_plus_tree_key_search.h"
+
+namespace bustub {
+
+/**
+ * The entries of a B+ tree page, with their keys compressed.
+ *
+ * Keys are stored encoded (see KeyFormat). The bytes all encoded keys of the page start with, their common prefix,
+ * are stored once, and of each key only the next SuffixSize bytes are stored: whatever follows them in the encoded
+ * key is zeros. All entries thus take the same number of bytes, and are found by their index alone:
+ *  ---------------------------------------------------------------------------------------------------------------
+ * | Format (19) | Padding (1) | PrefixSize (2) | SuffixSize (2) | PREFIX | SUFFIX(1) + VALUE(1) | SUFFIX(2) + ...
+ *  ---------------------------------------------------------------------------------------------------------------
+ * A key that does not start with the prefix, or does not end in zeros where the suffixes end, widens the prefix and
+ * suffix of the page, and all its entries are written again; so does replacing all entries, which picks the shortest
+ * prefix and suffix for them.
+ *
+ * The object is the last member of a page, its entries extend past its end, up to Capacity bytes of prefix and entries.
+ * The page keeps KEY_SEARCH_SLACK more bytes behind them for the in-place search. The number of entries is kept by the
+ * page, and passed to each method.
+ */
+template <typename KeyType, typename ValueType, size_t Capacity>
+class CompressedEntries {
+  static_assert(std::is_trivially_copyable_v<KeyType> && std::is_trivially_copyable_v<ValueType>,
+                "compressed entries are copied as bytes");
+
+ public:
+  using Entry = std::pair<KeyType, ValueType>;
+
+  /** The bytes in front of the prefix. */
+  static constexpr size_t HEADER_SIZE = 24;
+
+  /** @return the number of entries that fit in, however badly their keys compress */
+  static auto GetCapacity(const KeyFormat &format) -> int {
+    return static_cast<int>(Capacity / (format.GetEncodedSize() + sizeof(ValueType)));
+  }
+
+  void Init(const KeyFormat &format) {
+    static_assert(offsetof(CompressedEntries, data_) == HEADER_SIZE, "unexpected compressed entries layout");
+    format_ = format;
+    prefix_size_ = 0;
+    suffix_size_ = 0;
+  }
+
+  auto KeyAt(int index) const -> KeyType { return DecodeKey(prefix_size_, suffix_size_, index); }
+
+  auto ValueAt(int index) const -> ValueType {
+    ValueType value{};
+    // A search may read a page while a writer changes it, and ask for an entry past the end, see
+    // BPlusTree::FindLeafNodeOptimistic(); it only gets a value that it throws away after validating the page.
+    const size_t offset = prefix_size_ + index * Stride() + suffix_size_;
+    if (offset + sizeof(ValueType) <= Capacity) {
+      memcpy(&value, data_ + offset, sizeof(ValueType));
+    }
+    return value;
+  }
+
+  void SetValueAt(int index, const ValueType &value) {
+    memcpy(EntryAt(index) + suffix_size_, &value, sizeof(ValueType));
+  }
+
+  /** @return the n entries, decoded */
+  auto GetEntries(int n) const -> std::vector<Entry> {
+    std::vector<Entry> entries;
+    entries.reserve(n + 1);
+    for (int i = 0; i < n; i++) {
+      entries.emplace_back(KeyAt(i), ValueAt(i));
+    }
+    return entries;
+  }
+
+  /**
+   * Search the n entries. Normalized keys are compared in place, with CountSuffixesBelow(), unless simd_key_search is
+   * off; other keys are decoded and compared by the comparator.
+   * @return the number of entries with a key less than key, or not greater than key if or_equal
+   */
+  template <typename KeyComparator>
+  auto CountBelow(int n, const KeyType &key, const KeyComparator &comparator, bool or_equal) const -> int {
+    const uint32_t prefix_size = prefix_size_;
+    const uint32_t suffix_size = suffix_size_;
+    const uint32_t encoded_size = format_.GetEncodedSize();
+    // A page torn by a writer gets a search nowhere out of it, see ValueAt().
+    if (n <= 0 || prefix_size + suffix_size > encoded_size ||
+        prefix_size + n * Stride(suffix_size) > Capacity) {
+      return 0;
+    }
+
+    if (!format_.IsNormalized() || !simd_key_search.load(std::memory_order_relaxed)) {
+      int lo = 0;
+      int hi = n;
+      while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        const int cmp = comparator(DecodeKey(prefix_size, suffix_size, mid), key);
+        if (cmp < 0 || (or_equal && cmp == 0)) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      return lo;
+    }
+
+    char target[sizeof(KeyType) + KEY_SEARCH_SLACK]{};
+    format_.Encode(reinterpret_cast<const char *>(&key), target);
+    const int cmp = memcmp(target, data_, prefix_size);
+    if (cmp != 0) {
+      return cmp < 0 ? 0 : n;
+    }
+    // The keys end in zeros after their suffix, key is greater than all those it equals up to there if it does not.
+    for (uint32_t i = prefix_size + suffix_size; i < encoded_size && !or_equal; i++) {
+      or_equal = target[i] != 0;
+    }
+    return CountSuffixesBelow(data_ + prefix_size, Stride(suffix_size), suffix_size, n, target + prefix_size,
+                              or_equal);
+  }
+
+  /** @return true if count entries fit in, with key among them */
+  auto HasRoomFor(int count, const KeyType &key) const -> bool {
+    char encoded[sizeof(KeyType)];
+    format_.Encode(reinterpret_cast<const char *>(&key), encoded);
+    uint32_t prefix_size = 0;
+    while (prefix_size < prefix_size_ && encoded[prefix_size] == data_[prefix_size]) {
+      prefix_size++;
+    }
+    const uint32_t end = std::max<uint32_t>(prefix_size_ + suffix_size_, format_.SignificantSize(encoded));
+    return SizeOf(prefix_size, end - prefix_size, count) <= Capacity;
+  }
+
+  /** @return true if count entries fit in, whatever their keys */
+  auto HasRoomForAnyKeys(int count) const -> bool {
+    return SizeOf(0, format_.GetEncodedSize(), count) <= Capacity;
+  }
+
+  /** @return true if the n entries fit in */
+  auto CanHold(const Entry *entries, int n) const -> bool {
+    const auto [prefix_size, suffix_size] = Measure(entries, n);
+    return SizeOf(prefix_size, suffix_size, n) <= Capacity;
+  }
+
+  /** @return how many of the n entries, from the first on, fit into fill of the capacity */
+  auto CountFitting(const Entry *entries, int n, double fill) const -> int {
+    const auto budget = static_cast<size_t>(Capacity * std::clamp(fill, 0.0, 1.0));
+    char first[sizeof(KeyType)];
+    char encoded[sizeof(KeyType)];
+    uint32_t prefix_size = format_.GetEncodedSize();
+    uint32_t end = 0;
+    for (int i = 0; i < n; i++) {
+      format_.Encode(reinterpret_cast<const char *>(&entries[i].first), i == 0 ? first : encoded);
+      if (i > 0) {
+        prefix_size = CommonPrefix(first, encoded, prefix_size);
+      }
+      end = std::max(end, format_.SignificantSize(i == 0 ? first : encoded));
+      if (SizeOf(prefix_size, end > prefix_size ? end - prefix_size : 0, i + 1) > budget) {
+        return i;
+      }
+    }
+    return n;
+  }
+
+  /** @return the bytes taken by the n entries */
+  auto GetUsedSize(int n) const -> size_t { return SizeOf(prefix_size_, suffix_size_, n); }
+
+  /** Insert an entry at index of the n entries. There must be room for it, see HasRoomFor(). */
+  void Insert(int n, int index, const KeyType &key, const ValueType &value) {
+    char encoded[sizeof(KeyType)];
+    format_.Encode(reinterpret_cast<const char *>(&key), encoded);
+    if (n == 0 || !Fits(encoded)) {
+      auto entries = GetEntries(n);
+      entries.insert(entries.begin() + index, {key, value});
+      Assign(entries.data(), n + 1);
+      return;
+    }
+    char *entry = EntryAt(index);
+    memmove(entry + Stride(), entry, (n - index) * Stride());
+    WriteEntry(entry, encoded, value);
+  }
+
+  /** Replace the key at index of the n entries. There must be room for it, see HasRoomFor(). */
+  void SetKeyAt(int n, int index, const KeyType &key) {
+    char encoded[sizeof(KeyType)];
+    format_.Encode(reinterpret_cast<const char *>(&key), encoded);
+    if (!Fits(encoded)) {
+      auto entries = GetEntries(n);
+      entries[index].first = key;
+      Assign(entries.data(), n);
+      return;
+    }
+    WriteEntry(EntryAt(index), encoded, ValueAt(index));
+  }
+
+  /** Remove the entry at index of the n entries. */
+  void Remove(int n, int index) {
+    char *entry = EntryAt(index);
+    memmove(entry, entry + Stride(), (n - index - 1) * Stride());
+  }
+
+  /** Replace all entries by the n entries, which must fit in, see CanHold(). */
+  void Assign(const Entry *entries, int n) {
+    const auto [prefix_size, suffix_size] = Measure(entries, n);
+    prefix_size_ = prefix_size;
+    suffix_size_ = suffix_size;
+    char encoded[sizeof(KeyType)];
+    for (int i = 0; i < n; i++) {
+      format_.Encode(reinterpret_cast<const char *>(&entries[i].first), encoded);
+      if (i == 0) {
+        memcpy(data_, encoded, prefix_size_);
+      }
+      WriteEntry(EntryAt(i), encoded, entries[i].second);
+    }
+  }
+
+ private:
+  static auto SizeOf(size_t prefix_size, size_t suffix_size, int n) -> size_t {
+    return prefix_size + n * (suffix_size + sizeof(ValueType));
+  }
+
+  static auto CommonPrefix(const char *lhs, const char *rhs, uint32_t max_size) -> uint32_t {
+    uint32_t size = 0;
+    while (size < max_size && lhs[size] == rhs[size]) {
+      size++;
+    }
+    return size;
+  }
+
+  /** @return the shortest prefix and suffix of the n entries */
+  auto Measure(const Entry *entries, int n) const -> std::pair<uint16_t, uint16_t> {
+    if (n == 0) {
+      return {0, 0};
+    }
+    char first[sizeof(KeyType)];
+    char encoded[sizeof(KeyType)];
+    format_.Encode(reinterpret_cast<const char *>(&entries[0].first), first);
+    uint32_t prefix_size = format_.GetEncodedSize();
+    uint32_t end = format_.SignificantSize(first);
+    for (int i = 1; i < n; i++) {
+      format_.Encode(reinterpret_cast<const char *>(&entries[i].first), encoded);
+      prefix_size = CommonPrefix(first, encoded, prefix_size);
+      end = std::max(end, format_.SignificantSize(encoded));
+    }
+    return {static_cast<uint16_t>(prefix_size), static_cast<uint16_t>(end > prefix_size ? end - prefix_size : 0)};
+  }
+
+  /** @return true if the key encoded as encoded can be stored without widening the prefix or the suffixes */
+  auto Fits(const char *encoded) const -> bool {
+    if (memcmp(encoded, data_, prefix_size_) != 0) {
+      return false;
+    }
+    for (uint32_t i = prefix_size_ + suffix_size_; i < format_.GetEncodedSize(); i++) {
+      if (encoded[i] != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  auto DecodeKey(uint32_t prefix_size, uint32_t suffix_size, int index) const -> KeyType {
+    char encoded[sizeof(KeyType)];
+    memcpy(encoded, data_, prefix_size);
+    memcpy(encoded + prefix_size, data_ + prefix_size + index * Stride(suffix_size), suffix_size);
+    memset(encoded + prefix_size + suffix_size, 0, format_.GetEncodedSize() - prefix_size - suffix_size);
+    KeyType key;
+    format_.Decode(encoded, reinterpret_cast<char *>(&key));
+    return key;
+  }
+
+  void WriteEntry(char *entry, const char *encoded, const ValueType &value) {
+    memcpy(entry, encoded + prefix_size_, suffix_size_);
+    memcpy(entry + suffix_size_, &value, sizeof(ValueType));
+  }
+
+  static auto Stride(size_t suffix_size) -> size_t { return suffix_size + sizeof(ValueType); }
+  auto Stride() const -> size_t { return Stride(suffix_size_); }
+  auto EntryAt(int index) -> char * { return data_ + prefix_size_ + index * Stride(); }
+
+  KeyFormat format_;
+  uint16_t prefix_size_;
+  uint16_t suffix_size_;
+  // Flexible array member for the prefix and the entries.
+  char data_[1];
+};
+
+}  // namespace bustub
@@ -12,47 +12,69 @@
 
 #include <queue>
 #include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_compressed_entries.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE 52
+#define INTERNAL_PAGE_DATA_SIZE (BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE - KEY_SEARCH_SLACK)
+// the most children of an internal page, each key compressed down to a single byte
+#define INTERNAL_PAGE_SIZE static_cast<int>(INTERNAL_PAGE_DATA_SIZE / (sizeof(page_id_t) + 1) + 1)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
  * K(i) <= K < K(i+1).
  * NOTE: since the number of keys does not equal to number of child pointers,
  * the first key always remains invalid. That is to say, any search/lookup
- * should ignore the first key.
+ * should ignore the first key. It is not stored at all, and reads as all zeros.
+ *
+ * The keys are separators rather than keys of the tree: a leaf split pushes up the shortest key that still tells the
+ * two leaves apart (see KeyFormat::Separator()), which compresses into short suffixes.
  *
- * Internal page format (keys are stored in increasing order):
- *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
- *  --------------------------------------------------------------------------
+ * Internal page format (keys are stored in increasing order, compressed, see CompressedEntries):
+ *  -------------------------------------------------------------------------------------------------------
+ * | HEADER | PAGE_ID(0) | PREFIX | SUFFIX(1)+PAGE_ID(1) | SUFFIX(2)+PAGE_ID(2) | ... | SUFFIX(n)+PAGE_ID(n) |
+ *  -------------------------------------------------------------------------------------------------------
+ * The header is the one of BPlusTreePage (24 bytes), with the PAGE_ID(0) (4 bytes) and the header of the compressed
+ * entries (24 bytes) behind it, 52 bytes in total.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
  public:
   // must call initialize method after "create" a new node
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id, int max_size, const KeyFormat &format);
+  // the number of children that fit in an internal page, however badly their keys compress
+  static auto GetCapacity(const KeyFormat &format) -> int;
 
   auto KeyAt(int index) const -> KeyType;
   void SetKeyAt(int index, const KeyType &key);
   auto ValueAt(int index) const -> ValueType;
-  void SetIndex(size_t idx, const std::pair<KeyType, ValueType> &m);
-  auto IndexAt(int index) const -> std::pair<KeyType, ValueType>;
+  auto ValueIndex(const ValueType &value) const -> int;
+  auto IndexAt(int index) const -> MappingType;
+  auto GetEntries() const -> std::vector<MappingType>;
+  void SetEntries(const std::vector<MappingType> &entries);
   auto BinarySearchByKey(const KeyType &key, const KeyComparator &comparator) -> int;
   void Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
   void InsertAtBack(const KeyType &key, const ValueType &value);
-  void InsertAtSecond(const KeyType &key, const ValueType &value);
-  auto GetLeftSiblingPageIdx(const ValueType &child_page_id, bool &ok, KeyType &parentKey, int &parent_idx) -> int;
-  auto RemoveEntry(const KeyType &key, const KeyComparator &comparator) -> bool;
+  void RemoveAt(int index);
+  // room for one more key, or for replacing a key by key
+  auto HasRoomFor(const KeyType &key) const -> bool;
+  auto HasRoomToSetKey(const KeyType &key) const -> bool;
+  auto HasRoomForAnyKey() const -> bool;
+  auto CanHold(const std::vector<MappingType> &entries) const -> bool;
+  // how many of the n entries, from the first on, fill the page up to fill of its bytes
+  auto CountFitting(const MappingType *entries, int n, double fill) const -> int;
+  // less than half full by children and by bytes, once removed more children are removed
+  auto IsUnderfull(int removed = 0) const -> bool;
 
  private:
-  // Flexible array member for page data.
-  // https://stackoverflow.com/questions/6390331/why-use-array-size-1-instead-of-pointer
-  MappingType array_[1];
+  // the first child, whose key is never looked at
+  ValueType first_value_;
+  // the other children with their keys
+  CompressedEntries<KeyType, ValueType, INTERNAL_PAGE_DATA_SIZE> entries_;
 };
 }  // namespace bustub
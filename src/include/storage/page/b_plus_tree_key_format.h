@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_format.h
+//
+// Identification: src/include/storage/page/b_plus_tree_key_format.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "storage/index/generic_key.h"
+#include "type/type.h"
+
+namespace bustub {
+
+/**
+ * How the keys of a B+ tree are encoded in its pages.
+ *
+ * A key of integer columns only, the kind GenericComparator compiles, is normalized: its columns are written one after
+ * the other, big-endian and with the sign bit flipped. Encoded keys then compare byte by byte, the way memcmp compares
+ * them, just like the comparator compares the keys. A search compares encoded keys in place, the bytes all keys of a
+ * page start with need to be stored only once, and a key cut short after the first byte it differs from another key
+ * in still sorts between them, which is what makes short separators. Bytes of the key outside its columns are not
+ * encoded, they decode as zeros; the comparator never looks at them.
+ *
+ * Any other key is encoded as it is. Its bytes can still be shared and trimmed, but it is only ever compared by the
+ * comparator, once decoded.
+ *
+ * The format is stored in every page of the tree, so that pages decode their keys on their own.
+ */
+class KeyFormat {
+ public:
+  /** @return the format of the keys compared by comparator */
+  template <size_t KeySize>
+  static auto Of(const GenericComparator<KeySize> &comparator) -> KeyFormat {
+    static_assert(KeySize <= UINT8_MAX, "key too long for a key format");
+    KeyFormat format;
+    format.key_size_ = KeySize;
+    format.num_columns_ = static_cast<uint8_t>(comparator.GetNumCompiledColumns());
+    if (format.num_columns_ == 0) {
+      format.encoded_size_ = KeySize;
+      return format;
+    }
+    for (uint32_t i = 0; i < format.num_columns_; i++) {
+      const auto &column = comparator.GetCompiledColumn(i);
+      format.offsets_[i] = static_cast<uint8_t>(column.offset_);
+      format.widths_[i] = static_cast<uint8_t>(Type::GetTypeSize(column.type_));
+      format.encoded_size_ += format.widths_[i];
+    }
+    return format;
+  }
+
+  /** @return true if encoded keys compare like memcmp compares them */
+  auto IsNormalized() const -> bool { return num_columns_ > 0; }
+
+  /** @return the size of a key */
+  auto GetKeySize() const -> uint32_t { return key_size_; }
+
+  /** @return the size of an encoded key */
+  auto GetEncodedSize() const -> uint32_t { return encoded_size_; }
+
+  /** Write the GetEncodedSize() bytes of the encoding of key to encoded. */
+  void Encode(const char *key, char *encoded) const {
+    if (!IsNormalized()) {
+      memcpy(encoded, key, key_size_);
+      return;
+    }
+    for (uint32_t i = 0; i < num_columns_; i++) {
+      const uint32_t width = widths_[i];
+      const char *column = key + offsets_[i];
+      for (uint32_t j = 0; j < width; j++) {
+        encoded[j] = column[width - 1 - j];
+      }
+      encoded[0] = static_cast<char>(encoded[0] ^ SIGN_BIT);
+      encoded += width;
+    }
+  }
+
+  /** Write the GetKeySize() bytes of the key encoded as encoded to key. */
+  void Decode(const char *encoded, char *key) const {
+    if (!IsNormalized()) {
+      memcpy(key, encoded, key_size_);
+      return;
+    }
+    memset(key, 0, key_size_);
+    for (uint32_t i = 0; i < num_columns_; i++) {
+      const uint32_t width = widths_[i];
+      char *column = key + offsets_[i];
+      for (uint32_t j = 0; j < width; j++) {
+        column[width - 1 - j] = encoded[j];
+      }
+      column[width - 1] = static_cast<char>(column[width - 1] ^ SIGN_BIT);
+      encoded += width;
+    }
+  }
+
+  /** @return the size of encoded once its zero bytes at the end are cut off */
+  auto SignificantSize(const char *encoded) const -> uint32_t {
+    uint32_t size = encoded_size_;
+    while (size > 0 && encoded[size - 1] == 0) {
+      size--;
+    }
+    return size;
+  }
+
+  /**
+   * The separator of two adjacent keys of a split leaf, for the parent to tell the leaves apart with: the encoded
+   * right key, cut off one byte after the first byte it differs from the left key in. The cut off bytes are zeros, so
+   * the separator encodes into few significant bytes, and inner pages of such separators store short keys.
+   * @return a key greater than left and not greater than right, right itself if the keys are not normalized
+   */
+  template <typename KeyType>
+  auto Separator(const KeyType &left, const KeyType &right) const -> KeyType {
+    if (!IsNormalized()) {
+      return right;
+    }
+    char left_encoded[sizeof(KeyType)];
+    char right_encoded[sizeof(KeyType)];
+    Encode(reinterpret_cast<const char *>(&left), left_encoded);
+    Encode(reinterpret_cast<const char *>(&right), right_encoded);
+    uint32_t common = 0;
+    while (common < encoded_size_ && left_encoded[common] == right_encoded[common]) {
+      common++;
+    }
+    if (common + 1 < encoded_size_) {
+      memset(right_encoded + common + 1, 0, encoded_size_ - common - 1);
+    }
+    KeyType separator;
+    Decode(right_encoded, reinterpret_cast<char *>(&separator));
+    return separator;
+  }
+
+ private:
+  static constexpr uint8_t SIGN_BIT = 0x80;
+  static constexpr uint32_t MAX_COLUMNS = GenericComparator<1>::MAX_COMPILED_COLUMNS;
+
+  // 0 if the keys are not normalized
+  uint8_t num_columns_{0};
+  uint8_t key_size_{0};
+  uint8_t encoded_size_{0};
+  uint8_t offsets_[MAX_COLUMNS]{};
+  uint8_t widths_[MAX_COLUMNS]{};
+};
+
+}  // namespace bustub
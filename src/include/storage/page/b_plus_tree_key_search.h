@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.h
+//
+// Identification: src/include/storage/page/b_plus_tree_key_search.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BUSTUB_KEY_SEARCH_AVX2
+#endif
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** The bytes a search reads from each key suffix, which must be readable past the end of the last entry too. */
+static constexpr size_t KEY_SEARCH_SLACK = sizeof(uint64_t);
+
+/*
+ * Search of the sorted entries of a B+ tree page, in place.
+ *
+ * The entries lie at a fixed stride, each starting with the bytes of its encoded key the page stores, its suffix, all
+ * of them equally wide (see CompressedEntries). Normalized keys (see KeyFormat) compare like their bytes do, so the
+ * suffixes are compared as they lie in the page, and no key is decoded. A suffix of up to 8 bytes is loaded as a
+ * single big-endian integer: a binary search narrows the entries down to KEY_SEARCH_WINDOW, and the suffixes of the
+ * window are then compared against the searched one all at once, 4 per AVX2 instruction gathering them at the stride
+ * of an entry, or one by one on CPUs without AVX2. As the window is sorted, the number of suffixes below the searched
+ * one is where the search ends. Wider suffixes are binary searched with memcmp.
+ */
+namespace key_search {
+
+/** @return the 8 bytes at suffix as a big-endian integer, which compares like memcmp compares the bytes */
+inline auto LoadSuffix(const char *suffix) -> uint64_t {
+  uint64_t value;
+  memcpy(&value, suffix, sizeof(value));
+  return __builtin_bswap64(value);
+}
+
+/** @return the mask of the bytes of a loaded suffix that belong to a suffix of width bytes */
+inline auto SuffixMask(size_t width) -> uint64_t {
+  return width >= sizeof(uint64_t) ? ~uint64_t{0} : ~(~uint64_t{0} >> (8 * width));
+}
+
+/** @return the number of the n suffixes, stride bytes apart, whose masked bytes are less than target (or equal) */
+inline auto CountBelowScalar(const char *suffixes, size_t stride, int n, uint64_t target, uint64_t mask,
+                             bool or_equal) -> int {
+  int count = 0;
+  for (int i = 0; i < n; i++) {
+    const uint64_t suffix = LoadSuffix(suffixes + i * stride) & mask;
+    count += static_cast<int>(suffix < target || (or_equal && suffix == target));
+  }
+  return count;
+}
+
+#ifdef BUSTUB_KEY_SEARCH_AVX2
+/** @return true if the CPU has AVX2 */
+inline auto HasAvx2() -> bool {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2") != 0;
+  return has_avx2;
+}
+
+/** CountBelowScalar(), four suffixes per instruction. */
+__attribute__((target("avx2"))) inline auto CountBelowAvx2(const char *suffixes, size_t stride, int n,
+                                                            uint64_t target, uint64_t mask, bool or_equal) -> int {
+  const auto s = static_cast<int64_t>(stride);
+  const __m256i offsets = _mm256_setr_epi64x(0, s, 2 * s, 3 * s);
+  // Reverses the bytes of each 64-bit lane, the loads are little-endian.
+  const __m256i byte_swap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1,
+                                             0, 15, 14, 13, 12, 11, 10, 9, 8);
+  const __m256i masks = _mm256_set1_epi64x(static_cast<int64_t>(mask));
+  // AVX2 only compares signed integers, flipping the sign bit of both sides orders them as unsigned ones.
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(target)), sign);
+  int count = 0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const auto *base = reinterpret_cast<const long long *>(suffixes + i * stride);  // NOLINT
+    __m256i batch = _mm256_i64gather_epi64(base, offsets, 1);
+    batch = _mm256_xor_si256(_mm256_and_si256(_mm256_shuffle_epi8(batch, byte_swap), masks), sign);
+    if (or_equal) {
+      count += 4 - __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(batch, needle))));
+    } else {
+      count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, batch))));
+    }
+  }
+  return count + CountBelowScalar(suffixes + i * stride, stride, n - i, target, mask, or_equal);
+}
+#endif
+
+/** CountSuffixesBelow() for suffixes of up to 8 bytes. */
+inline auto SearchShort(const char *suffixes, size_t stride, size_t width, int n, const char *target, bool or_equal)
+    -> int {
+  const uint64_t mask = SuffixMask(width);
+  const uint64_t needle = LoadSuffix(target) & mask;
+  int lo = 0;
+  int hi = n;
+  while (hi - lo > KEY_SEARCH_WINDOW) {
+    const int mid = lo + (hi - lo) / 2;
+    const uint64_t suffix = LoadSuffix(suffixes + mid * stride) & mask;
+    if (suffix < needle || (or_equal && suffix == needle)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+#ifdef BUSTUB_KEY_SEARCH_AVX2
+  if (HasAvx2()) {
+    return lo + CountBelowAvx2(suffixes + lo * stride, stride, hi - lo, needle, mask, or_equal);
+  }
+#endif
+  return lo + CountBelowScalar(suffixes + lo * stride, stride, hi - lo, needle, mask, or_equal);
+}
+
+/** CountSuffixesBelow() for suffixes of more than 8 bytes. */
+inline auto SearchLong(const char *suffixes, size_t stride, size_t width, int n, const char *target, bool or_equal)
+    -> int {
+  int lo = 0;
+  int hi = n;
+  while (lo < hi) {
+    const int mid = lo + (hi - lo) / 2;
+    const int cmp = memcmp(suffixes + mid * stride, target, width);
+    if (cmp < 0 || (or_equal && cmp == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+}  // namespace key_search
+
+/**
+ * Search sorted key suffixes in place, comparing them byte by byte.
+ * @param suffixes the first suffix; KEY_SEARCH_SLACK bytes must be readable from every suffix
+ * @param stride the bytes from one suffix to the next
+ * @param width the size of a suffix
+ * @param n the number of suffixes
+ * @param target the suffix to search for; KEY_SEARCH_SLACK bytes must be readable from it
+ * @param or_equal true to count the suffixes equal to target as well
+ * @return the number of suffixes less than target, or not greater than target if or_equal
+ */
+inline auto CountSuffixesBelow(const char *suffixes, size_t stride, size_t width, int n, const char *target,
+                               bool or_equal) -> int {
+  if (width <= sizeof(uint64_t)) {
+    return key_search::SearchShort(suffixes, stride, width, n, target, or_equal);
+  }
+  return key_search::SearchLong(suffixes, stride, width, n, target, or_equal);
+}
+
+}  // namespace bustub
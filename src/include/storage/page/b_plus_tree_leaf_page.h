@@ -13,55 +13,71 @@
 #include <utility>
 #include <vector>
 
+#include "storage/page/b_plus_tree_compressed_entries.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_HEADER_SIZE 52
+#define LEAF_PAGE_DATA_SIZE (BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - KEY_SEARCH_SLACK)
+// the most entries of a leaf page, each key compressed down to a single byte
+#define LEAF_PAGE_SIZE static_cast<int>(LEAF_PAGE_DATA_SIZE / (sizeof(ValueType) + 1))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
- * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ * Leaf page format (keys are stored in order, compressed, see CompressedEntries):
+ *  ----------------------------------------------------------------------------------
+ * | HEADER | PREFIX | SUFFIX(1) + RID(1) | SUFFIX(2) + RID(2) | ... | SUFFIX(n) + RID(n)
+ *  ----------------------------------------------------------------------------------
  *
- *  Header format (size in byte, 28 bytes in total):
+ *  Header format (size in byte, 52 bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
  *  -----------------------------------------------
  * | ParentPageId (4) | PageId (4) | NextPageId (4)
  *  -----------------------------------------------
+ *  -----------------------------------------------------------------------------
+ * | KeyFormat (19) | Padding (1) | PrefixSize (2) | SuffixSize (2) |
+ *  -----------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id, int max_size, const KeyFormat &format);
+  // the number of entries that fit in a leaf page, however badly their keys compress
+  static auto GetCapacity(const KeyFormat &format) -> int;
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
   auto KeyAt(int index) const -> KeyType;
   auto ValueAt(int index) const -> ValueType;
-  auto IndexAt(int index) const -> const MappingType &;
-  void SetIndex(size_t idx, const std::pair<KeyType, ValueType> &m);
+  auto IndexAt(int index) const -> MappingType;
+  auto GetEntries() const -> std::vector<MappingType>;
+  void SetEntries(const std::vector<MappingType> &entries);
   auto ExistsKey(const KeyType &key, const KeyComparator &comparator) -> bool;
   auto BinarySearchByKey(const KeyType &key, const KeyComparator &comparator) -> int;
   void Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
   void InsertAtBack(const KeyType &key, const ValueType &value);
   auto RemoveEntry(const KeyType &key, const KeyComparator &comparator) -> bool;
-  void InsertAtSecond(const KeyType &key, const ValueType &value);
+  void RemoveAt(int index);
+  // room for one more entry, with the given key or with any key
+  auto HasRoomFor(const KeyType &key) const -> bool;
+  auto HasRoomForAnyKey() const -> bool;
+  auto CanHold(const std::vector<MappingType> &entries) const -> bool;
+  // how many of the n entries, from the first on, fill the page up to fill of its bytes
+  auto CountFitting(const MappingType *entries, int n, double fill) const -> int;
+  // less than half full by entries and by bytes, once removed more entries are removed
+  auto IsUnderfull(int removed = 0) const -> bool;
 
  private:
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[1];
+  CompressedEntries<KeyType, ValueType, LEAF_PAGE_DATA_SIZE> entries_;
 };
 }  // namespace bustub
@@ -22,13 +22,21 @@ namespace bustub {
  * 32 bytes) and their corresponding root_id
  *
  * Format (size in byte):
- *  -----------------------------------------------------------------
- * | RecordCount (4) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
- *  -----------------------------------------------------------------
+ *  ----------------------------------------------------------------------------------
+ * | RecordCount (4) | PageSize (4) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
+ *  ----------------------------------------------------------------------------------
+ *
+ * PageSize is the BUSTUB_PAGE_SIZE of the build that created the database. A header page that is still all zeros is
+ * stamped with the current page size on first use; one stamped with another page size is rejected with an Exception,
+ * since none of the other pages of that database can be read by this build. A header page from before PageSize was
+ * recorded, with its records right after RecordCount, is taken for a 4 KB database and moved to this format.
  */
 class HeaderPage : public Page {
  public:
-  void Init() { SetRecordCount(0); }
+  void Init() {
+    SetRecordCount(0);
+    SetPageSize(BUSTUB_PAGE_SIZE);
+  }
   /**
    * Record related
    */
@@ -40,12 +48,39 @@ class HeaderPage : public Page {
   auto GetRootId(const std::string &name, page_id_t *root_id) -> bool;
   auto GetRecordCount() -> int;
 
+  /** @return the page size the database was created with, or 0 if the header page was never used */
+  auto GetPageSize() -> int;
+
+  /**
+   * Throw an Exception if the header page belongs to a database created with another page size. Unlike the record
+   * operations, this does not stamp or convert the page, so it also works on a read-only page.
+   */
+  void ValidatePageSize();
+
  private:
+  // the page size of the databases created before the header page recorded it
+  static constexpr int LEGACY_PAGE_SIZE = 4096;
+  static constexpr int OFFSET_PAGE_SIZE = 4;
+  static constexpr int OFFSET_RECORDS = 8;
+  static constexpr int NAME_SIZE = 32;
+  static constexpr int RECORD_SIZE = NAME_SIZE + sizeof(page_id_t);
+
   /**
    * helper functions
    */
   auto FindRecord(const std::string &name) -> int;
 
   void SetRecordCount(int record_count);
+
+  void SetPageSize(int page_size);
+
+  /** @return true if the page size slot holds the start of a record, i.e. the header page predates the page size */
+  static auto IsLegacyPageSize(int page_size) -> bool;
+
+  /**
+   * Stamp a fresh header page with the page size and move a legacy one to the current format, or throw if it belongs
+   * to a database with another page size.
+   */
+  void CheckPageSize();
 };
 }  // namespace bustub
@@ -12,10 +12,12 @@
 
 #pragma once
 
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 
 #include "common/config.h"
+#include "common/macros.h"
 #include "common/rwlatch.h"
 
 namespace bustub {
@@ -24,17 +26,37 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The book-keeping information and the data are kept apart: a buffer pool packs the data of its frames into a
+ * FrameArena, and the Page objects themselves into an array of cache-line-aligned entries, so that latching one frame
+ * does not invalidate the cache lines of its neighbours.
  */
-class Page {
+class alignas(CACHE_LINE_SIZE) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManagerInstance;
+  friend class MmapBufferPoolManager;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
-
-  /** Default destructor. */
-  ~Page() = default;
+  /** Constructor for a page outside of a buffer pool. Allocates the page data and zeros it out. */
+  Page()
+      : data_(static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, BUSTUB_PAGE_SIZE))), owns_data_(true) {
+    ResetMemory();
+  }
+
+  /**
+   * Constructor for a frame of a buffer pool.
+   * @param data the data of the frame, owned by the buffer pool
+   */
+  explicit Page(char *data) : data_(data) {}
+
+  /** Destructor. Frees the page data if the page allocated it. */
+  ~Page() {
+    if (owns_data_) {
+      std::free(data_);  // NOLINT
+    }
+  }
+
+  DISALLOW_COPY(Page);
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
@@ -51,6 +73,12 @@ class Page {
   /** Acquire the page write latch. */
   inline void WLatch() { rwlatch_.WLock(); }
 
+  /**
+   * Acquire the page write latch if nobody holds the page latch.
+   * @return false if the latch is held, the page is not latched then
+   */
+  inline auto TryWLatch() -> bool { return rwlatch_.TryWLock(); }
+
   /** Release the page write latch. */
   inline void WUnlatch() { rwlatch_.WUnlock(); }
 
@@ -60,6 +88,16 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Start an optimistic read of the page, without latching it. The page must stay pinned until the read is validated.
+   * @param[out] version the version to pass to ValidateRead()
+   * @return false if the page is write latched, fall back to RLatch() then
+   */
+  inline auto OptimisticRLatch(uint64_t *version) -> bool { return rwlatch_.OptimisticRLock(version); }
+
+  /** @return true if the page was not write latched since OptimisticRLatch() returned `version` */
+  inline auto ValidateRead(uint64_t version) -> bool { return rwlatch_.Validate(version); }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -78,8 +116,10 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[BUSTUB_PAGE_SIZE]{};
+  /** The actual data that is stored within a page, aligned so that the disk manager can use it for O_DIRECT. */
+  char *data_;
+  /** True if data_ was allocated by this page rather than by a buffer pool. */
+  bool owns_data_{false};
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
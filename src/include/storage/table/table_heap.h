@@ -13,6 +13,7 @@
 #pragma once
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_ring.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
@@ -55,9 +56,10 @@ class TableHeap {
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
+   * @param ring for bulk inserts, the ring that the pages of the table are read and created through
    * @return true iff the insert is successful
    */
-  auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+  auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, BufferRing *ring = nullptr) -> bool;
 
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
@@ -95,12 +97,18 @@ class TableHeap {
    * @param rid rid of the tuple to read
    * @param tuple output variable for the tuple
    * @param txn transaction performing the read
+   * @param ring for scans, the ring that the page is read through
    * @return true if the read was successful (i.e. the tuple exists)
    */
-  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
+  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true,
+                BufferRing *ring = nullptr) -> bool;
 
-  /** @return the begin iterator of this table */
-  auto Begin(Transaction *txn) -> TableIterator;
+  /**
+   * @param txn the transaction performing the scan
+   * @param ring for full scans, the ring that the pages are read through; it must outlive the iterator
+   * @return the begin iterator of this table
+   */
+  auto Begin(Transaction *txn, BufferRing *ring = nullptr) -> TableIterator;
 
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
@@ -109,6 +117,28 @@ class TableHeap {
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
  private:
+  /** Fetch a page through `ring`, or straight from the buffer pool if there is no ring. */
+  auto FetchPage(page_id_t page_id, BufferRing *ring) -> Page * {
+    return ring == nullptr ? buffer_pool_manager_->FetchPage(page_id) : ring->FetchPage(page_id);
+  }
+
+  /** Start reading the page that follows a page of the table, so that a scan does not stall when it gets there. */
+  void ReadAhead(page_id_t next_page_id, BufferRing *ring) {
+    if (next_page_id == INVALID_PAGE_ID) {
+      return;
+    }
+    if (ring == nullptr) {
+      buffer_pool_manager_->PrefetchPage(next_page_id);
+    } else {
+      ring->PrefetchPage(next_page_id);
+    }
+  }
+
+  /** Create a page through `ring`, or straight in the buffer pool if there is no ring. */
+  auto NewPage(page_id_t *page_id, BufferRing *ring) -> Page * {
+    return ring == nullptr ? buffer_pool_manager_->NewPage(page_id) : ring->NewPage(page_id);
+  }
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
@@ -20,6 +20,7 @@
 
 namespace bustub {
 
+class BufferRing;
 class TableHeap;
 
 /**
@@ -29,10 +30,10 @@ class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferRing *ring = nullptr);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_), ring_(other.ring_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -54,6 +55,7 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    ring_ = other.ring_;
     return *this;
   }
 
@@ -61,6 +63,8 @@ class TableIterator {
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** The ring that a full scan reads its pages through, nullptr to read them from the shared buffer pool. */
+  BufferRing *ring_;
 };
 
 }  // namespace bustub
@@ -10,33 +10,94 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cassert>
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
+#include <optional>
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
 
 static char *buffer_used;
 
+namespace {
+
+/** A page-sized buffer that satisfies the alignment of O_DIRECT, for callers whose buffer does not. */
+struct AlignedPageBuffer {
+  AlignedPageBuffer() : data_(static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, BUSTUB_PAGE_SIZE))) {}
+  ~AlignedPageBuffer() { std::free(data_); }  // NOLINT
+  DISALLOW_COPY_AND_MOVE(AlignedPageBuffer);
+  char *data_;
+};
+
+auto IsAligned(const char *buf) -> bool { return reinterpret_cast<uintptr_t>(buf) % DIRECT_IO_ALIGNMENT == 0; }
+
+}  // namespace
+
+/**
+ * pread() until size bytes are read or the file ends
+ */
+auto DiskManager::ReadFully(int fd, char *buf, size_t size, off_t offset) -> ssize_t {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = pread(fd, buf + done, size - done, offset + static_cast<off_t>(done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      return -1;
+    }
+    if (n == 0) {
+      break;
+    }
+    done += n;
+  }
+  return static_cast<ssize_t>(done);
+}
+
+/**
+ * pwrite() all size bytes
+ */
+auto DiskManager::WriteFully(int fd, const char *buf, size_t size, off_t offset) -> bool {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = pwrite(fd, buf + done, size - done, offset + static_cast<off_t>(done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    done += n;
+  }
+  return true;
+}
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io) : file_name_(db_file) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
     return;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
+  fsm_name_ = file_name_.substr(0, n) + ".fsm";
 
   log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
   // directory or file does not exist
@@ -49,27 +110,54 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
     }
   }
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+#ifdef O_DIRECT
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);  // NOLINT
+    // tmpfs and a few other file systems reject O_DIRECT; buffered I/O still works there.
+    if (db_fd_ < 0 && errno == EINVAL) {
+      LOG_WARN("%s does not support O_DIRECT, falling back to buffered I/O", db_file.c_str());
     }
+    direct_io_ = db_fd_ >= 0;
+  }
+#else
+  if (direct_io) {
+    LOG_WARN("O_DIRECT is not available on this platform, falling back to buffered I/O");
   }
+#endif
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);  // NOLINT
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  db_file_size_ = fstat(db_fd_, &stat_buf) == 0 ? stat_buf.st_size : 0;
   buffer_used = nullptr;
+  LoadFreePageMap();
+}
+
+DiskManager::~DiskManager() {
+  FlushFreePageMap();
+  if (fsm_fd_ >= 0) {
+    close(fsm_fd_);
+  }
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
 }
 
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+  FlushFreePageMap();
+  if (fsm_fd_ >= 0) {
+    close(fsm_fd_);
+    fsm_fd_ = -1;
+  }
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
   }
   log_io_.close();
 }
@@ -78,47 +166,141 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
-  // set write cursor to offset
+  ScopedLatency latency(&write_latency_);
+  const auto offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
+
+  std::optional<AlignedPageBuffer> bounce;
+  if (direct_io_ && !IsAligned(page_data)) {
+    bounce.emplace();
+    memcpy(bounce->data_, page_data, BUSTUB_PAGE_SIZE);
+    page_data = bounce->data_;
+  }
+  if (!WriteFully(db_fd_, page_data, BUSTUB_PAGE_SIZE, offset)) {
+    LOG_DEBUG("I/O error while writing: %s", strerror(errno));
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+
+  ExtendFileSize(offset + BUSTUB_PAGE_SIZE);
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
+  ScopedLatency latency(&read_latency_);
+  const auto offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
   // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
+  if (offset >= db_file_size_.load()) {
     LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+
+  std::optional<AlignedPageBuffer> bounce;
+  char *buf = page_data;
+  if (direct_io_ && !IsAligned(page_data)) {
+    bounce.emplace();
+    buf = bounce->data_;
+  }
+  ssize_t read_count = ReadFully(db_fd_, buf, BUSTUB_PAGE_SIZE, offset);
+  if (read_count < 0) {
+    LOG_DEBUG("I/O error while reading: %s", strerror(errno));
+    return;
+  }
+  // if file ends before reading BUSTUB_PAGE_SIZE
+  if (read_count < BUSTUB_PAGE_SIZE) {
+    LOG_DEBUG("Read less than a page");
+    memset(buf + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+  }
+  if (bounce.has_value()) {
+    memcpy(page_data, buf, BUSTUB_PAGE_SIZE);
+  }
+}
+
+/**
+ * Write several pages, one after the other
+ */
+void DiskManager::WritePages(const std::vector<PageIo> &pages) {
+  for (const auto &page : pages) {
+    WritePage(page.page_id_, page.data_);
+  }
+}
+
+/**
+ * Read several pages, one after the other
+ */
+void DiskManager::ReadPages(const std::vector<PageIo> &pages) {
+  for (const auto &page : pages) {
+    ReadPage(page.page_id_, page.data_);
+  }
+}
+
+/**
+ * Mark a page as free in the free page map
+ */
+void DiskManager::DeallocatePage(page_id_t page_id) { free_page_map_.Free(page_id); }
+
+/**
+ * Take a free page from the free page map
+ */
+auto DiskManager::AllocateFreePage(page_id_t limit, page_id_t stride, page_id_t offset) -> page_id_t {
+  return free_page_map_.Take(limit, stride, offset);
+}
+
+/**
+ * Clear a page in the free page map
+ */
+void DiskManager::MarkPageAllocated(page_id_t page_id) { free_page_map_.Use(page_id); }
+
+/**
+ * Write the dirty bitmap pages of the free page map into the fsm file
+ */
+void DiskManager::FlushFreePageMap() {
+  if (fsm_name_.empty()) {
+    return;
+  }
+  std::scoped_lock<std::mutex> lock(fsm_latch_);
+  std::vector<size_t> dirty = free_page_map_.DirtyBitmapPages();
+  if (dirty.empty()) {
+    return;
+  }
+  if (fsm_fd_ < 0) {
+    fsm_fd_ = open(fsm_name_.c_str(), O_RDWR | O_CREAT, 0644);  // NOLINT
+    if (fsm_fd_ < 0) {
+      LOG_DEBUG("can't open free page map file: %s", strerror(errno));
       return;
     }
-    // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+  }
+  char data[BUSTUB_PAGE_SIZE];
+  for (auto index : dirty) {
+    free_page_map_.ReadBitmapPage(index, data);
+    if (!WriteFully(fsm_fd_, data, BUSTUB_PAGE_SIZE, static_cast<off_t>(index) * BUSTUB_PAGE_SIZE)) {
+      LOG_DEBUG("I/O error while writing free page map: %s", strerror(errno));
+      return;
+    }
+  }
+}
+
+/**
+ * Read the fsm file of an existing database file into the free page map
+ */
+void DiskManager::LoadFreePageMap() {
+  if (db_file_size_ == 0) {
+    // A new database file: whatever free page map is lying around belongs to an older file of the same name.
+    unlink(fsm_name_.c_str());
+    return;
+  }
+  fsm_fd_ = open(fsm_name_.c_str(), O_RDWR);  // NOLINT
+  if (fsm_fd_ < 0) {
+    return;
+  }
+  char data[BUSTUB_PAGE_SIZE];
+  for (size_t index = 0;; index++) {
+    if (ReadFully(fsm_fd_, data, BUSTUB_PAGE_SIZE, static_cast<off_t>(index) * BUSTUB_PAGE_SIZE) < BUSTUB_PAGE_SIZE) {
+      break;
     }
+    free_page_map_.WriteBitmapPage(index, data);
   }
 }
 
@@ -199,6 +381,15 @@ auto DiskManager::GetNumWrites() const -> int { return num_writes_; }
  */
 auto DiskManager::GetFlushState() const -> bool { return flush_log_; }
 
+/**
+ * Grow the cached size of the db file; concurrent writers past the end race to the largest value
+ */
+void DiskManager::ExtendFileSize(int64_t end) {
+  int64_t size = db_file_size_.load();
+  while (size < end && !db_file_size_.compare_exchange_weak(size, end)) {
+  }
+}
+
 /**
  * Private helper function to get disk file size
  */
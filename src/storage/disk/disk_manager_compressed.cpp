@@ -0,0 +1,333 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.cpp
+//
+// Identification: src/storage/disk/disk_manager_compressed.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_compressed.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "common/util/compress_util.h"
+
+namespace bustub {
+
+static_assert(BUSTUB_PAGE_SIZE % COMPRESSED_SLOT_SIZE == 0, "a page must take a whole number of slots");
+
+DiskManagerCompressed::DiskManagerCompressed(const std::string &db_file) : DiskManager(db_file) {
+  std::string::size_type n = file_name_.rfind('.');
+  if (n == std::string::npos) {
+    return;
+  }
+  map_name_ = file_name_.substr(0, n) + ".map";
+  LoadPageMap();
+}
+
+DiskManagerCompressed::~DiskManagerCompressed() {
+  FlushFreePageMap();
+  if (map_fd_ >= 0) {
+    close(map_fd_);
+  }
+}
+
+/**
+ * Compress the page and write it to a newly allocated extent
+ */
+void DiskManagerCompressed::WritePage(page_id_t page_id, const char *page_data) {
+  BUSTUB_ASSERT(page_id >= 0, "cannot write an invalid page");
+  ScopedLatency latency(&write_latency_);
+
+  // A page that does not save at least one slot is not worth decompressing on every read.
+  char compressed[BUSTUB_PAGE_SIZE];
+  const char *data = compressed;
+  auto size = static_cast<uint32_t>(
+      CompressUtil::Compress(page_data, BUSTUB_PAGE_SIZE, compressed, BUSTUB_PAGE_SIZE - COMPRESSED_SLOT_SIZE));
+  if (size == 0) {
+    data = page_data;
+    size = BUSTUB_PAGE_SIZE;
+  }
+
+  const uint32_t num_slots = NumSlots(size);
+  uint32_t first_slot;
+  {
+    std::scoped_lock<std::mutex> lock(map_latch_);
+    first_slot = AllocateSlots(num_slots);
+  }
+  const auto offset = static_cast<int64_t>(first_slot) * COMPRESSED_SLOT_SIZE;
+  if (!WriteFully(db_fd_, data, size, offset)) {
+    LOG_DEBUG("I/O error while writing: %s", strerror(errno));
+    std::scoped_lock<std::mutex> lock(map_latch_);
+    AddFreeSlots(first_slot, num_slots);
+    return;
+  }
+  num_writes_ += 1;
+  ExtendFileSize(offset + size);
+
+  // The page map only points to the new extent once its data is written.
+  bool flush_map;
+  {
+    std::scoped_lock<std::mutex> lock(map_latch_);
+    SetExtent(page_id, {first_slot, size});
+    flush_map = num_pending_slots_ >= MAX_PENDING_SLOTS;
+  }
+  if (flush_map) {
+    FlushFreePageMap();
+  }
+}
+
+/**
+ * Read the extent of the page and decompress it
+ */
+void DiskManagerCompressed::ReadPage(page_id_t page_id, char *page_data) {
+  ScopedLatency latency(&read_latency_);
+  Extent extent{0, 0};
+  {
+    std::scoped_lock<std::mutex> lock(map_latch_);
+    if (page_id >= 0 && static_cast<size_t>(page_id) < extents_.size()) {
+      extent = extents_[page_id];
+    }
+  }
+  if (extent.size_ == 0) {
+    LOG_DEBUG("I/O error reading a page that was never written");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+
+  const auto offset = static_cast<int64_t>(extent.first_slot_) * COMPRESSED_SLOT_SIZE;
+  char compressed[BUSTUB_PAGE_SIZE];
+  char *buf = extent.size_ == BUSTUB_PAGE_SIZE ? page_data : compressed;
+  ssize_t read_count = ReadFully(db_fd_, buf, extent.size_, offset);
+  if (read_count < 0) {
+    LOG_DEBUG("I/O error while reading: %s", strerror(errno));
+    return;
+  }
+  if (read_count < extent.size_) {
+    LOG_DEBUG("Read less than a stored page");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+  if (buf == page_data) {
+    return;
+  }
+  if (CompressUtil::Decompress(compressed, extent.size_, page_data, BUSTUB_PAGE_SIZE) != BUSTUB_PAGE_SIZE) {
+    LOG_DEBUG("page %d is corrupted", page_id);
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+  }
+}
+
+/**
+ * Drop the page from the page map before giving its id back
+ */
+void DiskManagerCompressed::DeallocatePage(page_id_t page_id) {
+  {
+    std::scoped_lock<std::mutex> lock(map_latch_);
+    if (page_id >= 0 && static_cast<size_t>(page_id) < extents_.size() && extents_[page_id].size_ != 0) {
+      SetExtent(page_id, {0, 0});
+    }
+  }
+  DiskManager::DeallocatePage(page_id);
+}
+
+/**
+ * Write the dirty page map pages into the map file; the extents they no longer refer to become reusable. The database
+ * file is synced first, so the map on disk never points to an extent whose data is not on disk yet, and the map file
+ * is synced before the old extents are reused, so they are not overwritten while the map on disk still points to them.
+ */
+void DiskManagerCompressed::FlushFreePageMap() {
+  if (!map_name_.empty()) {
+    std::scoped_lock<std::mutex> lock(map_latch_);
+    const bool any_dirty = std::find(dirty_.begin(), dirty_.end(), true) != dirty_.end();
+    bool flushed = true;
+    if (any_dirty && db_fd_ >= 0 && fdatasync(db_fd_) != 0) {
+      LOG_DEBUG("I/O error while syncing the database file: %s", strerror(errno));
+      flushed = false;
+    }
+    std::vector<size_t> written;
+    for (size_t index = 0; index < dirty_.size() && flushed; index++) {
+      if (!dirty_[index]) {
+        continue;
+      }
+      if (map_fd_ < 0) {
+        map_fd_ = open(map_name_.c_str(), O_RDWR | O_CREAT, 0644);  // NOLINT
+        if (map_fd_ < 0) {
+          LOG_DEBUG("can't open page map file: %s", strerror(errno));
+          flushed = false;
+          break;
+        }
+      }
+      char data[BUSTUB_PAGE_SIZE] = {0};
+      const size_t begin = index * EXTENTS_PER_MAP_PAGE;
+      const size_t end = std::min(begin + EXTENTS_PER_MAP_PAGE, extents_.size());
+      memcpy(data, &extents_[begin], (end - begin) * sizeof(Extent));
+      flushed = WriteFully(map_fd_, data, BUSTUB_PAGE_SIZE, static_cast<off_t>(index) * BUSTUB_PAGE_SIZE);
+      if (!flushed) {
+        LOG_DEBUG("I/O error while writing page map: %s", strerror(errno));
+        break;
+      }
+      dirty_[index] = false;
+      written.push_back(index);
+    }
+    if (flushed && !written.empty() && fdatasync(map_fd_) != 0) {
+      LOG_DEBUG("I/O error while syncing page map: %s", strerror(errno));
+      flushed = false;
+    }
+    if (!flushed) {
+      // The map pages may not be durable, they are written again by the next flush.
+      for (const auto index : written) {
+        dirty_[index] = true;
+      }
+    } else {
+      for (const auto &extent : pending_free_) {
+        AddFreeSlots(extent.first_slot_, NumSlots(extent.size_));
+      }
+      pending_free_.clear();
+      num_pending_slots_ = 0;
+    }
+  }
+  DiskManager::FlushFreePageMap();
+}
+
+auto DiskManagerCompressed::GetStoredBytes() -> size_t {
+  std::scoped_lock<std::mutex> lock(map_latch_);
+  return stored_bytes_;
+}
+
+auto DiskManagerCompressed::GetNumSlots() -> size_t {
+  std::scoped_lock<std::mutex> lock(map_latch_);
+  return num_slots_;
+}
+
+/**
+ * Take the smallest free run that fits, splitting it if it is larger, or append to the file
+ */
+auto DiskManagerCompressed::AllocateSlots(uint32_t num_slots) -> uint32_t {
+  auto it = free_slots_by_size_.lower_bound({num_slots, 0});
+  if (it == free_slots_by_size_.end()) {
+    uint32_t first_slot = num_slots_;
+    num_slots_ += num_slots;
+    return first_slot;
+  }
+  const auto [run_slots, first_slot] = *it;
+  free_slots_by_size_.erase(it);
+  free_slots_.erase(first_slot);
+  if (run_slots > num_slots) {
+    free_slots_.emplace(first_slot + num_slots, run_slots - num_slots);
+    free_slots_by_size_.emplace(run_slots - num_slots, first_slot + num_slots);
+  }
+  return first_slot;
+}
+
+/**
+ * Merge the slots with the free runs that end right before them and start right after them, so that the slots of
+ * small pages released next to each other can take a larger page again
+ */
+void DiskManagerCompressed::AddFreeSlots(uint32_t first_slot, uint32_t num_slots) {
+  if (num_slots == 0) {
+    return;
+  }
+  auto next = free_slots_.lower_bound(first_slot);
+  if (next != free_slots_.end() && next->first == first_slot + num_slots) {
+    num_slots += next->second;
+    free_slots_by_size_.erase({next->second, next->first});
+    next = free_slots_.erase(next);
+  }
+  if (next != free_slots_.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == first_slot) {
+      first_slot = prev->first;
+      num_slots += prev->second;
+      free_slots_by_size_.erase({prev->second, prev->first});
+      free_slots_.erase(prev);
+    }
+  }
+  free_slots_.emplace(first_slot, num_slots);
+  free_slots_by_size_.emplace(num_slots, first_slot);
+}
+
+/**
+ * Replace the extent of a page in the page map
+ */
+void DiskManagerCompressed::SetExtent(page_id_t page_id, Extent extent) {
+  if (static_cast<size_t>(page_id) >= extents_.size()) {
+    extents_.resize(page_id + 1, Extent{0, 0});
+    dirty_.resize(page_id / EXTENTS_PER_MAP_PAGE + 1, false);
+  }
+  Extent &old = extents_[page_id];
+  if (old.size_ != 0) {
+    pending_free_.push_back(old);
+    num_pending_slots_ += NumSlots(old.size_);
+    stored_bytes_ -= old.size_;
+  }
+  stored_bytes_ += extent.size_;
+  old = extent;
+  dirty_[page_id / EXTENTS_PER_MAP_PAGE] = true;
+}
+
+/**
+ * Read the map file of an existing database file; every slot no extent covers is free
+ */
+void DiskManagerCompressed::LoadPageMap() {
+  if (db_file_size_ == 0) {
+    // A new database file: whatever page map is lying around belongs to an older file of the same name.
+    unlink(map_name_.c_str());
+    return;
+  }
+  num_slots_ = static_cast<uint32_t>((db_file_size_ + COMPRESSED_SLOT_SIZE - 1) / COMPRESSED_SLOT_SIZE);
+  map_fd_ = open(map_name_.c_str(), O_RDWR);  // NOLINT
+  if (map_fd_ < 0) {
+    LOG_WARN("%s has no page map, its pages read as zeros", file_name_.c_str());
+    AddFreeSlots(0, num_slots_);
+    return;
+  }
+
+  char data[BUSTUB_PAGE_SIZE];
+  for (size_t index = 0;; index++) {
+    if (ReadFully(map_fd_, data, BUSTUB_PAGE_SIZE, static_cast<off_t>(index) * BUSTUB_PAGE_SIZE) < BUSTUB_PAGE_SIZE) {
+      break;
+    }
+    extents_.resize((index + 1) * EXTENTS_PER_MAP_PAGE);
+    memcpy(&extents_[index * EXTENTS_PER_MAP_PAGE], data, BUSTUB_PAGE_SIZE);
+  }
+  dirty_.assign((extents_.size() + EXTENTS_PER_MAP_PAGE - 1) / EXTENTS_PER_MAP_PAGE, false);
+
+  std::vector<bool> used(num_slots_, false);
+  for (auto &extent : extents_) {
+    const uint64_t end_slot = static_cast<uint64_t>(extent.first_slot_) + NumSlots(extent.size_);
+    if (extent.size_ > BUSTUB_PAGE_SIZE || end_slot > num_slots_) {
+      LOG_WARN("dropping a page map entry past the end of %s", file_name_.c_str());
+      extent = Extent{0, 0};
+    }
+    if (extent.size_ == 0) {
+      continue;
+    }
+    std::fill(used.begin() + extent.first_slot_, used.begin() + end_slot, true);
+    stored_bytes_ += extent.size_;
+  }
+  for (uint32_t slot = 0; slot < num_slots_;) {
+    if (used[slot]) {
+      slot++;
+      continue;
+    }
+    uint32_t end = slot;
+    while (end < num_slots_ && !used[end]) {
+      end++;
+    }
+    AddFreeSlots(slot, end - slot);
+    slot = end;
+  }
+}
+
+}  // namespace bustub
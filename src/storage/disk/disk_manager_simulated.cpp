@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_simulated.cpp
+//
+// Identification: src/storage/disk/disk_manager_simulated.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_simulated.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>  // NOLINT
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** The 99th percentile of the standard normal distribution. */
+constexpr double Z_P99 = 2.3263478740408408;
+
+/** Waits shorter than this are spun instead of slept, the OS may oversleep by about as much. */
+constexpr auto SPIN_THRESHOLD = std::chrono::microseconds(100);
+
+}  // namespace
+
+auto DiskProfile::FromName(const std::string &name) -> DiskProfile {
+  using std::chrono::microseconds;
+  DiskProfile profile;
+  if (name == "ram") {
+    return profile;
+  }
+  if (name == "nvme") {
+    profile.read_p50_ = microseconds(80);
+    profile.read_p99_ = microseconds(250);
+    profile.write_p50_ = microseconds(20);
+    profile.write_p99_ = microseconds(100);
+    profile.max_iops_ = 500000;
+    profile.max_bytes_per_second_ = 3000UL * 1024 * 1024;
+    return profile;
+  }
+  if (name == "slow-ssd") {
+    profile.read_p50_ = microseconds(150);
+    profile.read_p99_ = microseconds(1000);
+    profile.write_p50_ = microseconds(300);
+    profile.write_p99_ = microseconds(3000);
+    profile.max_iops_ = 20000;
+    profile.max_bytes_per_second_ = 300UL * 1024 * 1024;
+    return profile;
+  }
+  if (name == "cloud") {
+    profile.read_p50_ = microseconds(1000);
+    profile.read_p99_ = microseconds(5000);
+    profile.write_p50_ = microseconds(2000);
+    profile.write_p99_ = microseconds(10000);
+    profile.max_iops_ = 3000;
+    profile.max_bytes_per_second_ = 125UL * 1024 * 1024;
+    return profile;
+  }
+  throw Exception("unknown disk profile: " + name + ", expected ram, nvme, slow-ssd or cloud");
+}
+
+DiskManagerSimulated::DiskManagerSimulated(const DiskProfile &profile, uint64_t seed)
+    : profile_(profile), rng_(seed) {}
+
+void DiskManagerSimulated::WritePage(page_id_t page_id, const char *page_data) {
+  ScopedLatency latency(&write_latency_);
+  WaitUntil(Submit(1, true));
+  DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+}
+
+void DiskManagerSimulated::ReadPage(page_id_t page_id, char *page_data) {
+  ScopedLatency latency(&read_latency_);
+  WaitUntil(Submit(1, false));
+  DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+}
+
+void DiskManagerSimulated::WritePages(const std::vector<PageIo> &pages) {
+  ScopedLatency latency(&write_latency_);
+  WaitUntil(Submit(pages.size(), true));
+  for (const auto &page : pages) {
+    DiskManagerUnlimitedMemory::WritePage(page.page_id_, page.data_);
+  }
+}
+
+void DiskManagerSimulated::ReadPages(const std::vector<PageIo> &pages) {
+  ScopedLatency latency(&read_latency_);
+  WaitUntil(Submit(pages.size(), false));
+  for (const auto &page : pages) {
+    DiskManagerUnlimitedMemory::ReadPage(page.page_id_, page.data_);
+  }
+}
+
+/**
+ * Pace the I/Os under the caps and draw their latencies.
+ */
+auto DiskManagerSimulated::Submit(size_t num_ios, bool is_write) -> Clock::time_point {
+  // The device starts one I/O every `interval` at most, whichever of the two caps is tighter.
+  Clock::duration interval{0};
+  if (profile_.max_iops_ > 0) {
+    interval = std::chrono::nanoseconds(1000000000UL / profile_.max_iops_);
+  }
+  if (profile_.max_bytes_per_second_ > 0) {
+    interval = std::max<Clock::duration>(
+        interval, std::chrono::nanoseconds(static_cast<uint64_t>(BUSTUB_PAGE_SIZE) * 1000000000UL /
+                                           profile_.max_bytes_per_second_));
+  }
+  const auto p50 = is_write ? profile_.write_p50_ : profile_.read_p50_;
+  const auto p99 = is_write ? profile_.write_p99_ : profile_.read_p99_;
+
+  std::scoped_lock<std::mutex> lock(device_latch_);
+  // An idle device does not bank its unused budget.
+  auto start = std::max(Clock::now(), next_start_);
+  auto done = start;
+  for (size_t i = 0; i < num_ios; i++) {
+    done = std::max(done, start + DrawLatency(p50, p99));
+    start += interval;
+  }
+  next_start_ = start;
+  return done;
+}
+
+auto DiskManagerSimulated::DrawLatency(std::chrono::microseconds p50, std::chrono::microseconds p99)
+    -> Clock::duration {
+  if (p50.count() <= 0) {
+    return Clock::duration{0};
+  }
+  const double mu = std::log(static_cast<double>(p50.count()));
+  const double sigma = p99 > p50 ? (std::log(static_cast<double>(p99.count())) - mu) / Z_P99 : 0.0;
+  const double us = sigma > 0 ? std::exp(mu + sigma * normal_(rng_)) : static_cast<double>(p50.count());
+  return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::micro>(us));
+}
+
+void DiskManagerSimulated::WaitUntil(Clock::time_point deadline) {
+  for (auto now = Clock::now(); now < deadline; now = Clock::now()) {
+    if (deadline - now > SPIN_THRESHOLD) {
+      std::this_thread::sleep_for(deadline - now - SPIN_THRESHOLD);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,307 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.cpp
+//
+// Identification: src/storage/disk/disk_manager_uring.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_uring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <numeric>
+#include <thread>  // NOLINT
+
+#include "common/logger.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define BUSTUB_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bustub {
+
+#ifdef BUSTUB_HAVE_IO_URING
+
+/**
+ * The submission and completion queues shared with the kernel. liburing is not required: the rings are set up and
+ * driven with the raw system calls.
+ */
+struct DiskManagerUring::Ring {
+  int fd_{-1};
+  void *sq_ptr_{MAP_FAILED};
+  size_t sq_size_{0};
+  void *cq_ptr_{MAP_FAILED};
+  size_t cq_size_{0};
+  io_uring_sqe *sqes_{static_cast<io_uring_sqe *>(MAP_FAILED)};
+  size_t sqes_size_{0};
+  uint32_t sq_entries_{0};
+
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+
+  ~Ring() {
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) {
+      munmap(cq_ptr_, cq_size_);
+    }
+    if (sq_ptr_ != MAP_FAILED) {
+      munmap(sq_ptr_, sq_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  /** @return false if the kernel refused to set up the ring */
+  auto Init(uint32_t queue_depth) -> bool {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+    if (fd_ < 0) {
+      return false;
+    }
+    sq_entries_ = params.sq_entries;
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    }
+
+    sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED) {
+      return false;
+    }
+    cq_ptr_ = single_mmap ? sq_ptr_
+                          : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                                 IORING_OFF_CQ_RING);
+    if (cq_ptr_ == MAP_FAILED) {
+      return false;
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe *>(
+        mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+    if (sqes_ == MAP_FAILED) {
+      return false;
+    }
+
+    auto *sq = static_cast<char *>(sq_ptr_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    auto *cq = static_cast<char *>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  /** Queue one read or write. The caller makes sure that the submission queue has room for it. */
+  void Push(bool is_write, int fd, char *data, uint64_t offset, uint64_t user_data) {
+    const unsigned tail = *sq_tail_;
+    const unsigned index = tail & *sq_mask_;
+    io_uring_sqe *sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = is_write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = BUSTUB_PAGE_SIZE;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    sq_array_[index] = index;
+    // The kernel must see the entry before the new tail.
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  /** Submit `to_submit` queued entries and wait until `wait_for` completions are available. */
+  auto Enter(unsigned to_submit, unsigned wait_for) -> int {
+    return static_cast<int>(
+        syscall(__NR_io_uring_enter, fd_, to_submit, wait_for, IORING_ENTER_GETEVENTS, nullptr, 0));
+  }
+
+  /** Pop one completion. @return false if the completion queue is empty */
+  auto Pop(io_uring_cqe *cqe) -> bool {
+    const unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      return false;
+    }
+    *cqe = cqes_[head & *cq_mask_];
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+};
+
+#else
+
+struct DiskManagerUring::Ring {
+  auto Init(uint32_t queue_depth) -> bool {
+    errno = ENOSYS;
+    return false;
+  }
+};
+
+#endif
+
+DiskManagerUring::DiskManagerUring(const std::string &db_file, bool direct_io, uint32_t queue_depth)
+    : DiskManager(db_file, direct_io), ring_(std::make_unique<Ring>()) {
+  if (!ring_->Init(queue_depth)) {
+    LOG_WARN("io_uring is not available (%s), falling back to synchronous I/O", strerror(errno));
+    ring_.reset();
+  }
+}
+
+DiskManagerUring::~DiskManagerUring() = default;
+
+void DiskManagerUring::WritePages(const std::vector<PageIo> &pages) { RunBatch(pages, true); }
+
+void DiskManagerUring::ReadPages(const std::vector<PageIo> &pages) { RunBatch(pages, false); }
+
+auto DiskManagerUring::IsUringAvailable() -> bool {
+  std::scoped_lock<std::mutex> lock(ring_latch_);
+  return ring_ != nullptr;
+}
+
+void DiskManagerUring::RunBatch(const std::vector<PageIo> &pages, bool is_write) {
+  // A single page gains nothing from the ring, and pread/pwrite lets concurrent callers run in parallel.
+  if (pages.size() == 1) {
+    if (is_write) {
+      DiskManager::WritePage(pages[0].page_id_, pages[0].data_);
+    } else {
+      DiskManager::ReadPage(pages[0].page_id_, pages[0].data_);
+    }
+    return;
+  }
+  for (auto index : SubmitAndWait(pages, is_write)) {
+    if (is_write) {
+      DiskManager::WritePage(pages[index].page_id_, pages[index].data_);
+    } else {
+      DiskManager::ReadPage(pages[index].page_id_, pages[index].data_);
+    }
+  }
+}
+
+#ifdef BUSTUB_HAVE_IO_URING
+
+auto DiskManagerUring::SubmitAndWait(const std::vector<PageIo> &pages, bool is_write) -> std::vector<size_t> {
+  std::vector<size_t> retry;
+  std::scoped_lock<std::mutex> lock(ring_latch_);
+  if (ring_ == nullptr) {
+    retry.resize(pages.size());
+    std::iota(retry.begin(), retry.end(), 0);
+    return retry;
+  }
+
+  // What became of each page. Pages still pending when the ring is done with them were never submitted.
+  enum class Outcome : uint8_t { PENDING, DONE, RETRY };
+  std::vector<Outcome> outcomes(pages.size(), Outcome::PENDING);
+  std::chrono::steady_clock::time_point start;
+  // Take the completions there are, and return how many.
+  auto reap = [&]() {
+    unsigned reaped = 0;
+    io_uring_cqe cqe;
+    while (ring_->Pop(&cqe)) {
+      reaped++;
+      const auto index = static_cast<size_t>(cqe.user_data);
+      if (cqe.res < 0 || (is_write && cqe.res != BUSTUB_PAGE_SIZE)) {
+        outcomes[index] = Outcome::RETRY;
+        continue;
+      }
+      outcomes[index] = Outcome::DONE;
+      (is_write ? write_latency_ : read_latency_).Record(std::chrono::steady_clock::now() - start);
+      if (is_write) {
+        num_writes_ += 1;
+        ExtendFileSize(static_cast<int64_t>(pages[index].page_id_ + 1) * BUSTUB_PAGE_SIZE);
+      } else if (cqe.res < BUSTUB_PAGE_SIZE) {
+        // The file ends in the middle of the page.
+        memset(pages[index].data_ + cqe.res, 0, BUSTUB_PAGE_SIZE - cqe.res);
+      }
+    }
+    return reaped;
+  };
+
+  size_t next = 0;
+  while (next < pages.size()) {
+    unsigned queued = 0;
+    for (; next < pages.size() && queued < ring_->sq_entries_; next++) {
+      const PageIo &page = pages[next];
+      const auto offset = static_cast<int64_t>(page.page_id_) * BUSTUB_PAGE_SIZE;
+      // The synchronous path already knows how to zero-fill reads past the end and to bounce unaligned buffers.
+      if ((!is_write && offset >= db_file_size_.load()) ||
+          (direct_io_ && reinterpret_cast<uintptr_t>(page.data_) % DIRECT_IO_ALIGNMENT != 0)) {
+        outcomes[next] = Outcome::RETRY;
+        continue;
+      }
+      ring_->Push(is_write, db_fd_, page.data_, offset, next);
+      queued++;
+    }
+    if (queued == 0) {
+      continue;
+    }
+
+    // Every page of the chunk is timed from the submission to its completion.
+    start = std::chrono::steady_clock::now();
+    unsigned submitted = 0;
+    unsigned completed = 0;
+    while (completed < queued) {
+      int ret = ring_->Enter(queued - submitted, 1);
+      if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        // Nothing more can be submitted. Entries the kernel did not take stay pending and are retried below.
+        LOG_WARN("io_uring_enter failed: %s", strerror(errno));
+        break;
+      }
+      if (ret > 0) {
+        submitted += ret;
+      }
+      completed += reap();
+    }
+    num_submissions_ += 1;
+    if (completed < queued) {
+      // The entries the kernel took may still be in flight, and must land before their buffers are touched again.
+      while (completed < submitted) {
+        if (ring_->Enter(0, 1) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+          std::this_thread::yield();
+        }
+        completed += reap();
+      }
+      // The ring is in an unknown state; give up on it for good and redo the rest of the batch synchronously.
+      ring_.reset();
+      break;
+    }
+  }
+  for (size_t i = 0; i < pages.size(); i++) {
+    if (outcomes[i] != Outcome::DONE) {
+      retry.push_back(i);
+    }
+  }
+  return retry;
+}
+
+#else
+
+auto DiskManagerUring::SubmitAndWait(const std::vector<PageIo> &pages, bool is_write) -> std::vector<size_t> {
+  std::vector<size_t> retry(pages.size());
+  std::iota(retry.begin(), retry.end(), 0);
+  return retry;
+}
+
+#endif
+
+}  // namespace bustub
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include <utility>
+
+namespace bustub {
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, size_t num_workers) : disk_manager_(disk_manager) {
+  BUSTUB_ASSERT(num_workers > 0, "a disk scheduler needs at least one worker");
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back(&DiskScheduler::RunWorker, this);
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void DiskScheduler::Schedule(DiskRequest request) {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    BUSTUB_ASSERT(!shutdown_, "cannot schedule I/O on a disk scheduler that is shutting down");
+    queue_.push_back(std::move(request));
+  }
+  cv_.notify_one();
+}
+
+void DiskScheduler::RunWorker() {
+  while (true) {
+    std::vector<DiskRequest> batch;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      cv_.wait(lock, [this] { return shutdown_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      // Take everything that piled up, so that the disk manager can submit it as one batch.
+      while (!queue_.empty() && batch.size() < IO_URING_QUEUE_DEPTH) {
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+    }
+    std::vector<DiskManager::PageIo> writes;
+    std::vector<DiskManager::PageIo> reads;
+    for (auto &request : batch) {
+      (request.is_write_ ? writes : reads).push_back({request.page_id_, request.data_});
+    }
+    if (!writes.empty()) {
+      disk_manager_->WritePages(writes);
+    }
+    if (!reads.empty()) {
+      disk_manager_->ReadPages(reads);
+    }
+    for (auto &request : batch) {
+      if (request.callback_) {
+        request.callback_();
+      }
+    }
+  }
+}
+
+}  // namespace bustub
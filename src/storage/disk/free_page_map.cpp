@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map.cpp
+//
+// Identification: src/storage/disk/free_page_map.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/free_page_map.h"
+
+#include <cstring>
+
+namespace bustub {
+
+void FreePageMap::Free(page_id_t page_id) {
+  BUSTUB_ASSERT(page_id >= 0, "cannot free an invalid page id");
+  std::scoped_lock<std::mutex> lock(latch_);
+  Reserve(page_id);
+  uint64_t &word = words_[page_id / 64];
+  const uint64_t bit = uint64_t{1} << (page_id % 64);
+  if ((word & bit) == 0) {
+    word |= bit;
+    num_free_++;
+    dirty_[page_id / PAGES_PER_BITMAP_PAGE] = true;
+  }
+}
+
+auto FreePageMap::Take(page_id_t limit, page_id_t stride, page_id_t offset) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (num_free_ == 0) {
+    return INVALID_PAGE_ID;
+  }
+  for (size_t i = 0; i < words_.size(); i++) {
+    // Visit the set bits of the word from the lowest up.
+    for (uint64_t bits = words_[i]; bits != 0; bits &= bits - 1) {
+      const auto page_id = static_cast<page_id_t>(i * 64 + __builtin_ctzll(bits));
+      if (page_id >= limit) {
+        return INVALID_PAGE_ID;
+      }
+      if (page_id % stride == offset) {
+        words_[i] &= ~(uint64_t{1} << (page_id % 64));
+        num_free_--;
+        dirty_[page_id / PAGES_PER_BITMAP_PAGE] = true;
+        return page_id;
+      }
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+void FreePageMap::Use(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (num_free_ == 0 || static_cast<size_t>(page_id / 64) >= words_.size()) {
+    return;
+  }
+  uint64_t &word = words_[page_id / 64];
+  const uint64_t bit = uint64_t{1} << (page_id % 64);
+  if ((word & bit) != 0) {
+    word &= ~bit;
+    num_free_--;
+    dirty_[page_id / PAGES_PER_BITMAP_PAGE] = true;
+  }
+}
+
+auto FreePageMap::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return num_free_;
+}
+
+auto FreePageMap::NumBitmapPages() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return dirty_.size();
+}
+
+void FreePageMap::ReadBitmapPage(size_t index, char *data) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(index < dirty_.size(), "bitmap page out of range");
+  memcpy(data, &words_[index * WORDS_PER_BITMAP_PAGE], BUSTUB_PAGE_SIZE);
+  dirty_[index] = false;
+}
+
+void FreePageMap::WriteBitmapPage(size_t index, const char *data) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  Reserve(static_cast<page_id_t>((index + 1) * PAGES_PER_BITMAP_PAGE - 1));
+  uint64_t *words = &words_[index * WORDS_PER_BITMAP_PAGE];
+  for (size_t i = 0; i < WORDS_PER_BITMAP_PAGE; i++) {
+    num_free_ -= __builtin_popcountll(words[i]);
+  }
+  memcpy(words, data, BUSTUB_PAGE_SIZE);
+  for (size_t i = 0; i < WORDS_PER_BITMAP_PAGE; i++) {
+    num_free_ += __builtin_popcountll(words[i]);
+  }
+}
+
+auto FreePageMap::DirtyBitmapPages() -> std::vector<size_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<size_t> dirty;
+  for (size_t i = 0; i < dirty_.size(); i++) {
+    if (dirty_[i]) {
+      dirty.push_back(i);
+    }
+  }
+  return dirty;
+}
+
+void FreePageMap::Reserve(page_id_t page_id) {
+  const size_t num_bitmap_pages = page_id / PAGES_PER_BITMAP_PAGE + 1;
+  if (num_bitmap_pages > dirty_.size()) {
+    words_.resize(num_bitmap_pages * WORDS_PER_BITMAP_PAGE);
+    dirty_.resize(num_bitmap_pages);
+  }
+}
+
+}  // namespace bustub
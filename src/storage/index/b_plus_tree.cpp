@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <deque>
 #include <string>
+#include <utility>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -14,12 +17,17 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manag
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
-      leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {
+      key_format_(KeyFormat::Of(comparator)),
+      // Either half of a split node has to fit into a page, however badly its keys compress.
+      leaf_max_size_(std::min(leaf_max_size, 2 * LeafPage::GetCapacity(key_format_))),
+      internal_max_size_(std::min(internal_max_size, 2 * InternalPage::GetCapacity(key_format_) - 1)) {
   std::cout << "[BPLUSTREE_TYPE::BPlusTree] - "
-            << "leaf_max_size:" << leaf_max_size << ", internal_max_size:" << internal_max_size << std::endl;
+            << "leaf_max_size:" << leaf_max_size_ << ", internal_max_size:" << internal_max_size_ << std::endl;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() { DisableSwizzling(); }
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
@@ -35,13 +43,12 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_P
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
-  auto [_, leaf_node] = FindLeafNode(key, Operation::Search, transaction);
-  for (int i = 0; i < leaf_node->GetSize(); i++) {
-    if (comparator_(leaf_node->KeyAt(i), key) == 0) {
-      result->push_back(leaf_node->ValueAt(i));
-      break;
-    }
+  auto [leaf_page, leaf_node] = FindLeafNode(key, Operation::Search, transaction);
+  const int idx = leaf_node->BinarySearchByKey(key, comparator_);
+  if (idx < leaf_node->GetSize() && comparator_(leaf_node->KeyAt(idx), key) == 0) {
+    result->push_back(leaf_node->ValueAt(idx));
   }
+  leaf_page->RUnlatch();
   buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
   return !result->empty();
 }
@@ -53,42 +60,67 @@ auto BPLUSTREE_TYPE::UnlockAndUnpinPage(Page *page, const bool is_dirty) const -
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::UnlockAndUnpinTxn(Transaction *txn) const -> void{
+auto BPLUSTREE_TYPE::UnlockAndUnpinTxn(Transaction *txn, const bool is_dirty) const -> void{
   for (const auto page: *txn->GetPageSet()){
-    UnlockAndUnpinPage(page, false);
+    UnlockAndUnpinPage(page, is_dirty);
   }
   txn->GetPageSet()->clear();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::IsSafe(BPlusTreePage* page, Operation& op) -> bool{
+  // Besides its size, a node that stores its keys compressed needs room for the bytes of the key that comes or goes.
   if(op == Operation::Insert){
-    return  page->GetSize() != page->GetMaxSize();
+    // A leaf splits when it reaches its max size, an inner node when it would exceed it.
+    if (page->IsLeafPage()) {
+      return page->GetSize() < page->GetMaxSize() - 1 && reinterpret_cast<LeafPage *>(page)->HasRoomForAnyKey();
+    }
+    return page->GetSize() < page->GetMaxSize() && reinterpret_cast<InternalPage *>(page)->HasRoomForAnyKey();
+  }
+  if (page->IsLeafPage()) {
+    return !reinterpret_cast<LeafPage *>(page)->IsUnderfull(1);
   }
-  return page->GetSize() > page->GetMinSize();
+  return !reinterpret_cast<InternalPage *>(page)->IsUnderfull(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::FindLeafNode(const KeyType &key, Operation op, Transaction *txn, const bool left_most) -> std::pair<Page*, LeafPage*> {
+auto BPLUSTREE_TYPE::FindLeafNode(const KeyType &key, Operation op, Transaction *txn, const LeafPosition position)
+    -> std::pair<Page *, LeafPage *> {
+  if (op == Operation::Search) {
+    for (int attempt = 0; attempt < OPTIMISTIC_SEARCH_ATTEMPTS; attempt++) {
+      auto *leaf_page = FindLeafNodeOptimistic(key, position, op);
+      if (leaf_page != nullptr) {
+        return std::make_pair(leaf_page, reinterpret_cast<LeafPage *>(leaf_page->GetData()));
+      }
+    }
+  }
+
   root_latch_.lock();
 //  bool is_root_latch = true;
 
-  auto page = buffer_pool_manager_->FetchPage(root_page_id_);
-  assert(page->GetPageId() == root_page_id_);
-
-  auto current = reinterpret_cast<BPlusTreePage *>(page->GetData());
-  // 只有一个root节点，不用锁page，因为有root_latch
-//  if(current->GetSize() == 0){
-//    return std::make_pair(page, reinterpret_cast<LeafPage *>(current));
-//  }
-
-  if(op == Operation::Search){
-    page->RLatch();
-  }else{
-    page->WLatch();
-    if (txn != nullptr) {
-      txn->AddIntoPageSet(page);
+  Page *page;
+  while (true) {
+    const page_id_t root_page_id = root_page_id_;
+    page = FetchPage(root_page_id);
+    if (op == Operation::Search) {
+      page->RLatch();
+    } else {
+      page->WLatch();
+    }
+    // A delete that collapses the root changes root_page_id_ under the latch of the old root only.
+    if (root_page_id_ == root_page_id) {
+      break;
+    }
+    if (op == Operation::Search) {
+      page->RUnlatch();
+    } else {
+      page->WUnlatch();
     }
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+  }
+  auto current = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (op != Operation::Search && txn != nullptr) {
+    txn->AddIntoPageSet(page);
   }
   root_latch_.unlock();
 
@@ -96,14 +128,14 @@ auto BPLUSTREE_TYPE::FindLeafNode(const KeyType &key, Operation op, Transaction
     auto *internal_page = reinterpret_cast<InternalPage *>(current);
 
     int idx = 0;
-    if (comparator_(key, {}) != 0) {
+    if (position == LeafPosition::Key) {
       idx = internal_page->BinarySearchByKey(key, comparator_);
-    } else if (!left_most) {
+    } else if (position == LeafPosition::RightMost) {
       idx = internal_page->GetSize() - 1;
     }
 
     auto child_page_id = internal_page->ValueAt(idx);
-    auto child_page = buffer_pool_manager_->FetchPage(child_page_id);
+    auto child_page = FetchPage(child_page_id);
     auto child_tree_page = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
 
     if(op == Operation::Search){
@@ -116,7 +148,7 @@ auto BPLUSTREE_TYPE::FindLeafNode(const KeyType &key, Operation op, Transaction
 //      }
     } else if(txn != nullptr){
       child_page->WLatch();
-      txn->AddIntoPageSet(child_page);
+      // A safe child cannot split or merge into its ancestors, so they are released; the child itself stays latched.
       if(IsSafe(child_tree_page, op)){
 //        if(is_root_latch){
 //          root_latch_.unlock();
@@ -124,6 +156,7 @@ auto BPLUSTREE_TYPE::FindLeafNode(const KeyType &key, Operation op, Transaction
 //        }
         UnlockAndUnpinTxn(txn);
       }
+      txn->AddIntoPageSet(child_page);
     }
 
     page = child_page;
@@ -132,6 +165,305 @@ auto BPLUSTREE_TYPE::FindLeafNode(const KeyType &key, Operation op, Transaction
   return std::make_pair(page, reinterpret_cast<LeafPage *>(current));
 }
 
+/*
+ * Descend to the leaf of key without latching the inner nodes: every node is read optimistically, and its version is
+ * validated before the child pointer read from it is followed, and again once the child is pinned, so the child was
+ * still the right one when its own version was taken. Only the leaf is read latched.
+ *
+ * With swizzling, a swizzled inner page is reached through the pointer the tree keeps next to its parent instead of
+ * the buffer pool, and needs no pin of its own. A pointer is only used if the frame holds the page the parent points
+ * to; slots shifted by a split just miss, and the page is fetched and the slot swizzled again.
+ *
+ * For an insert or a delete the leaf is write latched instead, so concurrent writers to different leaves only meet
+ * on the leaf latches. The caller must fall back to FindLeafNode() if the leaf turns out to need a split or a merge.
+ * @return the latched leaf page, or nullptr if a writer got in the way
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafNodeOptimistic(const KeyType &key, const LeafPosition position, const Operation op)
+    -> Page * {
+  const page_id_t root_page_id = root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  const bool swizzling = swizzling_;
+  // where page is referenced from, its entry if this search reached it as a swizzled page, and whether this search
+  // holds a pin on it instead
+  std::atomic<SwizzledPage *> *swip = swizzling ? &root_swip_ : nullptr;
+  SwizzledPage *swizzled = swizzling ? root_swip_.load(std::memory_order_acquire) : nullptr;
+  Page *page = swizzled != nullptr ? swizzled->page_.load(std::memory_order_acquire) : nullptr;
+  page_id_t page_id = root_page_id;
+  bool pinned = false;
+  if (page == nullptr || page->GetPageId() != root_page_id) {
+    swizzled = nullptr;
+    page = FetchPage(root_page_id);
+    if (page == nullptr) {
+      return nullptr;
+    }
+    pinned = true;
+  }
+  uint64_t version;
+  // A page reached without a pin may be unswizzled and its frame reused at any time. Unswizzling bumps the version,
+  // and the frame is rebound to the new page before it is read in, so checking the page id after the version tells if
+  // the reads came from the right page.
+  auto validate = [&]() { return page->ValidateRead(version) && (pinned || page->GetPageId() == page_id); };
+  // The old root of a split is write latched while the root changes, so a root that was read unlatched is known to
+  // still be the root if root_page_id_ did not move before the version was taken.
+  if (!page->OptimisticRLatch(&version) || !validate() || root_page_id_ != root_page_id) {
+    if (pinned) {
+      buffer_pool_manager_->UnpinPage(root_page_id, false);
+    }
+    return nullptr;
+  }
+
+  while (true) {
+    auto *current = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (current->IsLeafPage()) {
+      // Only inner pages are swizzled, a leaf reached without a pin is a stale root.
+      if (!pinned) {
+        return nullptr;
+      }
+      if (op == Operation::Search) {
+        page->RLatch();
+        if (page->ValidateRead(version)) {
+          return page;
+        }
+        page->RUnlatch();
+        break;
+      }
+      // Taking the write latch bumps the version once, any other bump is a writer that got in first.
+      page->WLatch();
+      if (page->ValidateRead(version + 1)) {
+        return page;
+      }
+      page->WUnlatch();
+      break;
+    }
+
+    // The node may be torn by a writer, so nothing read from it is trusted before it is validated.
+    auto *internal_page = reinterpret_cast<InternalPage *>(current);
+    const int size = internal_page->GetSize();
+    if (size < 1 || size > internal_max_size_) {
+      break;
+    }
+    int idx = 0;
+    if (position == LeafPosition::Key) {
+      idx = internal_page->BinarySearchByKey(key, comparator_);
+    } else if (position == LeafPosition::RightMost) {
+      idx = size - 1;
+    }
+    const page_id_t child_page_id = internal_page->ValueAt(idx);
+    if (!validate()) {
+      break;
+    }
+
+    // The frame of a swizzled page stays put, so only then can the tree keep pointers to its children.
+    if (pinned && swip != nullptr) {
+      swizzled = Swizzle(page, swip);
+      pinned = swizzled == nullptr;
+    }
+    std::atomic<SwizzledPage *> *child_swip = nullptr;
+    SwizzledPage *child_swizzled = nullptr;
+    Page *child_page = nullptr;
+    if (swizzled != nullptr && idx <= internal_max_size_) {
+      child_swip = &swizzled->children_[idx];
+      child_swizzled = child_swip->load(std::memory_order_acquire);
+      child_page = child_swizzled != nullptr ? child_swizzled->page_.load(std::memory_order_acquire) : nullptr;
+      if (child_page != nullptr && child_page->GetPageId() != child_page_id) {
+        child_page = nullptr;
+      }
+    }
+    bool child_pinned = false;
+    if (child_page == nullptr) {
+      child_swizzled = nullptr;
+      child_page = FetchPage(child_page_id);
+      if (child_page == nullptr) {
+        break;
+      }
+      child_pinned = true;
+    }
+    uint64_t child_version;
+    if (!child_page->OptimisticRLatch(&child_version) ||
+        (!child_pinned && child_page->GetPageId() != child_page_id) || !validate()) {
+      if (child_pinned) {
+        buffer_pool_manager_->UnpinPage(child_page_id, false);
+      }
+      break;
+    }
+    if (pinned) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    page = child_page;
+    page_id = child_page_id;
+    version = child_version;
+    swip = child_swip;
+    swizzled = child_swizzled;
+    pinned = child_pinned;
+  }
+  if (pinned) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  return nullptr;
+}
+
+/*
+ * Point swip at the entry of page, swizzling the page first if it is not swizzled yet. The pin of the caller is handed
+ * over to a page it swizzles, and released if the page was swizzled already.
+ * @return the entry of the page, or nullptr if the caller keeps its pin, because there are too many swizzled pages
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Swizzle(Page *page, std::atomic<SwizzledPage *> *swip) -> SwizzledPage * {
+  const page_id_t page_id = page->GetPageId();
+  std::unique_lock<std::mutex> lock(swizzle_latch_);
+  auto it = swizzled_pages_.find(page_id);
+  if (it != swizzled_pages_.end()) {
+    // The page is pinned in the same frame, so another slot can point at it without a pin of its own, e.g. after a
+    // split shifted the slots of its parent.
+    SwizzledPage *swizzled = it->second;
+    swip->store(swizzled, std::memory_order_release);
+    lock.unlock();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return swizzled;
+  }
+  if (!swizzling_ || swizzled_pages_.size() >= max_swizzled_pages_) {
+    return nullptr;
+  }
+
+  SwizzledPage *swizzled;
+  if (free_swizzled_pages_.empty()) {
+    swizzled = swizzled_page_entries_.emplace_back(std::make_unique<SwizzledPage>()).get();
+    swizzled->children_ = std::make_unique<std::atomic<SwizzledPage *>[]>(internal_max_size_ + 1);
+  } else {
+    swizzled = free_swizzled_pages_.back();
+    free_swizzled_pages_.pop_back();
+    for (int i = 0; i <= internal_max_size_; i++) {
+      swizzled->children_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+  swizzled->page_.store(page, std::memory_order_release);
+  swizzled_pages_.emplace(page_id, swizzled);
+  num_swizzled_pages_ = swizzled_pages_.size();
+  swip->store(swizzled, std::memory_order_release);
+  return swizzled;
+}
+
+/*
+ * Take a page out of the swizzled pages. The caller holds swizzle_latch_, and owns the pin of the page afterwards.
+ * @return the page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::DetachSwizzledPage(typename std::unordered_map<page_id_t, SwizzledPage *>::iterator it)
+    -> Page * {
+  SwizzledPage *swizzled = it->second;
+  Page *page = swizzled->page_.exchange(nullptr, std::memory_order_acq_rel);
+  SwizzledPage *root = swizzled;
+  root_swip_.compare_exchange_strong(root, nullptr, std::memory_order_acq_rel);
+  swizzled_pages_.erase(it);
+  num_swizzled_pages_ = swizzled_pages_.size();
+  free_swizzled_pages_.push_back(swizzled);
+  return page;
+}
+
+/*
+ * Unswizzle and unpin a page if it is swizzled, e.g. before it is deleted. Nobody may hold the latch of the page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Unswizzle(page_id_t page_id) {
+  Page *page;
+  {
+    std::scoped_lock<std::mutex> lock(swizzle_latch_);
+    auto it = swizzled_pages_.find(page_id);
+    if (it == swizzled_pages_.end()) {
+      return;
+    }
+    page = DetachSwizzledPage(it);
+  }
+  // Searches that reached the page as a swizzled page hold no pin on it, bumping its version makes them start over
+  // before the frame can be reused.
+  page->WLatch();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+}
+
+/*
+ * Unswizzle and unpin some swizzled page, so that the buffer pool can evict it. Any page will do, but the root goes
+ * last. Pages latched by an operation, which may be the caller itself, are skipped.
+ * @return false if no page could be unswizzled
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::UnswizzleVictim() -> bool {
+  Page *page = nullptr;
+  page_id_t page_id = INVALID_PAGE_ID;
+  {
+    std::scoped_lock<std::mutex> lock(swizzle_latch_);
+    for (auto it = swizzled_pages_.begin(); it != swizzled_pages_.end(); ++it) {
+      if (it->first == root_page_id_ && swizzled_pages_.size() > 1) {
+        continue;
+      }
+      if (it->second->page_.load(std::memory_order_relaxed)->TryWLatch()) {
+        page_id = it->first;
+        page = DetachSwizzledPage(it);
+        break;
+      }
+    }
+  }
+  if (page == nullptr) {
+    return false;
+  }
+  // Taking the latch bumped the version, see Unswizzle().
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return true;
+}
+
+/*
+ * Fetch a page of the tree. Swizzled pages keep their frames only as long as nothing else needs them: while the buffer
+ * pool has no frame left, they are unswizzled one by one.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchPage(page_id_t page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  while (page == nullptr && UnswizzleVictim()) {
+    page = buffer_pool_manager_->FetchPage(page_id);
+  }
+  return page;
+}
+
+/*
+ * Allocate a page for the tree, unswizzling pages like FetchPage() does.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewPage(page_id_t *page_id) -> Page * {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  while (page == nullptr && UnswizzleVictim()) {
+    page = buffer_pool_manager_->NewPage(page_id);
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::EnableSwizzling(size_t max_swizzled_pages) {
+  std::scoped_lock<std::mutex> lock(swizzle_latch_);
+  max_swizzled_pages_ = max_swizzled_pages;
+  swizzling_ = true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DisableSwizzling() {
+  std::scoped_lock<std::mutex> lock(swizzle_latch_);
+  swizzling_ = false;
+  root_swip_ = nullptr;
+  for (auto &[page_id, swizzled] : swizzled_pages_) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  swizzled_pages_.clear();
+  free_swizzled_pages_.clear();
+  swizzled_page_entries_.clear();
+  num_swizzled_pages_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetNumSwizzledPages() -> size_t { return num_swizzled_pages_; }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -147,48 +479,15 @@ INDEX_TEMPLATE_ARGUMENTS
 template <typename NodeType>
 auto BPLUSTREE_TYPE::NewNode() -> NodeType * {
   page_id_t new_page_id{INVALID_PAGE_ID};
-  auto *new_node = reinterpret_cast<NodeType *>(buffer_pool_manager_->NewPage(&new_page_id));
+  auto *new_node = reinterpret_cast<NodeType *>(NewPage(&new_page_id)->GetData());
   if (std::is_same<NodeType, LeafPage>::value) {
-    new_node->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_);
+    new_node->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_, key_format_);
   } else {
-    new_node->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_);
+    new_node->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_, key_format_);
   }
   return new_node;
 }
 
-INDEX_TEMPLATE_ARGUMENTS
-template <typename NodeType>
-auto BPLUSTREE_TYPE::CopyToMemory(NodeType *node) -> NodeType * {
-  auto *new_node = NewNode<NodeType>();
-  for (int i = 0; i < node->GetSize(); i++) {
-    new_node->SetIndex(i, node->IndexAt(i));
-  }
-  new_node->IncreaseSize(node->GetSize());
-  return new_node;
-}
-
-INDEX_TEMPLATE_ARGUMENTS
-template <typename NodeType>
-auto BPLUSTREE_TYPE::SplitNodes(NodeType &n, NodeType &n_new) -> void {
-  int mid = (n_new->GetSize() + 1) / 2;
-  int n_size = mid;
-  int n_new_size = n_new->GetSize() - mid;
-
-  n->SetSize(n_size);
-  for (int i = 0; i < n_size; i++) {
-    n->SetIndex(i, n_new->IndexAt(i));
-  }
-
-  n_new->SetSize(n_new_size);
-  int n_new_begin = 0;
-  if (std::is_same<NodeType, InternalPage>::value) {
-    n_new_begin = 1;
-  }
-  for (int i = n_new_begin, j = n_size; i < n_new_size; i++, j++) {
-    n_new->SetIndex(i, n_new->IndexAt(j));
-  }
-}
-
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::InsertInParent(BPlusTreePage *n, const KeyType &k_new, BPlusTreePage *n_new) -> void {
   if (n->IsRootPage()) {
@@ -210,11 +509,11 @@ auto BPLUSTREE_TYPE::InsertInParent(BPlusTreePage *n, const KeyType &k_new, BPlu
   }
 
   auto parent_id = n->GetParentPageId();
-  auto parent_page = buffer_pool_manager_->FetchPage(parent_id);
+  auto parent_page = FetchPage(parent_id);
   auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
   // 对于internal node，插入之前的size等于max_size需要拆分
   // 所以这里插入前不拆分的极端情况是max_size-1
-  if (parent->GetSize() < parent->GetMaxSize()) {
+  if (parent->GetSize() < parent->GetMaxSize() && parent->HasRoomFor(k_new)) {
     parent->Insert(k_new, n_new->GetPageId(), comparator_);
     n_new->SetParentPageId(parent_id);
     buffer_pool_manager_->UnpinPage(parent_id, true);
@@ -222,14 +521,31 @@ auto BPLUSTREE_TYPE::InsertInParent(BPlusTreePage *n, const KeyType &k_new, BPlu
   }
 
   // 这里需要注意此时internal node size已经等于max size，不能插入了
-  InternalPage *t = CopyToMemory(parent);
-  t->Insert(k_new, n_new->GetPageId(), comparator_);
-  SplitNodes(parent, t);
-  n->SetParentPageId(t->GetPageId());
-  n_new->SetParentPageId(t->GetPageId());
+  // The entries are split in memory, n_new goes right after n. The key of the first entry of t moves up.
+  auto entries = parent->GetEntries();
+  entries.insert(entries.begin() + parent->BinarySearchByKey(k_new, comparator_) + 1, {k_new, n_new->GetPageId()});
+  auto *t = NewNode<InternalPage>();
+  const auto mid = static_cast<std::ptrdiff_t>((entries.size() + 1) / 2);
+  parent->SetEntries({entries.begin(), entries.begin() + mid});
+  t->SetEntries({entries.begin() + mid, entries.end()});
+  n_new->SetParentPageId(parent_id);
+  // The children that moved to t are told their new parent. n and n_new are pinned and latched here already.
+  for (int i = 0; i < t->GetSize(); i++) {
+    const page_id_t child_page_id = t->ValueAt(i);
+    if (child_page_id == n->GetPageId()) {
+      n->SetParentPageId(t->GetPageId());
+    } else if (child_page_id == n_new->GetPageId()) {
+      n_new->SetParentPageId(t->GetPageId());
+    } else {
+      auto *child = reinterpret_cast<BPlusTreePage *>(FetchPage(child_page_id)->GetData());
+      child->SetParentPageId(t->GetPageId());
+      buffer_pool_manager_->UnpinPage(child_page_id, true);
+    }
+  }
+  // Both stay pinned until the split has moved up, or their frames could be reused under us.
+  InsertInParent(parent, entries[mid].first, t);
   buffer_pool_manager_->UnpinPage(t->GetPageId(), true);
-  buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-  InsertInParent(parent, t->KeyAt(0), t);
+  buffer_pool_manager_->UnpinPage(parent_id, true);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -244,12 +560,22 @@ auto BPLUSTREE_TYPE::NewRoot(const KeyType &key, const ValueType &value) -> void
 
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
-  std::cout << "[BPLUSTREE_TYPE::Insert] - key: [" << key << "], value: [" << value << "]" << std::endl;
   if (IsEmpty()) {
     NewRoot(key, value);
     return true;
   }
 
+  if (optimistic_writes_) {
+    if (auto inserted = InsertOptimistic(key, value); inserted.has_value()) {
+      return *inserted;
+    }
+  }
+
+  // The transaction tracks the latched pages.
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
   auto [leaf_page, leaf] = FindLeafNode(key, Operation::Insert, transaction);
   if (leaf->ExistsKey(key, comparator_)) {
     UnlockAndUnpinTxn(transaction);
@@ -258,43 +584,60 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
 
   // leaf node拆分的条件是插入后size等于max_size，这里是插入成功但是不拆分，所以需要满足小于max_size-1
   // 极端情况下等于max_size-1，插入后就需要拆分了
-  if (leaf->GetSize() < leaf->GetMaxSize() - 1) {
+  if (leaf->GetSize() < leaf->GetMaxSize() - 1 && leaf->HasRoomFor(key)) {
     leaf->Insert(key, value, comparator_);
-    UnlockAndUnpinPage(leaf, true);
+    UnlockAndUnpinPage(leaf_page, true);
     transaction->GetPageSet()->pop_back();
     UnlockAndUnpinTxn(transaction);
     return true;
   }
 
   // 这里leaf node大小已经是max_size-1，但是还能插入一个，所以直接申请一个page没问题
-  //  auto leaf_new = CopyToMemory(leaf);
-  //  leaf_new->Insert(key, value, comparator_);
-
+  // The key may not fit into the leaf any more, so the entries are split in memory.
+  auto entries = leaf->GetEntries();
+  entries.insert(entries.begin() + leaf->BinarySearchByKey(key, comparator_), {key, value});
   auto leaf_new = NewNode<LeafPage>();
-  leaf->Insert(key, value, comparator_);
-
-  //  SplitNodes(leaf, leaf_new);
-  int mid = (leaf->GetSize() + 1) / 2;
-  int n_size = mid;
-  int n_new_size = leaf->GetSize() - mid;
-
-  leaf->SetSize(n_size);
-  leaf_new->SetSize(n_new_size);
-
-  for (int i = 0, j = n_size; i < n_new_size; i++, j++) {
-    leaf_new->SetIndex(i, leaf->IndexAt(j));
-  }
+  const auto mid = static_cast<std::ptrdiff_t>((entries.size() + 1) / 2);
+  leaf->SetEntries({entries.begin(), entries.begin() + mid});
+  leaf_new->SetEntries({entries.begin() + mid, entries.end()});
 
   leaf_new->SetNextPageId(leaf->GetNextPageId());
   leaf->SetNextPageId(leaf_new->GetPageId());
 
-  InsertInParent(leaf, leaf_new->KeyAt(0), leaf_new);
-  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
+  // The parent only needs the shortest key that tells the two leaves apart.
+  InsertInParent(leaf, key_format_.Separator(entries[mid - 1].first, entries[mid].first), leaf_new);
+  UnlockAndUnpinPage(leaf_page, true);
+  transaction->GetPageSet()->pop_back();
   buffer_pool_manager_->UnpinPage(leaf_new->GetPageId(), true);
   UnlockAndUnpinTxn(transaction);
   return true;
 }
 
+/*
+ * Insert into a leaf reached by an optimistic descent, if that needs no split.
+ * @return what Insert() returns, or nothing if the insert is left to the latch crabbing descent
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertOptimistic(const KeyType &key, const ValueType &value) -> std::optional<bool> {
+  auto op = Operation::Insert;
+  auto *leaf_page = FindLeafNodeOptimistic(key, LeafPosition::Key, op);
+  if (leaf_page == nullptr) {
+    return std::nullopt;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  if (leaf->ExistsKey(key, comparator_)) {
+    UnlockAndUnpinPage(leaf_page, false);
+    return false;
+  }
+  if (leaf->GetSize() >= leaf->GetMaxSize() - 1 || !leaf->HasRoomFor(key)) {
+    UnlockAndUnpinPage(leaf_page, false);
+    return std::nullopt;
+  }
+  leaf->Insert(key, value, comparator_);
+  UnlockAndUnpinPage(leaf_page, true);
+  return true;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -307,163 +650,370 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-  std::cout << "[BPLUSTREE_TYPE::Remove] - key: " << key << std::endl;
-
   if (IsEmpty()) {
     return;
   }
 
+  if (optimistic_writes_ && RemoveOptimistic(key)) {
+    return;
+  }
+
+  // The transaction tracks the latched pages and the pages merged away.
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
   auto [leaf_page, leaf] = FindLeafNode(key, Operation::Delete, transaction);
-  DeleteEntry(leaf, key);
+  const int idx = leaf->BinarySearchByKey(key, comparator_);
+  if (idx < leaf->GetSize() && comparator_(leaf->KeyAt(idx), key) == 0) {
+    DeleteEntry(leaf, idx, transaction);
+  }
+  UnlockAndUnpinTxn(transaction, true);
+  for (const page_id_t page_id : *transaction->GetDeletedPageSet()) {
+    Unswizzle(page_id);
+    // Only an optimistic search about to fail its validation, or an index iterator, can still pin the page now.
+    if (!buffer_pool_manager_->DeletePage(page_id)) {
+      LOG_WARN("page %d of index %s is still pinned, it is not deallocated", page_id, index_name_.c_str());
+    }
+  }
+  transaction->GetDeletedPageSet()->clear();
 }
 
+/*
+ * Remove from a leaf reached by an optimistic descent, if that needs no merge or redistribution.
+ * @return false if the remove is left to the latch crabbing descent, true if it is done
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::DeleteEntry(BPlusTreePage *current, const KeyType &key) {
+auto BPLUSTREE_TYPE::RemoveOptimistic(const KeyType &key) -> bool {
+  auto op = Operation::Delete;
+  auto *leaf_page = FindLeafNodeOptimistic(key, LeafPosition::Key, op);
+  if (leaf_page == nullptr) {
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  if (!leaf->ExistsKey(key, comparator_)) {
+    UnlockAndUnpinPage(leaf_page, false);
+    return true;
+  }
+  // A root leaf may go down to one entry, the last one takes the root with it.
+  if (leaf->IsRootPage() ? leaf->GetSize() <= 1 : !IsSafe(leaf, op)) {
+    UnlockAndUnpinPage(leaf_page, false);
+    return false;
+  }
+  leaf->RemoveEntry(key, comparator_);
+  UnlockAndUnpinPage(leaf_page, true);
+  return true;
+}
+
+/*
+ * Remove the entry at index from current, which the caller holds write latched and pinned. If current ends up
+ * underfull it is merged with a sibling, which removes an entry from the parent in turn, or borrows an entry from the
+ * sibling. Pages merged away are added to the deleted page set of txn, for the caller to delete once it unlatched them.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeleteEntry(BPlusTreePage *current, const int index, Transaction *txn) {
+  bool underfull;
   if (current->IsLeafPage()) {
-    auto current_leaf = reinterpret_cast<LeafPage *>(current);
-    if (!current_leaf->RemoveEntry(key, comparator_)) {
-      return;
-    }
+    auto *current_leaf = reinterpret_cast<LeafPage *>(current);
+    current_leaf->RemoveAt(index);
+    underfull = current_leaf->IsUnderfull();
   } else {
-    auto current_internal = reinterpret_cast<InternalPage *>(current);
-    if (!current_internal->RemoveEntry(key, comparator_)) {
-      return;
-    }
+    auto *current_internal = reinterpret_cast<InternalPage *>(current);
+    current_internal->RemoveAt(index);
+    underfull = current_internal->IsUnderfull();
   }
 
   if (current->IsRootPage()) {
     if (current->IsLeafPage() && current->GetSize() == 0) {
       root_page_id_ = INVALID_PAGE_ID;
+      UpdateRootPageId(0);
+      txn->AddIntoDeletedPageSet(current->GetPageId());
+    } else if (!current->IsLeafPage() && current->GetSize() == 1) {
+      // The only child left becomes the root.
+      const page_id_t child_page_id = reinterpret_cast<InternalPage *>(current)->ValueAt(0);
+      SetParentPageId(child_page_id, INVALID_PAGE_ID);
+      root_page_id_ = child_page_id;
+      UpdateRootPageId(0);
+      txn->AddIntoDeletedPageSet(current->GetPageId());
     }
-    //    if (!current->IsLeafPage() && current->GetSize() == 1) {
-    //      auto current_internal = reinterpret_cast<InternalPage *>(current);
-    //      root_page_id_ = current_internal->ValueAt(0);
-    //    }
-    //    UpdateRootPageId(0);
     return;
   }
 
-  if (current->GetSize() >= current->GetMinSize()) {
+  if (!underfull) {
     return;
   }
 
-  auto parent_id = current->GetParentPageId();
-  auto *parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
-
-  bool exist_left_sibling;
-  KeyType parent_key{};
-  int parent_idx;
-  auto left_sibling_page_idx =
-      parent->GetLeftSiblingPageIdx(current->GetPageId(), exist_left_sibling, parent_key, parent_idx);
-  auto *leaf_sibling_page =
-      reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(left_sibling_page_idx)->GetData());
+  const page_id_t parent_id = current->GetParentPageId();
+  auto *parent = reinterpret_cast<InternalPage *>(FetchPage(parent_id)->GetData());
+  const int idx = parent->ValueIndex(current->GetPageId());
+  BUSTUB_ASSERT(idx >= 0, "a node is a child of its parent");
+  if (parent->GetSize() < 2) {
+    buffer_pool_manager_->UnpinPage(parent_id, false);
+    return;
+  }
 
-  if (leaf_sibling_page->GetSize() + current->GetSize() <= current->GetMaxSize()) {
-    CoalesceNodes(exist_left_sibling, current, leaf_sibling_page, parent_key);
-    DeleteEntry(parent, parent_key);
-  } else {
-    RedistributeNodes(exist_left_sibling, current, leaf_sibling_page, parent, parent_key, parent_idx);
+  // The sibling is the left one, but the first child has only a right one.
+  const int right_idx = idx == 0 ? 1 : idx;
+  const page_id_t sibling_id = parent->ValueAt(idx == 0 ? 1 : idx - 1);
+  Page *sibling_page = FetchPage(sibling_id);
+  sibling_page->WLatch();
+  auto *sibling = reinterpret_cast<BPlusTreePage *>(sibling_page->GetData());
+  auto *left = idx == 0 ? current : sibling;
+  auto *right = idx == 0 ? sibling : current;
+  const page_id_t right_id = right->GetPageId();
+
+  const bool merged = CoalesceNodes(left, right, parent->KeyAt(right_idx));
+  if (!merged) {
+    RedistributeNodes(left, right, idx != 0, parent, right_idx);
   }
+  sibling_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(sibling_id, true);
 
-  buffer_pool_manager_->UnpinPage(left_sibling_page_idx, true);
+  if (merged) {
+    txn->AddIntoDeletedPageSet(right_id);
+    DeleteEntry(parent, right_idx, txn);
+  }
   buffer_pool_manager_->UnpinPage(parent_id, true);
-  buffer_pool_manager_->UnpinPage(current->GetPageId(), true);
 }
 
+/*
+ * Move all the entries of right to its left sibling, if they fit into it. The key in the parent between the two is
+ * the key of the first child of right once that child moves to an inner node.
+ * @return true if right was merged into left and is to be removed from the parent
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::CoalesceNodes(const bool exist_left_sibling, BPlusTreePage *n, BPlusTreePage *sibling_page,
-                                   const KeyType &parent_key) {
-  // 默认是合并到左边兄弟节点，现在没有左边兄弟节点，则需要合入到右边兄弟节点，所以这里需要交换一下变量
-  if (!exist_left_sibling) {
-    std::swap(n, sibling_page);
+auto BPLUSTREE_TYPE::CoalesceNodes(BPlusTreePage *left, BPlusTreePage *right, const KeyType &parent_key) -> bool {
+  if (left->IsLeafPage()) {
+    auto *left_leaf = reinterpret_cast<LeafPage *>(left);
+    auto *right_leaf = reinterpret_cast<LeafPage *>(right);
+    auto entries = left_leaf->GetEntries();
+    const auto right_entries = right_leaf->GetEntries();
+    entries.insert(entries.end(), right_entries.begin(), right_entries.end());
+    // A leaf splits once it reaches its max size, a merged one has to stay below it.
+    if (static_cast<int>(entries.size()) >= left_leaf->GetMaxSize() || !left_leaf->CanHold(entries)) {
+      return false;
+    }
+    left_leaf->SetEntries(entries);
+    left_leaf->SetNextPageId(right_leaf->GetNextPageId());
+    return true;
   }
 
-  if (!n->IsLeafPage()) {
-    auto *sibling_internal = reinterpret_cast<InternalPage *>(sibling_page);
-    auto *n_internal = reinterpret_cast<InternalPage *>(n);
-    //    int begin = sibling_internal->GetSize();
-    sibling_internal->InsertAtBack(parent_key, n_internal->ValueAt(0));
-    for (int i = 1; i < n_internal->GetSize(); i++) {
-      sibling_internal->InsertAtBack(n_internal->KeyAt(i), n_internal->ValueAt(i));
-    }
-    //    for (int i = begin; i < n_internal->GetSize(); i++) {
-    //      auto child_page_id = sibling_internal->ValueAt(i);
-    //      auto child_page = buffer_pool_manager_->FetchPage(child_page_id);
-    //      auto child = reinterpret_cast<InternalPage *>(child_page->GetData());
-    //      child->SetParentPageId(sibling_internal->GetPageId());
-    //      buffer_pool_manager_->UnpinPage(child_page_id, true);
-    //    }
-  } else {
-    auto *leaf = reinterpret_cast<LeafPage *>(n);
-    auto *sibling_leaf = reinterpret_cast<LeafPage *>(sibling_page);
-    for (int i = 0; i < leaf->GetSize(); i++) {
-      sibling_leaf->InsertAtBack(leaf->KeyAt(i), leaf->ValueAt(i));
-    }
-    sibling_leaf->SetNextPageId(leaf->GetNextPageId());
+  auto *left_internal = reinterpret_cast<InternalPage *>(left);
+  auto *right_internal = reinterpret_cast<InternalPage *>(right);
+  auto entries = left_internal->GetEntries();
+  auto right_entries = right_internal->GetEntries();
+  right_entries[0].first = parent_key;
+  const int left_size = left_internal->GetSize();
+  entries.insert(entries.end(), right_entries.begin(), right_entries.end());
+  if (static_cast<int>(entries.size()) > left_internal->GetMaxSize() || !left_internal->CanHold(entries)) {
+    return false;
+  }
+  left_internal->SetEntries(entries);
+  for (size_t i = left_size; i < entries.size(); i++) {
+    SetParentPageId(entries[i].second, left_internal->GetPageId());
   }
-  buffer_pool_manager_->UnpinPage(sibling_page->GetPageId(), true);
-  buffer_pool_manager_->DeletePage(n->GetPageId());
+  return true;
 }
 
+/*
+ * Move one entry between two siblings that cannot be merged, from left to right if from_left and the other way round
+ * otherwise, and update the key at right_idx in the parent between them. Nothing moves if the donor would end up
+ * underfull itself, or the entry or the new key do not fit.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::RedistributeNodes(const bool exist_left_sibling, BPlusTreePage *n, BPlusTreePage *sibling_page,
-                                       InternalPage *parent_page, KeyType parent_key, int parent_idx) {
-  KeyType key{};
-  if (n->IsLeafPage()) {
-    auto *n_leaf = reinterpret_cast<LeafPage *>(n);
-    auto *sibling_leaf = reinterpret_cast<LeafPage *>(sibling_page);
-    // 这里不能直接交换变量，比如 (1) (2 3 4)，交换变量后redistribute就变成了(1 4)(2 3)，不符合有序
-    if (exist_left_sibling) {
-      auto last_key = sibling_leaf->KeyAt(sibling_leaf->GetSize());
-      auto last_value = sibling_leaf->ValueAt(sibling_leaf->GetSize());
-      n_leaf->InsertAtSecond(last_key, last_value);
-      sibling_leaf->RemoveEntry(last_key, comparator_);
-      key = last_key;
+void BPLUSTREE_TYPE::RedistributeNodes(BPlusTreePage *left, BPlusTreePage *right, const bool from_left,
+                                       InternalPage *parent, const int right_idx) {
+  // 这里不能直接交换变量，比如 (1) (2 3 4)，交换变量后redistribute就变成了(1 4)(2 3)，不符合有序
+  if (left->IsLeafPage()) {
+    auto *left_leaf = reinterpret_cast<LeafPage *>(left);
+    auto *right_leaf = reinterpret_cast<LeafPage *>(right);
+    if ((from_left ? left_leaf : right_leaf)->IsUnderfull(1)) {
+      return;
+    }
+    auto left_entries = left_leaf->GetEntries();
+    auto right_entries = right_leaf->GetEntries();
+    if (from_left) {
+      right_entries.insert(right_entries.begin(), left_entries.back());
+      left_entries.pop_back();
     } else {
-      auto first_key = sibling_leaf->KeyAt(1);
-      auto first_value = sibling_leaf->ValueAt(1);
-      n_leaf->InsertAtSecond(first_key, first_value);
-      sibling_leaf->RemoveEntry(first_key, comparator_);
-      key = first_key;
-    }
-    parent_page->SetKeyAt(parent_idx, key);
-    // todo need?
-    buffer_pool_manager_->UnpinPage(n->GetPageId(), true);
-    buffer_pool_manager_->UnpinPage(sibling_page->GetPageId(), true);
+      left_entries.push_back(right_entries.front());
+      right_entries.erase(right_entries.begin());
+    }
+    const KeyType separator = key_format_.Separator(left_entries.back().first, right_entries.front().first);
+    if (!parent->HasRoomToSetKey(separator) ||
+        !(from_left ? right_leaf->CanHold(right_entries) : left_leaf->CanHold(left_entries))) {
+      return;
+    }
+    left_leaf->SetEntries(left_entries);
+    right_leaf->SetEntries(right_entries);
+    parent->SetKeyAt(right_idx, separator);
+    return;
+  }
+
+  // An inner entry rotates through the parent: the key between the siblings moves down, the one of the moved child up.
+  auto *left_internal = reinterpret_cast<InternalPage *>(left);
+  auto *right_internal = reinterpret_cast<InternalPage *>(right);
+  if ((from_left ? left_internal : right_internal)->IsUnderfull(1)) {
+    return;
+  }
+  auto left_entries = left_internal->GetEntries();
+  auto right_entries = right_internal->GetEntries();
+  right_entries[0].first = parent->KeyAt(right_idx);
+  KeyType separator;
+  page_id_t child_page_id;
+  if (from_left) {
+    separator = left_entries.back().first;
+    child_page_id = left_entries.back().second;
+    right_entries.insert(right_entries.begin(), left_entries.back());
+    left_entries.pop_back();
   } else {
-    auto n_internal = reinterpret_cast<InternalPage *>(n);
-    auto sibling_internal = reinterpret_cast<InternalPage *>(sibling_page);
-    page_id_t child_page_id;
-    if (exist_left_sibling) {
-      auto last_key = sibling_internal->KeyAt(sibling_page->GetSize());
-      auto last_value = sibling_internal->ValueAt(sibling_internal->GetSize());
-      n_internal->InsertAtSecond(parent_key, last_value);
-      sibling_internal->RemoveEntry(last_key, comparator_);
-      key = last_key;
-      child_page_id = last_value;
-    } else {
-      // todo note!!!!
-      auto first_key = sibling_internal->KeyAt(1);
-      auto first_value = sibling_internal->ValueAt(1);
-      n_internal->InsertAtSecond(parent_key, first_value);
-      sibling_internal->RemoveEntry(first_key, comparator_);
-      key = first_key;
-      child_page_id = first_value;
-    }
-    parent_page->SetKeyAt(parent_idx, key);
-
-    auto child_page = buffer_pool_manager_->FetchPage(child_page_id);
-    auto child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
-    if (child_node->IsLeafPage()) {
-      auto leaf_child_node = reinterpret_cast<LeafPage *>(child_page->GetData());
-      leaf_child_node->SetParentPageId(n->GetPageId());
+    child_page_id = right_entries.front().second;
+    left_entries.push_back(right_entries.front());
+    right_entries.erase(right_entries.begin());
+    separator = right_entries.front().first;
+  }
+  auto *receiver = from_left ? right_internal : left_internal;
+  if (!parent->HasRoomToSetKey(separator) || !receiver->CanHold(from_left ? right_entries : left_entries)) {
+    return;
+  }
+  left_internal->SetEntries(left_entries);
+  right_internal->SetEntries(right_entries);
+  parent->SetKeyAt(right_idx, separator);
+  SetParentPageId(child_page_id, receiver->GetPageId());
+}
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewBulkLoadSorter(size_t memory_budget) const -> std::unique_ptr<BulkLoadSorter> {
+  return std::make_unique<BulkLoadSorter>(BulkLoadEntryLess{comparator_}, memory_budget);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoad(BulkLoadSorter *entries, double fill_factor) {
+  if (!IsEmpty()) {
+    throw Exception("can't bulk load a B+ tree that is not empty");
+  }
+  fill_factor = std::clamp(fill_factor, 0.0, 1.0);
+  // A leaf splits once it is full, an inner node only when it would overflow. No node may start out under its
+  // minimum size.
+  const size_t leaf_max_items = leaf_max_size_ - 1;
+  const size_t leaf_fill = std::clamp<size_t>(leaf_max_size_ * fill_factor, leaf_max_size_ / 2, leaf_max_items);
+  const size_t internal_max_items = internal_max_size_;
+  const size_t internal_fill =
+      std::clamp<size_t>(internal_max_size_ * fill_factor, std::max(internal_max_size_ / 2, 2), internal_max_items);
+  // Keys that compress badly fill the bytes of a node before it holds that many entries, the bytes are filled to the
+  // fill factor too.
+  const double byte_fill = std::max(fill_factor, 0.5);
+
+  // The first key and the page id of each node of the level built last. The first key of a leaf is only the
+  // separator from the leaf before it.
+  std::vector<std::pair<KeyType, page_id_t>> level;
+
+  entries->Sort();
+  std::deque<BulkLoadEntry> pending;
+  LeafPage *prev_leaf = nullptr;
+  BulkLoadEntry entry;
+  KeyType last_key{};
+  bool has_last_key = false;
+  bool more = true;
+  while (more || !pending.empty()) {
+    if (more) {
+      more = entries->Next(&entry);
+      // Equal keys are next to each other once sorted, only the first one is kept.
+      if (more && has_last_key && comparator_(entry.key_, last_key) == 0) {
+        continue;
+      }
+      if (more) {
+        pending.push_back(entry);
+        last_key = entry.key_;
+        has_last_key = true;
+      }
+    }
+    const size_t size = NextBulkLoadNodeSize(pending.size(), more, leaf_fill, leaf_max_items);
+    if (size == 0) {
+      continue;
+    }
+    auto *leaf = NewNode<LeafPage>();
+    std::vector<MappingType> leaf_entries;
+    for (size_t i = 0; i < size; i++) {
+      leaf_entries.emplace_back(pending[i].key_, pending[i].value_);
+    }
+    leaf_entries.resize(std::max(leaf->CountFitting(leaf_entries.data(), static_cast<int>(size), byte_fill), 1));
+    leaf->SetEntries(leaf_entries);
+    pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(leaf_entries.size()));
+    if (prev_leaf != nullptr) {
+      level.emplace_back(key_format_.Separator(prev_leaf->KeyAt(prev_leaf->GetSize() - 1), leaf->KeyAt(0)),
+                         leaf->GetPageId());
+      prev_leaf->SetNextPageId(leaf->GetPageId());
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
     } else {
-      auto internal_child_node = reinterpret_cast<InternalPage *>(child_page->GetData());
-      internal_child_node->SetParentPageId(n->GetPageId());
+      level.emplace_back(KeyType{}, leaf->GetPageId());
     }
-    buffer_pool_manager_->UnpinPage(child_page_id, true);
+    prev_leaf = leaf;
   }
+  if (prev_leaf == nullptr) {
+    return;
+  }
+  buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    for (size_t pos = 0; pos < level.size();) {
+      size_t size = NextBulkLoadNodeSize(level.size() - pos, false, internal_fill, internal_max_items);
+      auto *node = NewNode<InternalPage>();
+      size = std::max<size_t>(node->CountFitting(&level[pos], static_cast<int>(size), byte_fill),
+                              std::min<size_t>(size, 2));
+      // A node cut short by its bytes leaves no single child over for a node of its own.
+      if (level.size() - pos - size == 1 && size > 2) {
+        size--;
+      }
+      parents.emplace_back(level[pos].first, node->GetPageId());
+      // The key of the first child of an inner node is never looked at.
+      const auto begin = level.begin() + static_cast<std::ptrdiff_t>(pos);
+      node->SetEntries({begin, begin + static_cast<std::ptrdiff_t>(size)});
+      for (size_t i = 0; i < size; i++, pos++) {
+        SetParentPageId(level[pos].second, node->GetPageId());
+      }
+      buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
+    }
+    level = std::move(parents);
+  }
+  root_page_id_ = level[0].second;
+  UpdateRootPageId(1);
 }
+
+/*
+ * The number of items to put into the next node of a bulk loaded level. Nodes are filled to `fill` items while enough
+ * are left to fill the last nodes to their minimum size, the rest go into one node, or into two of half its size if
+ * they do not fit into one.
+ * @param pending the number of items not in a node yet
+ * @param more whether more items may follow the pending ones
+ * @param fill the number of items to fill a node with
+ * @param max_items the most items a node holds
+ * @return the number of pending items to put into the next node, 0 to wait for more items
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NextBulkLoadNodeSize(size_t pending, bool more, size_t fill, size_t max_items) -> size_t {
+  if (pending > fill + max_items) {
+    return fill;
+  }
+  if (more) {
+    return 0;
+  }
+  if (pending <= max_items) {
+    return pending;
+  }
+  return pending - pending / 2;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetParentPageId(page_id_t page_id, page_id_t parent_page_id) {
+  auto *page = FetchPage(page_id);
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(parent_page_id);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -474,7 +1024,10 @@ void BPLUSTREE_TYPE::RedistributeNodes(const bool exist_left_sibling, BPlusTreeP
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-  auto [_, left_most_leaf_node] = FindLeafNode({}, Operation::Search, nullptr);
+  auto [left_most_leaf_page, left_most_leaf_node] =
+      FindLeafNode({}, Operation::Search, nullptr, LeafPosition::LeftMost);
+  // The iterator keeps the leaf pinned, but does not latch it.
+  left_most_leaf_page->RUnlatch();
   return INDEXITERATOR_TYPE(left_most_leaf_node, buffer_pool_manager_);
 }
 
@@ -485,7 +1038,8 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-  auto [_, leaf_node] = FindLeafNode(key, Operation::Search, nullptr);
+  auto [leaf_page, leaf_node] = FindLeafNode(key, Operation::Search, nullptr);
+  leaf_page->RUnlatch();
   auto idx = leaf_node->BinarySearchByKey(key, comparator_);
   return INDEXITERATOR_TYPE(leaf_node, buffer_pool_manager_, idx);
 }
@@ -497,7 +1051,9 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
-  auto [_, right_most_leaf_node] = FindLeafNode({}, Operation::Search, nullptr, false);
+  auto [right_most_leaf_page, right_most_leaf_node] =
+      FindLeafNode({}, Operation::Search, nullptr, LeafPosition::RightMost);
+  right_most_leaf_page->RUnlatch();
   return INDEXITERATOR_TYPE(right_most_leaf_node, buffer_pool_manager_, right_most_leaf_node->GetSize());
 }
 
@@ -520,7 +1076,7 @@ auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(const int insert_record) {
-  auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  auto *header_page = static_cast<HeaderPage *>(FetchPage(HEADER_PAGE_ID));
   if (insert_record != 0) {
     // create a new record<index_name + root_page_id> in header_page
     header_page->InsertRecord(index_name_, root_page_id_);
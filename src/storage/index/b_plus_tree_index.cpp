@@ -48,6 +48,26 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::AddBulkLoadEntry(const Tuple &key, RID rid) {
+  if (bulk_load_ == nullptr) {
+    bulk_load_ = container_.NewBulkLoadSorter();
+  }
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bulk_load_->Add({index_key, rid});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::FinishBulkLoad() {
+  if (bulk_load_ == nullptr) {
+    return;
+  }
+  container_.BulkLoad(bulk_load_.get());
+  bulk_load_.reset();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return container_.Begin(); }
 
@@ -13,7 +13,9 @@ namespace bustub {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(LeafPage *current_page, BufferPoolManager *buffer_pool_manager, int arr_idx)
-    : current_page_(current_page), arr_idx_(arr_idx), buffer_pool_manager_(buffer_pool_manager) {}
+    : current_page_(current_page), arr_idx_(arr_idx), buffer_pool_manager_(buffer_pool_manager) {
+  ReadAhead();
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
@@ -22,21 +24,33 @@ INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::IsEnd() -> bool { return current_page_ == nullptr; }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return current_page_->IndexAt(arr_idx_); }
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
+  entry_ = current_page_->IndexAt(arr_idx_);
+  return entry_;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-  if (arr_idx_ == current_page_->GetSize()) {
+  arr_idx_++;
+  // The end of the last leaf is End(), the end of any other leaf is the start of the next one.
+  if (arr_idx_ == current_page_->GetSize() && current_page_->GetNextPageId() != INVALID_PAGE_ID) {
     buffer_pool_manager_->UnpinPage(current_page_->GetPageId(), false);
     auto next_page_id = current_page_->GetNextPageId();
     current_page_ = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(next_page_id)->GetData());
     arr_idx_ = 0;
-  } else {
-    arr_idx_++;
+    ReadAhead();
   }
   return *this;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::ReadAhead() {
+  // Read the next leaf while the range scan works through this one.
+  if (current_page_ != nullptr && current_page_->GetNextPageId() != INVALID_PAGE_ID) {
+    buffer_pool_manager_->PrefetchPage(current_page_->GetNextPageId());
+  }
+}
+
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
 template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
@@ -9,10 +9,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
 #include "common/exception.h"
+#include "common/macros.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 
 namespace bustub {
@@ -21,129 +23,161 @@ namespace bustub {
  *****************************************************************************/
 /*
  * Init method after creating a new internal page
- * Including set page type, set current size, set page id, set parent id and set
- * max page size
+ * Including set page type, set current size, set page id, set parent id, set
+ * max page size and set the format of the keys
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size,
+                                          const KeyFormat &format) {
+  BUSTUB_ASSERT(reinterpret_cast<char *>(&entries_) - reinterpret_cast<char *>(this) ==
+                    INTERNAL_PAGE_HEADER_SIZE - decltype(entries_)::HEADER_SIZE,
+                "unexpected internal page layout");
   SetPageType(IndexPageType::INTERNAL_PAGE);
   SetSize(0);
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetMaxSize(max_size);
+  entries_.Init(format);
 }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetCapacity(const KeyFormat &format) -> int {
+  return decltype(entries_)::GetCapacity(format) + 1;
+}
+
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
- * array offset)
+ * array offset). The first key is not stored.
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
+  return index == 0 ? KeyType{} : entries_.KeyAt(index - 1);
+}
 
+/*
+ * There must be room for the key, see HasRoomToSetKey()
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  if (index > 0) {
+    entries_.SetKeyAt(GetSize() - 1, index - 1, key);
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IndexAt(int index) const -> MappingType { return array_[index]; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IndexAt(int index) const -> MappingType { return {KeyAt(index), ValueAt(index)}; }
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  return index == 0 ? first_value_ : entries_.ValueAt(index - 1);
+}
 
+/*
+ * @return the index of the child value, -1 if it is not a child of this page
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetIndex(const size_t idx, const MappingType &m) { array_[idx] = m; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return -1;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::BinarySearchByKey(const KeyType &key, const KeyComparator &comparator) -> int {
-  auto pair_comparator = [&](const KeyType &val, const MappingType &pair) -> bool {
-    return comparator(val, pair.first) < 0;
-  };
-  return std::upper_bound(array_ + 1, array_ + GetSize(), key, pair_comparator) - array_ - 1;
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetEntries() const -> std::vector<MappingType> {
+  auto entries = entries_.GetEntries(GetSize() - 1);
+  entries.insert(entries.begin(), {KeyType{}, first_value_});
+  return entries;
 }
 
+/*
+ * Replace all entries, which must fit into the page, see CanHold()
+ */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveEntry(const KeyType &key, const KeyComparator &comparator) -> bool {
-  auto key_idx = BinarySearchByKey(key, comparator);
-  if (key_idx == GetSize()) {
-    return false;
-  }
-
-  // ArrayIndexOutOfBoundsException ?
-  for (int i = key_idx; i < GetSize(); i++) {
-    array_[key_idx] = array_[key_idx + 1];
-  }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetEntries(const std::vector<MappingType> &entries) {
+  first_value_ = entries[0].second;
+  entries_.Assign(entries.data() + 1, static_cast<int>(entries.size()) - 1);
+  SetSize(static_cast<int>(entries.size()));
+}
 
-  IncreaseSize(-1);
-  return true;
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::BinarySearchByKey(const KeyType &key, const KeyComparator &comparator) -> int {
+  // The first key is invalid; the child taken is the one of the last key not greater than key.
+  return entries_.CountBelow(GetSize() - 1, key, comparator, true);
 }
 
+/*
+ * Insert a key and the child right of it. There must be room for the key, see HasRoomFor()
+ */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator)
     -> void {
-  int be_inserted_idx = BinarySearchByKey(key, comparator) + 1;
-  for (int i = GetSize(); i > be_inserted_idx; i--) {
-    array_[i] = array_[i - 1];
-  }
-  array_[be_inserted_idx] = {key, value};
+  entries_.Insert(GetSize() - 1, BinarySearchByKey(key, comparator), key, value);
   IncreaseSize(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAtBack(const KeyType &key, const ValueType &value) -> void {
-  array_[GetSize()] = {key, value};
+  if (GetSize() == 0) {
+    first_value_ = value;
+  } else {
+    entries_.Insert(GetSize() - 1, GetSize() - 1, key, value);
+  }
   IncreaseSize(1);
 }
 
+/*
+ * Remove a child with its key. Removing the first child makes the key of the second one the invalid first key.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAtSecond(const KeyType &key, const ValueType &value) -> void {
-  int i = GetSize();
-  for (; i >= 2; i--) {
-    array_[i] = array_[i - 1];
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAt(int index) {
+  if (GetSize() > 1) {
+    if (index == 0) {
+      first_value_ = entries_.ValueAt(0);
+    }
+    entries_.Remove(GetSize() - 1, std::max(index - 1, 0));
   }
-  array_[i] = {key, value};
-  IncreaseSize(1);
+  IncreaseSize(-1);
 }
 
-// 用于删除操作时。
-// 传入子节点的page_id，找到该子节点在父节点的位置，然后返回该位置的前一个位置，也就是子节点的左兄弟节点。
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetLeftSiblingPageIdx(const ValueType &child_page_id, bool &ok, KeyType &parentKey,
-                                                           int &parent_idx) -> int {
-  for (int i = 0; i < GetSize(); i++) {
-    if (ValueAt(i) == child_page_id) {
-      if (i == 0) {
-        ok = false;
-        parentKey = KeyAt(1);
-        parent_idx = 1;
-        return 1;
-      }
-
-      ok = true;
-      parentKey = KeyAt(i);
-      parent_idx = i;
-      return i - 1;
-    }
-  }
-  throw Exception("GetLeftSiblingPageIdx failed");
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomFor(const KeyType &key) const -> bool {
+  return entries_.HasRoomFor(GetSize(), key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomToSetKey(const KeyType &key) const -> bool {
+  return entries_.HasRoomFor(GetSize() - 1, key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomForAnyKey() const -> bool { return entries_.HasRoomForAnyKeys(GetSize()); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanHold(const std::vector<MappingType> &entries) const -> bool {
+  return entries.empty() || entries_.CanHold(entries.data() + 1, static_cast<int>(entries.size()) - 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CountFitting(const MappingType *entries, int n, double fill) const -> int {
+  return n == 0 ? 0 : 1 + entries_.CountFitting(entries + 1, n - 1, fill);
+}
+
+/*
+ * Like a leaf, an internal page of keys that compress badly is only underfull if less than half of its bytes are
+ * taken too.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsUnderfull(int removed) const -> bool {
+  const int size = GetSize() - removed;
+  return size < GetMinSize() && 2 * entries_.GetUsedSize(std::max(size - 1, 0)) < INTERNAL_PAGE_DATA_SIZE;
 }
-//
-// INDEX_TEMPLATE_ARGUMENTS
-// auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::FindSmallestNumber(const KeyType &key, const KeyComparator &comparator) ->
-// ValueType{
-//    auto size = GetSize();
-//    for(int i = 0; i < size; i++){
-//      /*comparator(a,b) = 0, if a = b
-//        comparator(a,b) > 0, if a > b
-//        comparator(a,b) < 0, if a < b
-//       */
-//      if(comparator(key, array_[i].first) == -1){
-//        return array_[i].second;
-//      }
-//    }
-//    return array_[size - 1].second;
-//}
 
 // valuetype for internalNode should be page id_t
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
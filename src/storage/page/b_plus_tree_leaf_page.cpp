@@ -12,6 +12,7 @@
 #include <sstream>
 
 #include "common/exception.h"
+#include "common/macros.h"
 #include "common/rid.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
@@ -24,16 +25,25 @@ namespace bustub {
 /**
  * Init method after creating a new leaf page
  * Including set page type, set current size to zero, set page id/parent id, set
- * next page id and set max size
+ * next page id, set max size and set the format of the keys
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size, const KeyFormat &format) {
+  BUSTUB_ASSERT(reinterpret_cast<char *>(&entries_) - reinterpret_cast<char *>(this) ==
+                    LEAF_PAGE_HEADER_SIZE - decltype(entries_)::HEADER_SIZE,
+                "unexpected leaf page layout");
   SetPageType(IndexPageType::LEAF_PAGE);
   SetSize(0);
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetMaxSize(max_size);
   next_page_id_ = INVALID_PAGE_ID;
+  entries_.Init(format);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetCapacity(const KeyFormat &format) -> int {
+  return decltype(entries_)::GetCapacity(format);
 }
 
 /**
@@ -50,13 +60,29 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return entries_.KeyAt(index); }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return entries_.ValueAt(index); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IndexAt(int index) const -> MappingType {
+  return {entries_.KeyAt(index), entries_.ValueAt(index)};
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::IndexAt(int index) const -> const MappingType & { return array_[index]; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetEntries() const -> std::vector<MappingType> {
+  return entries_.GetEntries(GetSize());
+}
+
+/*
+ * Replace all entries, which must fit into the page, see CanHold()
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetEntries(const std::vector<MappingType> &entries) {
+  entries_.Assign(entries.data(), static_cast<int>(entries.size()));
+  SetSize(static_cast<int>(entries.size()));
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::ExistsKey(const KeyType &key, const KeyComparator &comparator) -> bool {
@@ -64,55 +90,69 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::ExistsKey(const KeyType &key, const KeyComparat
   return idx != GetSize() && comparator(KeyAt(idx), key) == 0;
 }
 
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetIndex(const size_t idx, const MappingType &m) { array_[idx] = m; }
-
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::BinarySearchByKey(const KeyType &key, const KeyComparator &comparator) -> int {
-  auto cmp = [&](const MappingType &element, const KeyType &val) -> bool { return comparator(element.first, val) < 0; };
-  return std::lower_bound(array_, array_ + GetSize(), key, cmp) - array_;
+  return entries_.CountBelow(GetSize(), key, comparator, false);
 }
 
+/*
+ * Insert an entry in key order. There must be room for it, see HasRoomFor()
+ */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator)
     -> void {
-  int be_inserted_idx = BinarySearchByKey(key, comparator);
-  for (int i = GetSize(); i > be_inserted_idx; i--) {
-    array_[i] = array_[i - 1];
-  }
-  array_[be_inserted_idx] = {key, value};
+  entries_.Insert(GetSize(), BinarySearchByKey(key, comparator), key, value);
   IncreaseSize(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAtBack(const KeyType &key, const ValueType &value) -> void {
-  array_[GetSize()] = {key, value};
-  IncreaseSize(1);
-}
-
-INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAtSecond(const KeyType &key, const ValueType &value) -> void {
-  int i = GetSize();
-  for (; i >= 2; i--) {
-    array_[i] = array_[i - 1];
-  }
-  array_[i] = {key, value};
+  entries_.Insert(GetSize(), GetSize(), key, value);
   IncreaseSize(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveEntry(const KeyType &key, const KeyComparator &comparator) -> bool {
   auto key_idx = BinarySearchByKey(key, comparator);
-  if (key_idx == GetSize()) {
+  if (key_idx == GetSize() || comparator(KeyAt(key_idx), key) != 0) {
     return false;
   }
+  RemoveAt(key_idx);
+  return true;
+}
 
-  for (int i = key_idx; i < GetSize() - 1; i++) {
-    array_[i] = array_[i + 1];
-  }
-
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAt(int index) {
+  entries_.Remove(GetSize(), index);
   IncreaseSize(-1);
-  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(const KeyType &key) const -> bool {
+  return entries_.HasRoomFor(GetSize() + 1, key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomForAnyKey() const -> bool { return entries_.HasRoomForAnyKeys(GetSize() + 1); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanHold(const std::vector<MappingType> &entries) const -> bool {
+  return entries_.CanHold(entries.data(), static_cast<int>(entries.size()));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CountFitting(const MappingType *entries, int n, double fill) const -> int {
+  return entries_.CountFitting(entries, n, fill);
+}
+
+/*
+ * A leaf of keys that compress badly fills up before it holds its max size of entries, so it only counts as
+ * underfull if less than half of its bytes are taken too.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsUnderfull(int removed) const -> bool {
+  const int size = GetSize() - removed;
+  return size < GetMinSize() && 2 * entries_.GetUsedSize(size) < LEAF_PAGE_DATA_SIZE;
 }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
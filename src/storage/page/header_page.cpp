@@ -12,6 +12,7 @@
 #include <cassert>
 #include <iostream>
 
+#include "common/exception.h"
 #include "storage/page/header_page.h"
 
 namespace bustub {
@@ -20,24 +21,26 @@ namespace bustub {
  * Record related
  */
 auto HeaderPage::InsertRecord(const std::string &name, const page_id_t root_id) -> bool {
-  assert(name.length() < 32);
+  assert(name.length() < NAME_SIZE);
   assert(root_id > INVALID_PAGE_ID);
+  CheckPageSize();
 
   int record_num = GetRecordCount();
-  int offset = 4 + record_num * 36;
+  int offset = OFFSET_RECORDS + record_num * RECORD_SIZE;
   // check for duplicate name
   if (FindRecord(name) != -1) {
     return false;
   }
   // copy record content
   memcpy(GetData() + offset, name.c_str(), (name.length() + 1));
-  memcpy((GetData() + offset + 32), &root_id, 4);
+  memcpy((GetData() + offset + NAME_SIZE), &root_id, 4);
 
   SetRecordCount(record_num + 1);
   return true;
 }
 
 auto HeaderPage::DeleteRecord(const std::string &name) -> bool {
+  CheckPageSize();
   int record_num = GetRecordCount();
   assert(record_num > 0);
 
@@ -46,37 +49,39 @@ auto HeaderPage::DeleteRecord(const std::string &name) -> bool {
   if (index == -1) {
     return false;
   }
-  int offset = index * 36 + 4;
-  memmove(GetData() + offset, GetData() + offset + 36, (record_num - index - 1) * 36);
+  int offset = OFFSET_RECORDS + index * RECORD_SIZE;
+  memmove(GetData() + offset, GetData() + offset + RECORD_SIZE, (record_num - index - 1) * RECORD_SIZE);
 
   SetRecordCount(record_num - 1);
   return true;
 }
 
 auto HeaderPage::UpdateRecord(const std::string &name, const page_id_t root_id) -> bool {
-  assert(name.length() < 32);
+  assert(name.length() < NAME_SIZE);
+  CheckPageSize();
 
   int index = FindRecord(name);
   // record does not exsit
   if (index == -1) {
     return false;
   }
-  int offset = index * 36 + 4;
+  int offset = OFFSET_RECORDS + index * RECORD_SIZE;
   // update record content, only root_id
-  memcpy((GetData() + offset + 32), &root_id, 4);
+  memcpy((GetData() + offset + NAME_SIZE), &root_id, 4);
 
   return true;
 }
 
 auto HeaderPage::GetRootId(const std::string &name, page_id_t *root_id) -> bool {
-  assert(name.length() < 32);
+  assert(name.length() < NAME_SIZE);
+  CheckPageSize();
 
   int index = FindRecord(name);
   // record does not exsit
   if (index == -1) {
     return false;
   }
-  int offset = (index + 1) * 36;
+  int offset = OFFSET_RECORDS + index * RECORD_SIZE + NAME_SIZE;
   *root_id = *reinterpret_cast<page_id_t *>(GetData() + offset);
 
   return true;
@@ -90,11 +95,48 @@ auto HeaderPage::GetRecordCount() -> int { return *reinterpret_cast<int *>(GetDa
 
 void HeaderPage::SetRecordCount(int record_count) { memcpy(GetData(), &record_count, 4); }
 
+// page size
+auto HeaderPage::GetPageSize() -> int { return *reinterpret_cast<int *>(GetData() + OFFSET_PAGE_SIZE); }
+
+void HeaderPage::SetPageSize(int page_size) { memcpy(GetData() + OFFSET_PAGE_SIZE, &page_size, 4); }
+
+// Header pages written before the page size was recorded hold their records right after RecordCount, so the first bytes
+// of the first record name sit where the page size is. Those databases always used 4 KB pages.
+auto HeaderPage::IsLegacyPageSize(int page_size) -> bool {
+  return page_size < LEGACY_PAGE_SIZE || page_size > 65536 || (page_size & (page_size - 1)) != 0;
+}
+
+void HeaderPage::ValidatePageSize() {
+  int page_size = GetPageSize();
+  if (page_size == 0 && GetRecordCount() == 0) {
+    return;
+  }
+  if (IsLegacyPageSize(page_size)) {
+    page_size = LEGACY_PAGE_SIZE;
+  }
+  if (page_size != BUSTUB_PAGE_SIZE) {
+    throw Exception("the database was created with a page size of " + std::to_string(page_size) +
+                    " bytes, but this build uses " + std::to_string(BUSTUB_PAGE_SIZE));
+  }
+}
+
+void HeaderPage::CheckPageSize() {
+  ValidatePageSize();
+  const int page_size = GetPageSize();
+  const int record_count = GetRecordCount();
+  if (page_size == 0 && record_count == 0) {
+    SetPageSize(BUSTUB_PAGE_SIZE);
+  } else if (IsLegacyPageSize(page_size)) {
+    memmove(GetData() + OFFSET_RECORDS, GetData() + OFFSET_PAGE_SIZE, record_count * RECORD_SIZE);
+    SetPageSize(BUSTUB_PAGE_SIZE);
+  }
+}
+
 auto HeaderPage::FindRecord(const std::string &name) -> int {
   int record_num = GetRecordCount();
 
   for (int i = 0; i < record_num; i++) {
-    char *raw_name = reinterpret_cast<char *>(GetData() + (4 + i * 36));
+    char *raw_name = reinterpret_cast<char *>(GetData() + (OFFSET_RECORDS + i * RECORD_SIZE));
     if (strcmp(raw_name, name.c_str()) == 0) {
       return i;
     }
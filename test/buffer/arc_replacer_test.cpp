@@ -0,0 +1,116 @@
+/**
+ * arc_replacer_test.cpp
+ */
+
+#include "buffer/arc_replacer.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/** Load `page_id` into `frame_id` the way the buffer pool manager does, and unpin it. */
+void Load(Replacer *replacer, frame_id_t frame_id, page_id_t page_id) {
+  replacer->SetPageId(frame_id, page_id);
+  replacer->RecordAccess(frame_id);
+  replacer->SetEvictable(frame_id, true);
+}
+
+}  // namespace
+
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer arc_replacer(4);
+
+  // Scenario: load pages 10..13 into frames 0..3. They are all seen once, so they live in T1.
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    Load(&arc_replacer, frame_id, 10 + frame_id);
+  }
+  ASSERT_EQ(4, arc_replacer.Size());
+
+  // Scenario: access frame 0 again. It moves to T2 and is now the last choice.
+  arc_replacer.RecordAccess(0);
+
+  // Scenario: T1 is above its target size of 0, so the least recently used frame of T1 goes first.
+  int value;
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_EQ(0, arc_replacer.GetTargetT1Size());
+
+  // Scenario: page 11 comes back while it is in B1. T1 was too small, so its target grows, and the page is
+  // admitted straight into T2.
+  Load(&arc_replacer, 1, 11);
+  ASSERT_EQ(1, arc_replacer.GetTargetT1Size());
+
+  // Scenario: T1 = [3, 2] is still above its target, so it shrinks once. Then T1 = [3] is at its target, and the
+  // least recently used frames of T2 = [1, 0] go before it.
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_FALSE(arc_replacer.Evict(&value));
+  ASSERT_EQ(0, arc_replacer.Size());
+
+  // Scenario: page 10 comes back while it is in B2. T2 was too small, so the target of T1 shrinks.
+  Load(&arc_replacer, 0, 10);
+  ASSERT_EQ(0, arc_replacer.GetTargetT1Size());
+}
+
+TEST(ARCReplacerTest, PinnedFramesAreSkipped) {
+  ARCReplacer arc_replacer(3);
+
+  Load(&arc_replacer, 0, 0);
+  Load(&arc_replacer, 1, 1);
+  Load(&arc_replacer, 2, 2);
+  arc_replacer.RecordAccess(2);
+  arc_replacer.SetEvictable(0, false);
+  arc_replacer.SetEvictable(1, false);
+  ASSERT_EQ(1, arc_replacer.Size());
+
+  // Scenario: T1 is preferred, but all of its frames are pinned, so the victim comes from T2.
+  int value;
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_FALSE(arc_replacer.Evict(&value));
+
+  // Scenario: removed frames are not remembered in the ghost lists.
+  arc_replacer.SetEvictable(0, true);
+  arc_replacer.Remove(0);
+  ASSERT_EQ(0, arc_replacer.Size());
+  Load(&arc_replacer, 0, 0);
+  ASSERT_EQ(0, arc_replacer.GetTargetT1Size());
+}
+
+TEST(ARCReplacerTest, ScanDoesNotFlushFrequentPages) {
+  const size_t num_frames = 8;
+  auto replacer = Replacer::Create(ReplacerType::ARC, num_frames, 0);
+  std::vector<page_id_t> frame_to_page(num_frames, INVALID_PAGE_ID);
+
+  // Scenario: pages 0 and 1 are hot and seen twice, the rest of the pool is filled with cold pages.
+  for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(num_frames); frame_id++) {
+    Load(replacer.get(), frame_id, frame_id);
+    frame_to_page[frame_id] = frame_id;
+  }
+  replacer->RecordAccess(0);
+  replacer->RecordAccess(1);
+
+  // Scenario: a long scan of new pages only ever replaces frames of T1.
+  for (page_id_t page_id = 100; page_id < 200; page_id++) {
+    int value;
+    ASSERT_TRUE(replacer->Evict(&value));
+    ASSERT_NE(0, value);
+    ASSERT_NE(1, value);
+    Load(replacer.get(), value, page_id);
+  }
+}
+
+}  // namespace bustub
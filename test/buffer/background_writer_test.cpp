@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// background_writer_test.cpp
+//
+// Identification: test/buffer/background_writer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "buffer/test_util.h"  // NOLINT
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BackgroundWriterTest, WritesDirtyPagesAhead) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(8, disk_manager.get());
+  bpm->StartBackgroundWriter(std::chrono::milliseconds(10), 1.0);
+
+  // Scenario: the writer writes the unpinned dirty pages, and leaves the pinned one alone.
+  auto page_ids = CreatePages(bpm.get(), 8, 1);
+  ASSERT_TRUE(disk_manager->WaitForWrites(7));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(0, disk_manager->GetWrites(page_ids[0]));
+  EXPECT_EQ(7, disk_manager->GetTotalWrites());
+  bpm->StopBackgroundWriter();
+
+  // Scenario: the victims are clean now, so making room for new pages does not write anything.
+  CreatePages(bpm.get(), 7);
+  EXPECT_EQ(7, disk_manager->GetTotalWrites());
+
+  // Scenario: the pages written ahead read back intact.
+  for (size_t i = 1; i < page_ids.size(); i++) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BackgroundWriterTest, HighWatermarkWakesWriter) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(8, disk_manager.get());
+  bpm->StartBackgroundWriter(std::chrono::hours(1), 0.25);
+
+  // Scenario: 2 dirty frames are below the watermark, the writer sleeps on.
+  CreatePages(bpm.get(), 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(0, disk_manager->GetTotalWrites());
+
+  // Scenario: the third dirty frame crosses it.
+  CreatePages(bpm.get(), 1);
+  EXPECT_TRUE(disk_manager->WaitForWrites(3));
+}
+
+// NOLINTNEXTLINE
+TEST(BackgroundWriterTest, FlushAllPagesWhileInUse) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(2, 16, disk_manager.get());
+  bpm->StartBackgroundWriter(std::chrono::milliseconds(1));
+  auto page_ids = CreatePages(bpm.get(), 24);
+
+  // Scenario: checkpoints run while other threads keep fetching, modifying and unpinning pages.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> workers;
+  workers.reserve(4);
+  for (size_t t = 0; t < 4; t++) {
+    workers.emplace_back([&bpm, &page_ids, &done, t] {
+      for (size_t i = t; !done; i++) {
+        auto page_id = page_ids[i % page_ids.size()];
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        page->WLatch();
+        snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+        page->WUnlatch();
+        bpm->UnpinPage(page_id, true);
+      }
+    });
+  }
+  for (int i = 0; i < 20; i++) {
+    bpm->FlushAllPages();
+  }
+  done = true;
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // Scenario: after a final checkpoint, every page is on disk.
+  bpm->StopBackgroundWriter();
+  bpm->FlushAllPages();
+  for (auto page_id : page_ids) {
+    char data[BUSTUB_PAGE_SIZE];
+    disk_manager->ReadPage(page_id, data);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(data));
+  }
+}
+
+}  // namespace bustub
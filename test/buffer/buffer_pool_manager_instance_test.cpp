@@ -12,12 +12,18 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <future>  // NOLINT
+#include <memory>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/replacer.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
@@ -947,4 +953,109 @@ TEST(BufferPoolManagerInstanceTest, HardTest_4) {  // NOLINT
     delete disk_manager;
   }
 }
+/** A disk manager whose reads of one page block until the test releases them. */
+class BlockingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  explicit BlockingDiskManager(page_id_t blocked_page_id) : blocked_page_id_(blocked_page_id) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    if (page_id == blocked_page_id_) {
+      read_started_.set_value();
+      release_.get_future().wait();
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  page_id_t blocked_page_id_;
+  std::promise<void> read_started_;
+  std::promise<void> release_;
+};
+
+// Check that a cache miss in flight does not block hits on other pages, and that concurrent fetchers of the page being
+// read wait for that read instead of reading it again.
+TEST(BufferPoolManagerInstanceTest, MissDoesNotBlockHits) {  // NOLINT
+  const page_id_t blocked_page_id = 1;
+  auto *disk_manager = new BlockingDiskManager(blocked_page_id);
+  auto *bpm = new BufferPoolManagerInstance(10, disk_manager);
+
+  page_id_t page_id;
+  for (int i = 0; i < 3; i++) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->FlushPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  // Drop page 1 from the pool so that the next fetch of it is a miss.
+  ASSERT_TRUE(bpm->DeletePage(blocked_page_id));
+
+  auto read_started = disk_manager->read_started_.get_future();
+  auto first = std::async(std::launch::async, [&] { return bpm->FetchPage(blocked_page_id); });
+  read_started.wait();
+  auto second = std::async(std::launch::async, [&] { return bpm->FetchPage(blocked_page_id); });
+
+  // Scenario: page 0 is resident, so fetching it must not wait for the read of page 1.
+  auto hit = std::async(std::launch::async, [&] { return bpm->FetchPage(0); });
+  ASSERT_EQ(std::future_status::ready, hit.wait_for(std::chrono::seconds(5)));
+  auto *page0 = hit.get();
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "page 0"));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  // Scenario: the second fetcher of page 1 waits for the first read and shares its frame.
+  EXPECT_EQ(std::future_status::timeout, second.wait_for(std::chrono::milliseconds(50)));
+  disk_manager->release_.set_value();
+  auto *page1 = first.get();
+  ASSERT_NE(nullptr, page1);
+  EXPECT_EQ(page1, second.get());
+  EXPECT_EQ(0, strcmp(page1->GetData(), "page 1"));
+  EXPECT_EQ(2, page1->GetPinCount());
+  EXPECT_TRUE(bpm->UnpinPage(blocked_page_id, false));
+  EXPECT_TRUE(bpm->UnpinPage(blocked_page_id, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, EveryReplacerType) {  // NOLINT
+  const size_t buffer_pool_size = 4;
+  const int num_pages = 16;
+
+  for (auto replacer_type : {ReplacerType::LRU, ReplacerType::CLOCK, ReplacerType::LRU_K, ReplacerType::ARC,
+                             ReplacerType::TWO_QUEUE}) {
+    SCOPED_TRACE(Replacer::ReplacerTypeToString(replacer_type));
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get(), LRUK_REPLACER_K,
+                                                           nullptr, replacer_type);
+
+    // Scenario: create more pages than there are frames, so that every policy has to evict.
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      ASSERT_EQ(i, page_id);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", i);
+      ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+
+    // Scenario: read the pages back twice, the second pass in reverse, and check that nothing was lost.
+    for (int round = 0; round < 2; round++) {
+      for (int i = 0; i < num_pages; i++) {
+        page_id_t page_id = round == 0 ? i : num_pages - 1 - i;
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        ASSERT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+        ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    }
+
+    // Scenario: with every frame pinned, no policy may hand out a victim.
+    for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); page_id++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    }
+    page_id_t page_id;
+    ASSERT_EQ(nullptr, bpm->NewPage(&page_id));
+  }
+}
+
 }  // namespace bustub
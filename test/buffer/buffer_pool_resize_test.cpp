@@ -0,0 +1,221 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_resize_test.cpp
+//
+// Identification: test/buffer/buffer_pool_resize_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "buffer/test_util.h"  // NOLINT
+#include "common/bustub_instance.h"
+#include "common/exception.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+namespace {
+
+auto CheckPage(BufferPoolManager *bpm, page_id_t page_id) -> bool {
+  Page *page = bpm->FetchPage(page_id);
+  if (page == nullptr) {
+    return false;
+  }
+  bool ok = std::string(page->GetData()) == "page " + std::to_string(page_id);
+  bpm->UnpinPage(page_id, false);
+  return ok;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BufferPoolResizeTest, GrowTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(4, disk_manager.get());
+
+  // Scenario: every frame is pinned, so a new page only fits after the pool grows.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 4; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    page_ids.push_back(page_id);
+  }
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+
+  ASSERT_TRUE(bpm->Resize(3000));
+  EXPECT_EQ(3000, bpm->GetPoolSize());
+  for (int i = 0; i < 2996; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+
+  // The pages pinned before the resize are still where they were.
+  for (auto id : page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(id, false));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolResizeTest, ShrinkTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+
+  // Scenario: the frames that go away hold dirty pages, which are written back before they are dropped.
+  auto page_ids = CreatePages(bpm.get(), 64);
+  ASSERT_EQ(64, page_ids.size());
+  ASSERT_TRUE(bpm->Resize(8));
+  EXPECT_EQ(8, bpm->GetPoolSize());
+  for (auto page_id : page_ids) {
+    EXPECT_TRUE(CheckPage(bpm.get(), page_id));
+  }
+
+  // Only 8 frames are left.
+  std::vector<page_id_t> pinned;
+  for (int i = 0; i < 8; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    pinned.push_back(page_ids[i]);
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[8]));
+  for (auto page_id : pinned) {
+    bpm->UnpinPage(page_id, false);
+  }
+
+  // It grows back.
+  ASSERT_TRUE(bpm->Resize(16));
+  EXPECT_EQ(16, CreatePages(bpm.get(), 16).size());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolResizeTest, ShrinkPinnedTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(8, disk_manager.get());
+  auto page_ids = CreatePages(bpm.get(), 8);
+  auto old_timeout = buffer_pool_resize_timeout;
+  buffer_pool_resize_timeout = std::chrono::milliseconds(50);
+
+  // Scenario: a page in a frame to remove stays pinned, so the pool cannot shrink and stays usable.
+  page_id_t pinned_page_id = INVALID_PAGE_ID;
+  for (auto page_id : page_ids) {
+    bpm->FetchPage(page_id);
+    if (bpm->GetFramePage(7)->GetPageId() == page_id) {
+      pinned_page_id = page_id;
+      break;
+    }
+    bpm->UnpinPage(page_id, false);
+  }
+  ASSERT_NE(INVALID_PAGE_ID, pinned_page_id);
+  EXPECT_FALSE(bpm->Resize(4));
+  EXPECT_EQ(8, bpm->GetPoolSize());
+  EXPECT_EQ(7, CreatePages(bpm.get(), 7).size());
+
+  // Scenario: the page is unpinned while the resize waits for it.
+  std::thread unpin([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    bpm->UnpinPage(pinned_page_id, false);
+  });
+  buffer_pool_resize_timeout = std::chrono::milliseconds(5000);
+  EXPECT_TRUE(bpm->Resize(4));
+  unpin.join();
+  EXPECT_EQ(4, bpm->GetPoolSize());
+  EXPECT_TRUE(CheckPage(bpm.get(), pinned_page_id));
+  buffer_pool_resize_timeout = old_timeout;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolResizeTest, ParallelShrinkPinnedTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(2, 4, disk_manager.get());
+  auto old_timeout = buffer_pool_resize_timeout;
+  buffer_pool_resize_timeout = std::chrono::milliseconds(50);
+
+  // Scenario: every frame of the second instance is pinned, so it cannot shrink after the first one did. The first
+  // instance gets its frames back, and the pool keeps its old size.
+  auto page_ids = CreatePages(bpm.get(), 8);
+  ASSERT_EQ(8, page_ids.size());
+  for (auto page_id : page_ids) {
+    if (page_id % 2 == 1) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    }
+  }
+  EXPECT_FALSE(bpm->Resize(4));
+  EXPECT_EQ(8, bpm->GetPoolSize());
+  EXPECT_EQ(4, CreatePages(bpm.get(), 4).size());
+  buffer_pool_resize_timeout = old_timeout;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolResizeTest, ConcurrentResizeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(2, 32, disk_manager.get());
+  auto page_ids = CreatePages(bpm.get(), 200);
+  ASSERT_EQ(200, page_ids.size());
+  ASSERT_TRUE(bpm->Resize(129));
+  EXPECT_EQ(129, bpm->GetPoolSize());
+
+  // Scenario: the pool grows and shrinks while other threads keep fetching pages.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t] {
+      size_t i = t;
+      while (!done) {
+        const page_id_t page_id = page_ids[i % page_ids.size()];
+        Page *page = bpm->FetchPage(page_id);
+        if (page != nullptr) {
+          EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+          bpm->UnpinPage(page_id, i % 3 == 0);
+        }
+        i += 7;
+      }
+    });
+  }
+  for (int round = 0; round < 20; round++) {
+    EXPECT_TRUE(bpm->Resize(round % 2 == 0 ? 16 : 256));
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(256, bpm->GetPoolSize());
+  for (auto page_id : page_ids) {
+    EXPECT_TRUE(CheckPage(bpm.get(), page_id));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolResizeTest, SetBufferPoolSizeTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  std::stringstream ss;
+  auto writer = SimpleStreamWriter(ss, true);
+
+  bustub->ExecuteSql("SET buffer_pool_size = 256;", writer);
+  EXPECT_EQ(256, bustub->buffer_pool_manager_->GetPoolSize());
+  bustub->ExecuteSql("SHOW buffer_pool_size;", writer);
+  EXPECT_EQ("buffer_pool_size=256\t\n", ss.str());
+
+  // ExecuteSql() would leak its transaction on the exception.
+  auto *txn = bustub->txn_manager_->Begin();
+  EXPECT_THROW(bustub->ExecuteSqlTxn("SET buffer_pool_size = 0;", writer, txn), Exception);
+  EXPECT_THROW(bustub->ExecuteSqlTxn("SET buffer_pool_size = 'lots';", writer, txn), Exception);
+  bustub->txn_manager_->Commit(txn);
+  delete txn;
+  EXPECT_EQ(256, bustub->buffer_pool_manager_->GetPoolSize());
+}
+
+}  // namespace bustub
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats_test.cpp
+//
+// Identification: test/buffer/buffer_pool_stats_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "common/bustub_instance.h"
+#include "common/stats.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BufferPoolStatsTest, CounterTest) {
+  StatCounter counter;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 1000; i++) {
+        counter.Add();
+      }
+      counter.Add(10);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(8 * 1010, counter.Get());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolStatsTest, HistogramTest) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.Snapshot().PercentileNs(50));
+
+  // 90 fast and 10 slow operations.
+  for (int i = 0; i < 90; i++) {
+    histogram.Record(std::chrono::nanoseconds(100));
+  }
+  for (int i = 0; i < 10; i++) {
+    histogram.Record(std::chrono::microseconds(100));
+  }
+  auto snapshot = histogram.Snapshot();
+  EXPECT_EQ(100, snapshot.count_);
+  EXPECT_EQ((90 * 100 + 10 * 100'000) / 100, snapshot.MeanNs());
+  // The percentiles are the upper bounds of their power-of-two buckets.
+  EXPECT_EQ(127, snapshot.PercentileNs(50));
+  EXPECT_EQ(127, snapshot.PercentileNs(90));
+  EXPECT_EQ(131071, snapshot.PercentileNs(99));
+
+  snapshot += histogram.Snapshot();
+  EXPECT_EQ(200, snapshot.count_);
+  EXPECT_EQ(127, snapshot.PercentileNs(50));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolStatsTest, BufferPoolTest) {
+  remove("stats_test.db");
+  auto *disk_manager = new DiskManager("stats_test.db");
+  auto *bpm = new ParallelBufferPoolManager(2, 4, disk_manager);
+
+  // Scenario: 16 dirty pages go through 8 frames, so the first 8 are evicted and written back.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 16; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    page_ids.push_back(page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(8, stats.pool_size_);
+  EXPECT_EQ(0, stats.hits_ + stats.misses_);
+  EXPECT_EQ(8, stats.evictions_);
+  EXPECT_EQ(8, stats.dirty_write_backs_);
+
+  // Scenario: the last 8 pages are hits, the first 8 misses.
+  for (int i = 15; i >= 0; i--) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    bpm->UnpinPage(page_ids[i], false);
+  }
+  stats = bpm->GetStats();
+  EXPECT_EQ(8, stats.hits_);
+  EXPECT_EQ(8, stats.misses_);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRatio());
+  EXPECT_EQ(16, stats.evictions_);
+  EXPECT_EQ(16, stats.dirty_write_backs_);
+
+  auto disk_stats = disk_manager->GetStats();
+  EXPECT_EQ(8, disk_stats.reads_.count_);
+  EXPECT_EQ(16, disk_stats.writes_.count_);
+
+  delete bpm;
+  delete disk_manager;
+  remove("stats_test.db");
+  remove("stats_test.log");
+  remove("stats_test.fsm");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolStatsTest, ShowStatsTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  std::stringstream ss;
+  auto writer = SimpleStreamWriter(ss, true);
+  bustub->ExecuteSql("CREATE TABLE t1(v1 int);", writer);
+
+  ss.str("");
+  EXPECT_TRUE(bustub->ExecuteSql("  show Buffer\tPool STATS ; ", writer));
+  const auto output = ss.str();
+  EXPECT_NE(std::string::npos, output.find("pool_size\t"));
+  EXPECT_NE(std::string::npos, output.find("hits\t"));
+  EXPECT_NE(std::string::npos, output.find("latch_waits\t"));
+  EXPECT_NE(std::string::npos, output.find("disk_reads\tcount="));
+  EXPECT_EQ(bustub->buffer_pool_manager_->GetStats().hits_, std::stoul(output.substr(output.find("hits\t") + 5)));
+}
+
+}  // namespace bustub
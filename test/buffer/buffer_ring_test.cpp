@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring_test.cpp
+//
+// Identification: test/buffer/buffer_ring_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_ring.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/test_util.h"  // NOLINT
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/** Fetch every page through `ring` and check its content. */
+void ScanPages(BufferPoolManager *bpm, BufferRing *ring, const std::vector<page_id_t> &page_ids) {
+  for (auto page_id : page_ids) {
+    auto *page = ring->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+}
+
+/** @return the number of disk reads needed to fetch every page again */
+auto RefetchCost(BufferPoolManager *bpm, CountingDiskManager *disk_manager, const std::vector<page_id_t> &page_ids)
+    -> size_t {
+  size_t reads = 0;
+  for (auto page_id : page_ids) {
+    const size_t before = disk_manager->GetReads(page_id);
+    EXPECT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    reads += disk_manager->GetReads(page_id) - before;
+  }
+  return reads;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, ScanKeepsHotPages) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(16, disk_manager.get());
+
+  auto hot_pages = CreatePages(bpm.get(), 8);
+
+  // Scenario: a bulk load and a full scan of 8x the remaining frames only recycle the 4 frames of the ring. Dirty
+  // ring frames are written back before they are recycled, so the scan reads back what was written.
+  BufferRing ring(bpm.get(), 4);
+  auto scan_pages = CreatePages(bpm.get(), 64, 0, &ring);
+  ScanPages(bpm.get(), &ring, scan_pages);
+  EXPECT_EQ(BULK_READ_RING_SIZE, BufferRing(bpm.get(), BufferRing::RingType::BULK_READ).GetRingSize());
+
+  // Scenario: the hot pages are all still in the buffer pool.
+  EXPECT_EQ(0, RefetchCost(bpm.get(), disk_manager.get(), hot_pages));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, ScanWithoutRingEvictsHotPages) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(16, disk_manager.get());
+
+  auto hot_pages = CreatePages(bpm.get(), 8);
+
+  // Scenario: the same workload through the shared pool flushes every hot page.
+  auto scan_pages = CreatePages(bpm.get(), 64);
+  EXPECT_EQ(hot_pages.size(), RefetchCost(bpm.get(), disk_manager.get(), hot_pages));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, SharedFrameLeavesRing) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(4, disk_manager.get());
+  BufferRing ring(bpm.get(), 2);
+
+  auto ring_pages = CreatePages(bpm.get(), 2, 0, &ring);
+
+  // Scenario: a regular fetch hits the first ring page, so the ring must not recycle its frame. The next page
+  // goes to a free frame instead, and the one after recycles the frame of the second ring page.
+  ASSERT_NE(nullptr, bpm->FetchPage(ring_pages[0]));
+  ASSERT_TRUE(bpm->UnpinPage(ring_pages[0], false));
+  CreatePages(bpm.get(), 2, 0, &ring);
+
+  EXPECT_EQ(0, RefetchCost(bpm.get(), disk_manager.get(), {ring_pages[0]}));
+  EXPECT_EQ(1, RefetchCost(bpm.get(), disk_manager.get(), {ring_pages[1]}));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, PinnedFrameIsNotRecycled) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(3, disk_manager.get());
+  BufferRing ring(bpm.get(), 1);
+
+  page_id_t pinned_page_id;
+  auto *pinned_page = ring.NewPage(&pinned_page_id);
+  ASSERT_NE(nullptr, pinned_page);
+  snprintf(pinned_page->GetData(), BUSTUB_PAGE_SIZE, "pinned");
+
+  // Scenario: the only ring frame is still pinned, so the next page takes a frame of the shared pool.
+  auto other_pages = CreatePages(bpm.get(), 2, 0, &ring);
+  EXPECT_EQ("pinned", std::string(pinned_page->GetData()));
+
+  // Scenario: with every frame pinned, the ring cannot make room either.
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->FetchPage(other_pages[0]));
+  ASSERT_NE(nullptr, bpm->FetchPage(other_pages[1]));
+  EXPECT_EQ(nullptr, ring.NewPage(&page_id));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, ParallelBufferPoolManager) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(2, 8, disk_manager.get());
+
+  auto hot_pages = CreatePages(bpm.get(), 8);
+
+  // Scenario: with 2 instances and an even ring size, every slot of the ring is always filled by the same instance.
+  BufferRing ring(bpm.get(), 4);
+  auto scan_pages = CreatePages(bpm.get(), 64, 0, &ring);
+  ScanPages(bpm.get(), &ring, scan_pages);
+
+  EXPECT_EQ(0, RefetchCost(bpm.get(), disk_manager.get(), hot_pages));
+}
+
+}  // namespace bustub
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+static auto IsAligned(const void *ptr, size_t alignment) -> bool {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, ReserveReleaseTest) {
+  for (bool use_huge_pages : {false, true}) {
+    FrameArena arena(use_huge_pages);
+    const size_t frames_per_huge_page = HUGE_PAGE_SIZE / BUSTUB_PAGE_SIZE;
+
+    // Scenario: the frames of a small arena are zeroed, aligned for O_DIRECT and do not overlap.
+    arena.Reserve(10);
+    EXPECT_EQ(10, arena.GetCapacity());
+    for (size_t i = 0; i < 10; i++) {
+      char *data = arena.FrameData(i);
+      ASSERT_TRUE(IsAligned(data, DIRECT_IO_ALIGNMENT));
+      EXPECT_EQ(0, data[0]);
+      EXPECT_EQ(0, data[BUSTUB_PAGE_SIZE - 1]);
+      memset(data, static_cast<int>(i + 1), BUSTUB_PAGE_SIZE);
+    }
+
+    // Scenario: growing the arena does not move the frames it already had. A large chunk is rounded up to whole huge
+    // pages and starts on a huge page boundary.
+    char *first = arena.FrameData(0);
+    arena.Reserve(10 + frames_per_huge_page + 1);
+    EXPECT_EQ(first, arena.FrameData(0));
+    const size_t capacity = arena.GetCapacity();
+    EXPECT_GE(capacity, 10 + frames_per_huge_page + 1);
+    if (use_huge_pages) {
+      EXPECT_EQ(0, (capacity - 10) % frames_per_huge_page);
+      EXPECT_TRUE(IsAligned(arena.FrameData(10), HUGE_PAGE_SIZE));
+    }
+    EXPECT_EQ(capacity * BUSTUB_PAGE_SIZE, arena.GetMappedBytes());
+    EXPECT_LE(arena.GetHugeTlbBytes(), arena.GetMappedBytes());
+    for (size_t i = 0; i < 10; i++) {
+      EXPECT_EQ(static_cast<char>(i + 1), arena.FrameData(i)[BUSTUB_PAGE_SIZE / 2]);
+    }
+    memset(arena.FrameData(capacity - 1), 'x', BUSTUB_PAGE_SIZE);
+
+    // Scenario: releasing the frames of the last chunk unmaps it, and reserving them again hands out zeroed frames.
+    arena.Release(10);
+    EXPECT_EQ(10, arena.GetCapacity());
+    arena.Reserve(capacity);
+    EXPECT_EQ(0, arena.FrameData(capacity - 1)[0]);
+    EXPECT_EQ(static_cast<char>(10), arena.FrameData(9)[0]);
+
+    // Scenario: a partly released chunk stays mapped.
+    arena.Release(5);
+    EXPECT_EQ(10, arena.GetCapacity());
+    arena.Reserve(10);
+    EXPECT_EQ(10, arena.GetCapacity());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, BufferPoolTest) {
+  const size_t pool_size = 64;
+  DiskManagerUnlimitedMemory disk_manager;
+  BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+
+  // Scenario: the frame metadata takes whole cache lines, and the frame data lives in the arena.
+  static_assert(alignof(Page) == CACHE_LINE_SIZE);
+  static_assert(sizeof(Page) % CACHE_LINE_SIZE == 0);
+  EXPECT_GE(bpm.GetFrameArena().GetCapacity(), pool_size);
+  std::set<char *> datas;
+  for (size_t i = 0; i < pool_size; i++) {
+    Page *page = bpm.GetFramePage(static_cast<frame_id_t>(i));
+    EXPECT_TRUE(IsAligned(page, CACHE_LINE_SIZE));
+    datas.insert(page->GetData());
+  }
+  EXPECT_EQ(pool_size, datas.size());
+
+  for (int i = 0; i < 200; i++) {
+    page_id_t page_id;
+    Page *page = bpm.NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, datas.count(page->GetData()));
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    bpm.UnpinPage(page_id, true);
+  }
+
+  // Scenario: the frames added and removed by a resize come from and go back to the arena.
+  ASSERT_TRUE(bpm.Resize(pool_size * 4));
+  EXPECT_GE(bpm.GetFrameArena().GetCapacity(), pool_size * 4);
+  for (page_id_t page_id = 0; page_id < 200; page_id++) {
+    Page *page = bpm.FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    bpm.UnpinPage(page_id, false);
+  }
+  ASSERT_TRUE(bpm.Resize(pool_size / 2));
+  EXPECT_GE(bpm.GetFrameArena().GetCapacity(), pool_size / 2);
+  for (page_id_t page_id = 0; page_id < 200; page_id++) {
+    Page *page = bpm.FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    bpm.UnpinPage(page_id, false);
+  }
+
+  // Scenario: a page outside of a buffer pool still owns its data.
+  Page page;
+  EXPECT_TRUE(IsAligned(page.GetData(), DIRECT_IO_ALIGNMENT));
+  EXPECT_EQ(0, page.GetData()[BUSTUB_PAGE_SIZE - 1]);
+}
+
+}  // namespace bustub
@@ -664,4 +664,36 @@ TEST(LRUKReplacerTest, Size6) {
   lru_replacer.Remove(4);
   ASSERT_EQ(1, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, HistoryWrapsAround) {
+  // Only the last k accesses decide the backward k-distance, no matter how many accesses came before
+  LRUKReplacer lru_replacer(10, 2);
+  int result;
+  for (int i = 0; i < 1000; ++i) {
+    lru_replacer.RecordAccess(1);
+  }
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(3);
+  lru_replacer.RecordAccess(3);
+  lru_replacer.SetEvictable(1, true);
+  lru_replacer.SetEvictable(2, true);
+  lru_replacer.SetEvictable(3, true);
+
+  // The 2nd most recent access of 1 is older than that of 2, which is older than that of 3
+  ASSERT_EQ(true, lru_replacer.Evict(&result));
+  ASSERT_EQ(1, result);
+  ASSERT_EQ(true, lru_replacer.Evict(&result));
+  ASSERT_EQ(2, result);
+
+  // Accessing a non-evictable frame must not make it a candidate
+  lru_replacer.SetEvictable(3, false);
+  lru_replacer.RecordAccess(3);
+  ASSERT_EQ(false, lru_replacer.Evict(&result));
+  lru_replacer.SetEvictable(3, true);
+  ASSERT_EQ(true, lru_replacer.Evict(&result));
+  ASSERT_EQ(3, result);
+  ASSERT_EQ(0, lru_replacer.Size());
+}
 }  // namespace bustub
@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mmap_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/mmap_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/mmap_buffer_pool_manager.h"
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/schema.h"
+#include "common/bustub_instance.h"
+#include "common/exception.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+class MmapBufferPoolManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Each test gets its own files, so that the tests can run in parallel.
+    base_ = std::string("mmap_") + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    db_file_ = base_ + ".db";
+    RemoveFiles();
+  }
+
+  void TearDown() override { RemoveFiles(); }
+
+  void RemoveFiles() {
+    remove(db_file_.c_str());
+    remove((base_ + ".log").c_str());
+    remove((base_ + ".fsm").c_str());
+  }
+
+  std::string base_;
+  std::string db_file_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(MmapBufferPoolManagerTest, ReadOnlyTest) {
+  const int num_pages = 50;
+  {
+    DiskManager disk_manager(db_file_);
+    BufferPoolManagerInstance bpm(8, &disk_manager);
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      Page *page = bpm.NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      // Page 0 stays an empty header page, which a BusTub instance checks when it opens the file.
+      if (page_id != HEADER_PAGE_ID) {
+        snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      }
+      bpm.UnpinPage(page_id, true);
+    }
+    bpm.FlushAllPages();
+    disk_manager.ShutDown();
+  }
+
+  MmapBufferPoolManager bpm(db_file_);
+  EXPECT_EQ(num_pages, bpm.GetPoolSize());
+
+  // Scenario: pages are served from the file, and the same page object is handed out by every fetch.
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    Page *page = bpm.FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_id, page->GetPageId());
+    EXPECT_EQ(page_id == HEADER_PAGE_ID ? "" : "page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(page, bpm.FetchPage(page_id));
+    EXPECT_TRUE(bpm.UnpinPage(page_id, false));
+    EXPECT_TRUE(bpm.UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(num_pages * 2, bpm.GetStats().hits_);
+
+  // Scenario: concurrent first fetches of a page agree on its page object.
+  std::vector<Page *> fetched(8);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < fetched.size(); i++) {
+    threads.emplace_back([&bpm, &fetched, i] { fetched[i] = bpm.FetchPage(num_pages - 1); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (auto *page : fetched) {
+    EXPECT_EQ(bpm.FetchPage(num_pages - 1), page);
+  }
+
+  // Scenario: nothing beyond the end of the file, and nothing can be created or deleted.
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm.FetchPage(num_pages));
+  EXPECT_FALSE(bpm.UnpinPage(num_pages, false));
+  EXPECT_EQ(nullptr, bpm.NewPage(&page_id));
+  EXPECT_FALSE(bpm.DeletePage(0));
+  EXPECT_FALSE(bpm.Resize(16));
+
+  EXPECT_THROW(MmapBufferPoolManager("mmap_test_missing.db"), Exception);
+
+  // Scenario: a read-only BusTub instance maps the file, and writes nothing next to it.
+  remove((base_ + ".log").c_str());
+  remove((base_ + ".fsm").c_str());
+  BustubInstanceOptions options;
+  options.read_only_ = true;
+  {
+    BustubInstance instance(db_file_, options);
+    EXPECT_EQ(num_pages, instance.buffer_pool_manager_->GetPoolSize());
+
+    // Scenario: statements that write are rejected before they run, and the mapping cannot be resized.
+    std::stringstream ss;
+    auto writer = SimpleStreamWriter(ss, true);
+    auto *txn = instance.txn_manager_->Begin();
+    auto rejected = [&](const std::string &sql) {
+      try {
+        instance.ExecuteSqlTxn(sql, writer, txn);
+      } catch (Exception &e) {
+        return std::string(e.what()).find("read-only") != std::string::npos;
+      }
+      return false;
+    };
+    EXPECT_TRUE(rejected("CREATE TABLE t (a INTEGER);"));
+    EXPECT_TRUE(rejected("SET buffer_pool_size = 16;"));
+    EXPECT_THROW(instance.GenerateTestTable(), Exception);
+    instance.txn_manager_->Commit(txn);
+    delete txn;
+    EXPECT_EQ(num_pages, instance.buffer_pool_manager_->GetPoolSize());
+  }
+  EXPECT_EQ(nullptr, fopen((base_ + ".log").c_str(), "r"));
+  EXPECT_EQ(nullptr, fopen((base_ + ".fsm").c_str(), "r"));
+
+  // Scenario: a compressed database file cannot be mapped.
+  options.compress_pages_ = true;
+  EXPECT_THROW(BustubInstance(db_file_, options), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(MmapBufferPoolManagerTest, TableScanTest) {
+  Schema schema({Column("id", TypeId::INTEGER), Column("payload", TypeId::VARCHAR, 1000)});
+  const std::string payload(900, 'x');
+  const size_t num_tuples = 200;
+  page_id_t first_page_id;
+  {
+    DiskManager disk_manager(db_file_);
+    BufferPoolManagerInstance bpm(8, &disk_manager);
+    Transaction txn(0);
+    TableHeap heap(&bpm, nullptr, nullptr, &txn);
+    for (size_t i = 0; i < num_tuples; i++) {
+      Tuple tuple({Value(TypeId::INTEGER, static_cast<int32_t>(i)), Value(TypeId::VARCHAR, payload)}, &schema);
+      RID rid;
+      ASSERT_TRUE(heap.InsertTuple(tuple, &rid, &txn));
+    }
+    txn.GetWriteSet()->clear();
+    first_page_id = heap.GetFirstPageId();
+    bpm.FlushAllPages();
+    disk_manager.ShutDown();
+  }
+
+  // Scenario: a table heap scans a snapshot through the mapping, with the code that scans a buffer pool.
+  MmapBufferPoolManager bpm(db_file_);
+  TableHeap heap(&bpm, nullptr, nullptr, first_page_id);
+  Transaction txn(1);
+  size_t scanned = 0;
+  for (auto it = heap.Begin(&txn); it != heap.End(); ++it) {
+    EXPECT_EQ(static_cast<int32_t>(scanned), it->GetValue(&schema, 0).GetAs<int32_t>());
+    scanned++;
+  }
+  EXPECT_EQ(num_tuples, scanned);
+}
+
+}  // namespace bustub
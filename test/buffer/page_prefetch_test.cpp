@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_prefetch_test.cpp
+//
+// Identification: test/buffer/page_prefetch_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "buffer/test_util.h"  // NOLINT
+#include "catalog/schema.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PagePrefetchTest, PrefetchedPageIsReadOnce) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(4, disk_manager.get());
+
+  // Scenario: the first pages are evicted by the last ones.
+  auto page_ids = CreatePages(bpm.get(), 8);
+
+  // Scenario: a fetch right after the prefetch waits for the background read instead of reading the page again.
+  bpm->PrefetchPage(page_ids[0]);
+  auto *page = bpm->FetchPage(page_ids[0]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page " + std::to_string(page_ids[0]), std::string(page->GetData()));
+  EXPECT_EQ(1, disk_manager->GetReads(page_ids[0]));
+  EXPECT_EQ(1, disk_manager->GetBackgroundReads());
+
+  // Scenario: the prefetch did not leave a pin behind, so a single unpin makes the page deletable.
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+  EXPECT_TRUE(bpm->DeletePage(page_ids[0]));
+
+  // Scenario: prefetching a resident page does nothing.
+  bpm->PrefetchPage(page_ids[7]);
+  EXPECT_EQ(0, disk_manager->GetReads(page_ids[7]));
+}
+
+// NOLINTNEXTLINE
+TEST(PagePrefetchTest, PrefetchIntoFullPool) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(2, disk_manager.get());
+
+  auto page_ids = CreatePages(bpm.get(), 4);
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[2]));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[3]));
+
+  // Scenario: with every frame pinned, the hint is dropped.
+  bpm->PrefetchPage(page_ids[0]);
+  EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_EQ(0, disk_manager->GetReads(page_ids[0]));
+}
+
+// NOLINTNEXTLINE
+TEST(PagePrefetchTest, FetchPageAsync) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(2, 4, disk_manager.get());
+
+  auto page_ids = CreatePages(bpm.get(), 16);
+
+  // Scenario: misses are read in the background, hits are ready right away, and both come back pinned.
+  std::vector<std::future<Page *>> futures;
+  futures.reserve(4);
+  for (size_t i = 0; i < 4; i++) {
+    futures.push_back(bpm->FetchPageAsync(page_ids[i]));
+  }
+  futures.push_back(bpm->FetchPageAsync(page_ids[15]));
+  for (size_t i = 0; i < futures.size(); i++) {
+    auto page_id = i < 4 ? page_ids[i] : page_ids[15];
+    auto *page = futures[i].get();
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(1, page->GetPinCount());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(4, disk_manager->GetBackgroundReads());
+}
+
+// NOLINTNEXTLINE
+TEST(PagePrefetchTest, TableScanReadsAhead) {
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(8, disk_manager.get());
+  Transaction txn(0);
+
+  Schema schema({Column("id", TypeId::INTEGER), Column("payload", TypeId::VARCHAR, 1000)});
+  TableHeap heap(bpm.get(), nullptr, nullptr, &txn);
+  const std::string payload(900, 'x');
+  const size_t num_tuples = 200;
+  for (size_t i = 0; i < num_tuples; i++) {
+    Tuple tuple({Value(TypeId::INTEGER, static_cast<int32_t>(i)), Value(TypeId::VARCHAR, payload)}, &schema);
+    RID rid;
+    ASSERT_TRUE(heap.InsertTuple(tuple, &rid, &txn));
+  }
+  txn.GetWriteSet()->clear();
+
+  // Scenario: every page after the first one is read ahead by the scan, with or without a ring.
+  for (bool use_ring : {false, true}) {
+    const size_t background_reads = disk_manager->GetBackgroundReads();
+    BufferRing ring(bpm.get(), 4);
+    size_t scanned = 0;
+    for (auto it = heap.Begin(&txn, use_ring ? &ring : nullptr); it != heap.End(); ++it) {
+      EXPECT_EQ(static_cast<int32_t>(scanned), it->GetValue(&schema, 0).GetAs<int32_t>());
+      scanned++;
+    }
+    EXPECT_EQ(num_tuples, scanned);
+    EXPECT_LT(background_reads + 20, disk_manager->GetBackgroundReads());
+  }
+}
+
+}  // namespace bustub
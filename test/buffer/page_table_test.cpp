@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table_test.cpp
+//
+// Identification: test/buffer/page_table_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+#include <random>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, SampleTest) {
+  PageTable table(4);
+
+  frame_id_t frame_id;
+  EXPECT_FALSE(table.Find(0, frame_id));
+  table.Insert(0, 3);
+  table.Insert(7, 1);
+  EXPECT_TRUE(table.Find(0, frame_id));
+  EXPECT_EQ(3, frame_id);
+  EXPECT_TRUE(table.Find(7, frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_EQ(2, table.Size());
+
+  // Scenario: inserting a page again remaps it.
+  table.Insert(0, 2);
+  EXPECT_TRUE(table.Find(0, frame_id));
+  EXPECT_EQ(2, frame_id);
+  EXPECT_EQ(2, table.Size());
+
+  EXPECT_TRUE(table.Remove(0));
+  EXPECT_FALSE(table.Remove(0));
+  EXPECT_FALSE(table.Find(0, frame_id));
+  EXPECT_TRUE(table.Find(7, frame_id));
+  EXPECT_EQ(1, table.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, RandomOperations) {
+  // Scenario: far more entries than expected, so the stripes grow, with removals in the middle of probe sequences.
+  PageTable table(8);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<page_id_t> page_dist(0, 2000);
+  for (int i = 0; i < 50000; i++) {
+    const page_id_t page_id = page_dist(rng);
+    if (rng() % 3 == 0) {
+      EXPECT_EQ(expected.erase(page_id) == 1, table.Remove(page_id));
+    } else {
+      const auto frame_id = static_cast<frame_id_t>(rng() % 1000);
+      table.Insert(page_id, frame_id);
+      expected[page_id] = frame_id;
+    }
+  }
+  ASSERT_EQ(expected.size(), table.Size());
+  for (page_id_t page_id = 0; page_id <= 2000; page_id++) {
+    frame_id_t frame_id;
+    auto it = expected.find(page_id);
+    ASSERT_EQ(it != expected.end(), table.Find(page_id, frame_id));
+    if (it != expected.end()) {
+      EXPECT_EQ(it->second, frame_id);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, ConcurrentOperations) {
+  PageTable table(1024);
+  const size_t num_threads = 8;
+  const page_id_t pages_per_thread = 2000;
+
+  // Scenario: every thread owns a range of pages and checks that the other threads never disturb it.
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&table, t, pages_per_thread] {
+      const auto base = static_cast<page_id_t>(t) * pages_per_thread;
+      for (int round = 0; round < 3; round++) {
+        for (page_id_t i = 0; i < pages_per_thread; i++) {
+          table.Insert(base + i, static_cast<frame_id_t>(i + round));
+        }
+        for (page_id_t i = 0; i < pages_per_thread; i++) {
+          frame_id_t frame_id;
+          ASSERT_TRUE(table.Find(base + i, frame_id));
+          ASSERT_EQ(i + round, frame_id);
+        }
+        for (page_id_t i = 0; i < pages_per_thread; i += 2) {
+          ASSERT_TRUE(table.Remove(base + i));
+        }
+        for (page_id_t i = 1; i < pages_per_thread; i += 2) {
+          frame_id_t frame_id;
+          ASSERT_TRUE(table.Find(base + i, frame_id));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * pages_per_thread / 2, table.Size());
+}
+
+}  // namespace bustub
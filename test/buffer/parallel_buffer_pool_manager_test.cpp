@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  EXPECT_EQ(num_instances * buffer_pool_size, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up every instance.
+  for (size_t i = 1; i < num_instances * buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: Once every instance is full, we should not be able to create any new pages.
+  for (size_t i = 0; i < num_instances * buffer_pool_size; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: After unpinning pages {0, 1, 2, 3, 4} we should be able to create 5 new pages again.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(i, true));
+  }
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    // Unpin the page here to allow future fetching
+    bpm->UnpinPage(page_id_temp, false);
+  }
+
+  // Scenario: We should be able to fetch the data we wrote a while ago.
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, RoundRobinAllocationTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t num_instances = 4;
+
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  // Scenario: Consecutive allocations rotate over the instances, so every instance owns its share of the page ids.
+  std::vector<size_t> pages_per_instance(num_instances, 0);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_instances * 2; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    pages_per_instance[page_id_temp % num_instances]++;
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  for (size_t i = 0; i < num_instances; i++) {
+    EXPECT_EQ(2, pages_per_instance[i]);
+  }
+
+  // Scenario: When one instance is full, allocation falls through to the others.
+  auto *pinned = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, pinned);
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_instances * buffer_pool_size - 1; i++) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    page_ids.push_back(page_id_temp);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  for (auto page_id : page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: An invalid page id is not routed to any instance.
+  EXPECT_EQ(nullptr, bpm->FetchPage(INVALID_PAGE_ID));
+  EXPECT_EQ(nullptr, bpm->FetchPageAsync(INVALID_PAGE_ID).get());
+  EXPECT_EQ(false, bpm->UnpinPage(INVALID_PAGE_ID, false));
+  EXPECT_EQ(false, bpm->FlushPage(INVALID_PAGE_ID));
+  EXPECT_EQ(false, bpm->DeletePage(INVALID_PAGE_ID));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {  // NOLINT
+  const int num_threads = 5;
+  const int num_runs = 50;
+  for (int run = 0; run < num_runs; run++) {
+    auto *disk_manager = new DiskManager("test.db");
+    std::shared_ptr<ParallelBufferPoolManager> bpm{new ParallelBufferPoolManager(5, 10, disk_manager)};
+    std::vector<std::thread> threads;
+
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.push_back(std::thread([&bpm]() {  // NOLINT
+        page_id_t temp_page_id;
+        std::vector<page_id_t> page_ids;
+        for (int i = 0; i < 10; i++) {
+          auto *new_page = bpm->NewPage(&temp_page_id, nullptr);
+          ASSERT_NE(nullptr, new_page);
+          strcpy(new_page->GetData(), std::to_string(temp_page_id).c_str());  // NOLINT
+          page_ids.push_back(temp_page_id);
+        }
+        for (int i = 0; i < 10; i++) {
+          ASSERT_EQ(1, bpm->UnpinPage(page_ids[i], true, nullptr));
+        }
+        for (int j = 0; j < 10; j++) {
+          auto *page = bpm->FetchPage(page_ids[j], nullptr);
+          ASSERT_NE(nullptr, page);
+          ASSERT_EQ(0, std::strcmp(std::to_string(page_ids[j]).c_str(), (page->GetData())));
+          ASSERT_EQ(1, bpm->UnpinPage(page_ids[j], true, nullptr));
+        }
+        for (int j = 0; j < 10; j++) {
+          ASSERT_EQ(1, bpm->DeletePage(page_ids[j], nullptr));
+        }
+      }));
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+      threads[i].join();
+    }
+
+    remove("test.db");
+    remove("test.log");
+    delete disk_manager;
+  }
+}
+
+}  // namespace bustub
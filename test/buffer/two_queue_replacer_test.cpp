@@ -0,0 +1,97 @@
+/**
+ * two_queue_replacer_test.cpp
+ */
+
+#include "buffer/two_queue_replacer.h"
+
+#include <cstdio>
+#include <memory>
+
+#include "buffer/replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/** Load `page_id` into `frame_id` the way the buffer pool manager does, and unpin it. */
+void Load(Replacer *replacer, frame_id_t frame_id, page_id_t page_id) {
+  replacer->SetPageId(frame_id, page_id);
+  replacer->RecordAccess(frame_id);
+  replacer->SetEvictable(frame_id, true);
+}
+
+}  // namespace
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  // With 8 frames, A1in is preferred for eviction while it holds more than 2 frames, and A1out remembers 4 pages.
+  TwoQueueReplacer two_queue_replacer(8);
+
+  // Scenario: load pages 0..7 into frames 0..7. They all enter A1in.
+  for (frame_id_t frame_id = 0; frame_id < 8; frame_id++) {
+    Load(&two_queue_replacer, frame_id, frame_id);
+  }
+  ASSERT_EQ(8, two_queue_replacer.Size());
+
+  // Scenario: A1in is a FIFO, so the oldest page goes first and is remembered in A1out.
+  int value;
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: page 0 comes back while it is in A1out, so it enters Am.
+  Load(&two_queue_replacer, 0, 0);
+
+  // Scenario: accessing a frame again while it is in A1in does not protect it.
+  two_queue_replacer.RecordAccess(1);
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  for (frame_id_t expected = 2; expected <= 5; expected++) {
+    ASSERT_TRUE(two_queue_replacer.Evict(&value));
+    EXPECT_EQ(expected, value);
+  }
+
+  // Scenario: A1in = [7, 6] is within its budget, so the victim now comes from Am.
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_EQ(2, two_queue_replacer.Size());
+
+  // Scenario: A1out holds at most 4 pages, [5, 4, 3, 2]. Page 1 was forgotten and enters A1in again, page 5 is
+  // still remembered and enters Am. A1in = [1, 7, 6] is over its budget once, then Am goes first.
+  Load(&two_queue_replacer, 1, 1);
+  Load(&two_queue_replacer, 5, 5);
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(6, value);
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(5, value);
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(7, value);
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_FALSE(two_queue_replacer.Evict(&value));
+}
+
+TEST(TwoQueueReplacerTest, PinAndRemove) {
+  auto replacer = Replacer::Create(ReplacerType::TWO_QUEUE, 4, 0);
+
+  Load(replacer.get(), 0, 0);
+  Load(replacer.get(), 1, 1);
+  Load(replacer.get(), 2, 2);
+  replacer->SetEvictable(0, false);
+  ASSERT_EQ(2, replacer->Size());
+
+  // Scenario: pinned frames are skipped, and removing a pinned frame has no effect.
+  replacer->Remove(0);
+  int value;
+  ASSERT_TRUE(replacer->Evict(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: removed frames are gone and not remembered in A1out.
+  replacer->Remove(2);
+  ASSERT_EQ(0, replacer->Size());
+  ASSERT_FALSE(replacer->Evict(&value));
+  replacer->SetEvictable(0, true);
+  ASSERT_TRUE(replacer->Evict(&value));
+  EXPECT_EQ(0, value);
+}
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -57,4 +58,51 @@ TEST(RWLatchTest, BasicTest) {
   }
   EXPECT_EQ(counter.Read(), 55);
 }
+
+// NOLINTNEXTLINE
+TEST(RWLatchTest, OptimisticReadTest) {
+  ReaderWriterLatch latch;
+  uint64_t version;
+  ASSERT_TRUE(latch.OptimisticRLock(&version));
+  EXPECT_TRUE(latch.Validate(version));
+
+  // Readers do not disturb optimistic readers.
+  latch.RLock();
+  latch.RUnlock();
+  EXPECT_TRUE(latch.Validate(version));
+
+  // A write latch fails the reads before it and the reads while it is held.
+  latch.WLock();
+  EXPECT_FALSE(latch.Validate(version));
+  uint64_t locked_version;
+  EXPECT_FALSE(latch.OptimisticRLock(&locked_version));
+  latch.WUnlock();
+  ASSERT_TRUE(latch.OptimisticRLock(&version));
+  EXPECT_TRUE(latch.Validate(version));
+
+  // Scenario: a writer keeps two values equal, and optimistic readers never accept a torn pair.
+  std::atomic<int> a{0};
+  std::atomic<int> b{0};
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for (int i = 1; i <= 100000; i++) {
+      latch.WLock();
+      a.store(i, std::memory_order_relaxed);
+      b.store(i, std::memory_order_relaxed);
+      latch.WUnlock();
+    }
+    done = true;
+  });
+  while (!done) {
+    if (!latch.OptimisticRLock(&version)) {
+      continue;
+    }
+    const int a_read = a.load(std::memory_order_relaxed);
+    const int b_read = b.load(std::memory_order_relaxed);
+    if (latch.Validate(version)) {
+      EXPECT_EQ(a_read, b_read);
+    }
+  }
+  writer.join();
+}
 }  // namespace bustub
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// test_util.h
+//
+// Identification: test/include/buffer/test_util.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_ring.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** Counts the reads and writes of every page, and how many of the reads ran on a thread other than the test thread. */
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      reads_[page_id]++;
+      if (std::this_thread::get_id() != test_thread_) {
+        background_reads_++;
+      }
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      writes_[page_id]++;
+      total_writes_++;
+    }
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+  auto GetReads(page_id_t page_id) -> size_t {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return reads_[page_id];
+  }
+
+  auto GetBackgroundReads() -> size_t {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return background_reads_;
+  }
+
+  auto GetWrites(page_id_t page_id) -> size_t {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return writes_[page_id];
+  }
+
+  auto GetTotalWrites() -> size_t {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return total_writes_;
+  }
+
+  /** Wait up to a few seconds until at least `n` writes happened. */
+  auto WaitForWrites(size_t n) -> bool {
+    for (int i = 0; i < 500 && GetTotalWrites() < n; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return GetTotalWrites() >= n;
+  }
+
+ private:
+  std::mutex mutex_;
+  // the thread that created the disk manager
+  const std::thread::id test_thread_{std::this_thread::get_id()};
+  std::unordered_map<page_id_t, size_t> reads_;
+  size_t background_reads_{0};
+  std::unordered_map<page_id_t, size_t> writes_;
+  size_t total_writes_{0};
+};
+
+/**
+ * Create up to `n` dirty pages that hold "page <id>", stopping early once the buffer pool runs out of frames.
+ * @param pinned the number of the first pages that stay pinned, all the others are unpinned
+ * @param ring the ring to create the pages through, or nullptr to create them in the shared pool
+ * @return the ids of the pages created
+ */
+auto CreatePages(BufferPoolManager *bpm, size_t n, size_t pinned = 0, BufferRing *ring = nullptr)
+    -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < n; i++) {
+    page_id_t page_id;
+    Page *page = ring == nullptr ? bpm->NewPage(&page_id) : ring->NewPage(&page_id);
+    if (page == nullptr) {
+      break;
+    }
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    if (i >= pinned) {
+      bpm->UnpinPage(page_id, true);
+    }
+    page_ids.push_back(page_id);
+  }
+  return page_ids;
+}
+
+}  // namespace bustub
@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/util/external_sorter.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using InternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+
+/**
+ * Check the node sizes and parent pointers of the subtree under page_id.
+ * @return the height of the subtree
+ */
+static auto CheckSubtree(BufferPoolManager *bpm, page_id_t page_id, page_id_t parent_page_id) -> int {
+  auto *node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  EXPECT_EQ(parent_page_id, node->GetParentPageId());
+  if (parent_page_id != INVALID_PAGE_ID) {
+    EXPECT_GE(node->GetSize(), node->GetMinSize());
+  }
+  int height = 1;
+  if (node->IsLeafPage()) {
+    EXPECT_LT(node->GetSize(), node->GetMaxSize());
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    EXPECT_LE(internal->GetSize(), internal->GetMaxSize());
+    EXPECT_GE(internal->GetSize(), 2);
+    height += CheckSubtree(bpm, internal->ValueAt(0), page_id);
+    for (int i = 1; i < internal->GetSize(); i++) {
+      EXPECT_EQ(height, 1 + CheckSubtree(bpm, internal->ValueAt(i), page_id));
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+  return height;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, ExternalSorterTest) {
+  std::vector<int64_t> values(10000);
+  std::iota(values.begin(), values.end(), 0);
+  std::shuffle(values.begin(), values.end(), std::mt19937(42));
+
+  // Scenario: a budget of 1000 values spills ten runs, which merge back in order.
+  ExternalSorter<int64_t> sorter(std::less<int64_t>(), 1000 * sizeof(int64_t));
+  for (auto value : values) {
+    sorter.Add(value);
+  }
+  sorter.Sort();
+  EXPECT_EQ(10, sorter.GetNumRuns());
+  int64_t value;
+  for (int64_t expected = 0; expected < 10000; expected++) {
+    ASSERT_TRUE(sorter.Next(&value));
+    ASSERT_EQ(expected, value);
+  }
+  EXPECT_FALSE(sorter.Next(&value));
+
+  // Scenario: what fits in memory is never spilled.
+  ExternalSorter<int64_t> in_memory;
+  in_memory.Add(2);
+  in_memory.Add(1);
+  in_memory.Sort();
+  EXPECT_EQ(0, in_memory.GetNumRuns());
+  ASSERT_TRUE(in_memory.Next(&value));
+  EXPECT_EQ(1, value);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(16, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  Tree tree("foo_pk", bpm, comparator, 50, 10);
+  const int64_t num_keys = 20000;
+  std::vector<int64_t> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 1);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+  // Scenario: the entries do not fit in the sort budget, and one key comes twice.
+  auto sorter = tree.NewBulkLoadSorter(1000 * sizeof(Tree::BulkLoadEntry));
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    sorter->Add({index_key, RID(key)});
+  }
+  index_key.SetFromInteger(keys[0]);
+  sorter->Add({index_key, RID(-1)});
+  tree.BulkLoad(sorter.get());
+  EXPECT_LT(0, sorter->GetNumRuns());
+
+  // Every key is found, in order, and the nodes are full up to the fill factor without breaking the tree invariants.
+  int64_t expected = 1;
+  for (auto it = tree.Begin(); it != tree.End(); ++it) {
+    ASSERT_EQ(RID(expected), (*it).second);
+    expected++;
+  }
+  EXPECT_EQ(num_keys + 1, expected);
+  // 445 leaves of 45 keys, under 50 and 6 inner nodes of 9 children, and the root.
+  EXPECT_EQ(4, CheckSubtree(bpm, tree.GetRootPageId(), INVALID_PAGE_ID));
+  page_id = tree.GetRootPageId();
+  auto *node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  while (!node->IsLeafPage()) {
+    const page_id_t child_page_id = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    bpm->UnpinPage(page_id, false);
+    page_id = child_page_id;
+    node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  }
+  EXPECT_EQ(45, node->GetSize());
+  bpm->UnpinPage(page_id, false);
+
+  // Scenario: the bulk loaded tree takes inserts that split its packed nodes.
+  auto *transaction = new Transaction(0);
+  for (int64_t key = num_keys + 1; key <= num_keys + 1000; key++) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(key), transaction));
+  }
+  std::vector<RID> result;
+  for (int64_t key = 1; key <= num_keys + 1000; key++) {
+    index_key.SetFromInteger(key);
+    result.clear();
+    ASSERT_TRUE(tree.GetValue(index_key, &result));
+    ASSERT_EQ(RID(key), result[0]);
+  }
+  CheckSubtree(bpm, tree.GetRootPageId(), INVALID_PAGE_ID);
+
+  // Scenario: only an empty tree can be bulk loaded.
+  auto again = tree.NewBulkLoadSorter();
+  EXPECT_THROW(tree.BulkLoad(again.get()), Exception);
+
+  delete transaction;
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, SmallNodesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  // Scenario: every number of keys packs into nodes of legal sizes, down to the smallest nodes and an empty tree.
+  for (int64_t num_keys = 0; num_keys <= 40; num_keys++) {
+    for (double fill_factor : {0.0, 0.5, 1.0}) {
+      auto *disk_manager = new DiskManagerUnlimitedMemory();
+      BufferPoolManager *bpm = new BufferPoolManagerInstance(16, disk_manager);
+      page_id_t page_id;
+      bpm->NewPage(&page_id);
+      {
+        Tree tree("foo_pk", bpm, comparator, 3, 3);
+        auto sorter = tree.NewBulkLoadSorter();
+        GenericKey<8> index_key;
+        for (int64_t key = num_keys; key >= 1; key--) {
+          index_key.SetFromInteger(key);
+          sorter->Add({index_key, RID(key)});
+        }
+        tree.BulkLoad(sorter.get(), fill_factor);
+        ASSERT_EQ(num_keys == 0, tree.IsEmpty());
+        if (num_keys > 0) {
+          CheckSubtree(bpm, tree.GetRootPageId(), INVALID_PAGE_ID);
+          std::vector<RID> result;
+          for (int64_t key = 1; key <= num_keys; key++) {
+            index_key.SetFromInteger(key);
+            ASSERT_TRUE(tree.GetValue(index_key, &result)) << num_keys << " keys, fill factor " << fill_factor;
+          }
+        }
+      }
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete bpm;
+      delete disk_manager;
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,378 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_compression_test.cpp
+//
+// Identification: test/storage/b_plus_tree_compression_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/b_plus_tree_key_format.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using Key = GenericKey<32>;
+using Comparator = GenericComparator<32>;
+using Tree = BPlusTree<Key, RID, Comparator>;
+using LeafPage = BPlusTreeLeafPage<Key, RID, Comparator>;
+using InternalPage = BPlusTreeInternalPage<Key, page_id_t, Comparator>;
+
+/** @return the composite key (a, b, c) of a "a bigint,b bigint,c integer" schema */
+static auto MakeKey(Schema *schema, int64_t a, int64_t b, int32_t c) -> Key {
+  Key key;
+  key.SetFromKey(Tuple({Value(TypeId::BIGINT, a), Value(TypeId::BIGINT, b), Value(TypeId::INTEGER, c)}, schema));
+  return key;
+}
+
+/** @return the i-th of a sorted run of composite keys, a thousand of them sharing their first column */
+static auto NthKey(Schema *schema, int64_t i) -> Key {
+  return MakeKey(schema, i / 1000 - 10, i % 1000 * 7919, static_cast<int32_t>(i % 7));
+}
+
+/** @return -1, 0 or 1 as the first bytes of two encoded keys compare */
+static auto CompareEncoded(const char *lhs, const char *rhs, size_t size) -> int {
+  const int cmp = memcmp(lhs, rhs, size);
+  return (cmp > 0) - (cmp < 0);
+}
+
+/**
+ * Check the parent pointers of the subtree under page_id, and that all of its keys are in order and in [low, high),
+ * where a null bound is no bound.
+ * @return the number of entries in the subtree
+ */
+static auto CheckSubtree(BufferPoolManager *bpm, const Comparator &comparator, page_id_t page_id,
+                         page_id_t parent_page_id, const Key *low, const Key *high) -> int {
+  auto *node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  EXPECT_EQ(parent_page_id, node->GetParentPageId());
+  int count = 0;
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      const Key key = leaf->KeyAt(i);
+      EXPECT_TRUE(low == nullptr || comparator(*low, key) <= 0);
+      EXPECT_TRUE(high == nullptr || comparator(key, *high) < 0);
+      EXPECT_TRUE(i == 0 || comparator(leaf->KeyAt(i - 1), key) < 0);
+    }
+    count = leaf->GetSize();
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    std::vector<Key> keys;
+    for (int i = 0; i < internal->GetSize(); i++) {
+      keys.push_back(internal->KeyAt(i));
+    }
+    for (int i = 0; i < internal->GetSize(); i++) {
+      const Key *child_low = i == 0 ? low : &keys[i];
+      const Key *child_high = i + 1 == internal->GetSize() ? high : &keys[i + 1];
+      count += CheckSubtree(bpm, comparator, internal->ValueAt(i), page_id, child_low, child_high);
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+  return count;
+}
+
+/** @return the number of leaves of the tree, and the height of the tree */
+static auto CountLeaves(BufferPoolManager *bpm, page_id_t root_page_id) -> std::pair<int, int> {
+  int height = 1;
+  page_id_t page_id = root_page_id;
+  auto *node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  while (!node->IsLeafPage()) {
+    const page_id_t child = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    bpm->UnpinPage(page_id, false);
+    page_id = child;
+    node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+    height++;
+  }
+  int leaves = 1;
+  for (auto *leaf = reinterpret_cast<LeafPage *>(node); leaf->GetNextPageId() != INVALID_PAGE_ID; leaves++) {
+    const page_id_t next = leaf->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
+    page_id = next;
+    leaf = reinterpret_cast<LeafPage *>(bpm->FetchPage(page_id)->GetData());
+  }
+  bpm->UnpinPage(page_id, false);
+  return {leaves, height};
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeCompressionTest, KeyFormatTest) {
+  auto key_schema = ParseCreateStatement("a bigint,b bigint,c integer");
+  Comparator comparator(key_schema.get());
+  const auto format = KeyFormat::Of(comparator);
+  ASSERT_TRUE(format.IsNormalized());
+  ASSERT_EQ(20, format.GetEncodedSize());
+
+  // Scenario: encoded keys compare like the keys do, negative columns and equal leading columns included, and decode
+  // back into the same keys.
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<int64_t> small(-300, 300);
+  std::uniform_int_distribution<int64_t> wide(INT64_MIN, INT64_MAX);
+  char lhs_encoded[sizeof(Key)];
+  char rhs_encoded[sizeof(Key)];
+  for (int i = 0; i < 10000; i++) {
+    auto &values = i % 2 == 0 ? small : wide;
+    const Key lhs = MakeKey(key_schema.get(), small(rng) / 100, values(rng), static_cast<int32_t>(small(rng)));
+    const Key rhs = MakeKey(key_schema.get(), small(rng) / 100, values(rng), static_cast<int32_t>(small(rng)));
+    format.Encode(lhs.data_, lhs_encoded);
+    format.Encode(rhs.data_, rhs_encoded);
+    ASSERT_EQ(comparator(lhs, rhs), CompareEncoded(lhs_encoded, rhs_encoded, format.GetEncodedSize()));
+    Key decoded;
+    format.Decode(lhs_encoded, decoded.data_);
+    ASSERT_EQ(0, memcmp(lhs.data_, decoded.data_, sizeof(Key)));
+
+    // Scenario: the separator of two keys sorts between them, and is not longer than the right one once encoded.
+    if (comparator(lhs, rhs) != 0) {
+      const Key &left = comparator(lhs, rhs) < 0 ? lhs : rhs;
+      const Key &right = comparator(lhs, rhs) < 0 ? rhs : lhs;
+      const Key separator = format.Separator(left, right);
+      ASSERT_LT(comparator(left, separator), 0);
+      ASSERT_LE(comparator(separator, right), 0);
+      char separator_encoded[sizeof(Key)];
+      format.Encode(separator.data_, separator_encoded);
+      format.Encode(right.data_, rhs_encoded);
+      ASSERT_LE(format.SignificantSize(separator_encoded), format.SignificantSize(rhs_encoded));
+    }
+  }
+
+  // Scenario: a separator keeps the columns up to the first one the keys differ in, the bytes cut off after it decode
+  // as the smallest values of the columns they belong to.
+  const Key one = MakeKey(key_schema.get(), 5, 1, 0);
+  const Key two = MakeKey(key_schema.get(), 5, 2, 0);
+  EXPECT_EQ(0, comparator(MakeKey(key_schema.get(), 5, 2, INT32_MIN), format.Separator(one, two)));
+  const Key separator = format.Separator(MakeKey(key_schema.get(), 5, 99, 99), MakeKey(key_schema.get(), 6, 1, 1));
+  EXPECT_EQ(0, comparator(MakeKey(key_schema.get(), 6, INT64_MIN, INT32_MIN), separator));
+
+  // Scenario: keys the comparator can not compile are stored as they are, and separated by the right key.
+  Schema varchar_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 16)});
+  Comparator varchar_comparator(&varchar_schema);
+  const auto raw_format = KeyFormat::Of(varchar_comparator);
+  EXPECT_FALSE(raw_format.IsNormalized());
+  EXPECT_EQ(sizeof(Key), raw_format.GetEncodedSize());
+  EXPECT_EQ(0, memcmp(two.data_, raw_format.Separator(one, two).data_, sizeof(Key)));
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeCompressionTest, LeafPageTest) {
+  auto key_schema = ParseCreateStatement("a bigint,b bigint,c integer");
+  Comparator comparator(key_schema.get());
+  const auto format = KeyFormat::Of(comparator);
+  std::vector<char> page(BUSTUB_PAGE_SIZE);
+  auto *leaf = reinterpret_cast<LeafPage *>(page.data());
+  leaf->Init(1, INVALID_PAGE_ID, 2 * LeafPage::GetCapacity(format), format);
+
+  // Scenario: keys sharing their leading bytes take a few bytes each, the RIDs most of the page, so a leaf fits well
+  // over what the full keys allow.
+  int n = 0;
+  while (leaf->HasRoomFor(NthKey(key_schema.get(), n))) {
+    leaf->InsertAtBack(NthKey(key_schema.get(), n), RID(n));
+    n++;
+  }
+  EXPECT_GT(n, 3 * LeafPage::GetCapacity(format) / 2);
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(0, comparator(NthKey(key_schema.get(), i), leaf->KeyAt(i)));
+    ASSERT_EQ(RID(i), leaf->ValueAt(i));
+    ASSERT_EQ(i, leaf->BinarySearchByKey(NthKey(key_schema.get(), i), comparator));
+  }
+
+  // Scenario: a key unlike the others widens the stored bytes of all keys, which still read back the same.
+  leaf->SetEntries({});
+  for (int i = 0; i < 100; i++) {
+    leaf->Insert(NthKey(key_schema.get(), 2 * i), RID(2 * i), comparator);
+  }
+  const Key odd = MakeKey(key_schema.get(), -20, INT64_MAX, -1);
+  ASSERT_TRUE(leaf->HasRoomFor(odd));
+  leaf->Insert(odd, RID(-1), comparator);
+  EXPECT_EQ(0, comparator(odd, leaf->KeyAt(0)));
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(0, comparator(NthKey(key_schema.get(), 2 * i), leaf->KeyAt(i + 1)));
+    ASSERT_EQ(RID(2 * i), leaf->ValueAt(i + 1));
+    ASSERT_TRUE(leaf->ExistsKey(NthKey(key_schema.get(), 2 * i), comparator));
+    ASSERT_FALSE(leaf->ExistsKey(NthKey(key_schema.get(), 2 * i + 1), comparator));
+  }
+
+  // Scenario: removing entries leaves the others in place, and only removes keys that are there.
+  EXPECT_FALSE(leaf->RemoveEntry(NthKey(key_schema.get(), 1), comparator));
+  EXPECT_TRUE(leaf->RemoveEntry(odd, comparator));
+  leaf->RemoveAt(50);
+  ASSERT_EQ(99, leaf->GetSize());
+  EXPECT_EQ(0, comparator(NthKey(key_schema.get(), 102), leaf->KeyAt(50)));
+  EXPECT_EQ(RID(102), leaf->ValueAt(50));
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeCompressionTest, CompositeKeyTreeTest) {
+  auto key_schema = ParseCreateStatement("a bigint,b bigint,c integer");
+  Comparator comparator(key_schema.get());
+  const auto format = KeyFormat::Of(comparator);
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(100, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto *transaction = new Transaction(0);
+
+  // Scenario: the leaves of a tree of composite keys hold more entries than fit uncompressed, and the inner nodes
+  // hold short separators, so twenty thousand keys take two levels.
+  Tree tree("foo_pk", bpm, comparator);
+  const int num_keys = 20000;
+  std::vector<int64_t> keys(num_keys);
+  for (int64_t i = 0; i < num_keys; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  for (auto key : keys) {
+    ASSERT_TRUE(tree.Insert(NthKey(key_schema.get(), key), RID(key), transaction));
+  }
+  EXPECT_FALSE(tree.Insert(NthKey(key_schema.get(), 0), RID(0), transaction));
+  EXPECT_EQ(num_keys, CheckSubtree(bpm, comparator, tree.GetRootPageId(), INVALID_PAGE_ID, nullptr, nullptr));
+  const auto [leaves, height] = CountLeaves(bpm, tree.GetRootPageId());
+  EXPECT_EQ(2, height);
+  EXPECT_GT(num_keys / leaves, LeafPage::GetCapacity(format));
+
+  std::vector<RID> result;
+  for (int64_t key = 0; key < num_keys; key++) {
+    result.clear();
+    ASSERT_TRUE(tree.GetValue(NthKey(key_schema.get(), key), &result)) << key;
+    ASSERT_EQ(RID(key), result[0]);
+  }
+  result.clear();
+  EXPECT_FALSE(tree.GetValue(MakeKey(key_schema.get(), 0, 1, 0), &result));
+
+  int64_t expected = 0;
+  for (auto it = tree.Begin(); it != tree.End(); ++it, expected++) {
+    ASSERT_EQ(0, comparator(NthKey(key_schema.get(), expected), (*it).first));
+    ASSERT_EQ(RID(expected), (*it).second);
+  }
+  EXPECT_EQ(num_keys, expected);
+
+  // Scenario: removing every other key merges and redistributes compressed nodes, and keeps the rest.
+  for (auto key : keys) {
+    if (key % 2 == 0) {
+      tree.Remove(NthKey(key_schema.get(), key), transaction);
+    }
+  }
+  EXPECT_EQ(num_keys / 2, CheckSubtree(bpm, comparator, tree.GetRootPageId(), INVALID_PAGE_ID, nullptr, nullptr));
+  for (int64_t key = 0; key < num_keys; key++) {
+    result.clear();
+    ASSERT_EQ(key % 2 == 1, tree.GetValue(NthKey(key_schema.get(), key), &result)) << key;
+  }
+
+  // Scenario: removing the rest empties the tree.
+  for (auto key : keys) {
+    tree.Remove(NthKey(key_schema.get(), key), transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  delete transaction;
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeCompressionTest, SmallNodeDeleteTest) {
+  auto key_schema = ParseCreateStatement("a bigint,b bigint,c integer");
+  Comparator comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto *transaction = new Transaction(0);
+
+  // Scenario: in a tree of small nodes, removing keys in random order merges nodes, borrows entries between them and
+  // collapses the root, with every separator still in place between the keys of its children.
+  Tree tree("foo_pk", bpm, comparator, 4, 4);
+  const int num_keys = 2000;
+  std::vector<int64_t> keys(num_keys);
+  for (int64_t i = 0; i < num_keys; i++) {
+    keys[i] = i;
+  }
+  std::mt19937 rng(7);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    ASSERT_TRUE(tree.Insert(NthKey(key_schema.get(), key), RID(key), transaction));
+  }
+  std::shuffle(keys.begin(), keys.end(), rng);
+  std::vector<bool> removed(num_keys);
+  std::vector<RID> result;
+  for (int i = 0; i < num_keys; i++) {
+    tree.Remove(NthKey(key_schema.get(), keys[i]), transaction);
+    removed[keys[i]] = true;
+    if (i % 200 != 199 || tree.IsEmpty()) {
+      continue;
+    }
+    ASSERT_EQ(num_keys - i - 1,
+              CheckSubtree(bpm, comparator, tree.GetRootPageId(), INVALID_PAGE_ID, nullptr, nullptr));
+    for (int64_t key = 0; key < num_keys; key++) {
+      result.clear();
+      ASSERT_EQ(!removed[key], tree.GetValue(NthKey(key_schema.get(), key), &result)) << key;
+    }
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  delete transaction;
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeCompressionTest, RawKeyTreeTest) {
+  Schema key_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 16)});
+  Comparator comparator(&key_schema);
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto *transaction = new Transaction(0);
+
+  // Scenario: keys the comparator can not compile are only shared and trimmed, and searched by the comparator.
+  Tree tree("foo_pk", bpm, comparator);
+  auto make_key = [&](int i) {
+    Key key;
+    key.SetFromKey(Tuple({Value(TypeId::INTEGER, i % 3), Value(TypeId::VARCHAR, fmt::format("key{:05}", i))},
+                         &key_schema));
+    return key;
+  };
+  const int num_keys = 3000;
+  std::vector<int> keys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  for (auto key : keys) {
+    ASSERT_TRUE(tree.Insert(make_key(key), RID(key), transaction));
+  }
+  EXPECT_EQ(num_keys, CheckSubtree(bpm, comparator, tree.GetRootPageId(), INVALID_PAGE_ID, nullptr, nullptr));
+  std::vector<RID> result;
+  for (int key = 0; key < num_keys; key++) {
+    result.clear();
+    ASSERT_TRUE(tree.GetValue(make_key(key), &result)) << key;
+    ASSERT_EQ(RID(key), result[0]);
+  }
+  for (auto key : keys) {
+    tree.Remove(make_key(key), transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  delete transaction;
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
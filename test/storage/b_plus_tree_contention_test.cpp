@@ -3,6 +3,7 @@
  */
 
 #include <chrono>  // NOLINT
+#include <algorithm>
 #include <cstdio>
 #include <functional>
 #include <future>  // NOLINT
@@ -17,7 +18,8 @@
 
 namespace bustub {
 
-bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool with_global_mutex) {
+bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool with_global_mutex,
+                                bool optimistic_writes = true) {
   bool success = true;
   std::vector<int64_t> insert_keys;
 
@@ -28,6 +30,7 @@ bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool wit
   BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
   // create b+ tree
   BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, leaf_node_size, 10);
+  tree.SetOptimisticWrites(optimistic_writes);
   // create and fetch header_page
   page_id_t page_id;
   auto *header_page = bpm->NewPage(&page_id);
@@ -154,4 +157,38 @@ TEST(BPlusTreeTest, BPlusTreeContentionBenchmark2) {  // NOLINT
             << std::endl;
 }
 
+TEST(BPlusTreeTest, BPlusTreeOptimisticWritesBenchmark) {  // NOLINT
+  // Inserts that fit in their leaf only latch the leaf with optimistic writes, instead of crabbing down from the root.
+  const size_t num_threads = 8;
+  const int num_keys = 20000 / num_threads * num_threads;
+  std::vector<size_t> time_ms_optimistic;
+  std::vector<size_t> time_ms_crabbing;
+  for (size_t iter = 0; iter < 10; iter++) {
+    bool optimistic = iter % 2 == 0;
+    auto clock_start = std::chrono::system_clock::now();
+    ASSERT_TRUE(BPlusTreeLockBenchmarkCall(num_threads, 50, false, optimistic));
+    auto clock_end = std::chrono::system_clock::now();
+    auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start);
+    if (optimistic) {
+      time_ms_optimistic.push_back(dur.count());
+    } else {
+      time_ms_crabbing.push_back(dur.count());
+    }
+  }
+  auto throughput = [num_keys](const std::vector<size_t> &times) {
+    size_t total_ms = 0;
+    for (auto x : times) {
+      total_ms += x;
+    }
+    return static_cast<double>(num_keys) * times.size() * 1000 / std::max<size_t>(total_ms, 1);
+  };
+  const double optimistic_throughput = throughput(time_ms_optimistic);
+  const double crabbing_throughput = throughput(time_ms_crabbing);
+  std::cout << "<<< BEGIN OPTIMISTIC" << std::endl;
+  std::cout << "Latch Crabbing Inserts/s: " << crabbing_throughput << std::endl;
+  std::cout << "Optimistic Inserts/s: " << optimistic_throughput << std::endl;
+  std::cout << "Gain: " << optimistic_throughput / crabbing_throughput << std::endl;
+  std::cout << ">>> END OPTIMISTIC" << std::endl;
+}
+
 }  // namespace bustub
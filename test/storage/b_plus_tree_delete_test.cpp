@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -163,4 +164,67 @@ TEST(BPlusTreeTests, DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, DeleteTest3) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree, with small nodes so that removes merge and redistribute on every level
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 200; key++) {
+    keys.push_back(key);
+  }
+  auto rng = std::default_random_engine{};
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // Scenario: removing a key that is not in the tree leaves the tree alone.
+  index_key.SetFromInteger(1000);
+  tree.Remove(index_key, transaction);
+
+  // Scenario: after each remove, the removed keys are gone and all the others are still found.
+  std::shuffle(keys.begin(), keys.end(), rng);
+  std::vector<RID> rids;
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_key.SetFromInteger(keys[i]);
+    tree.Remove(index_key, transaction);
+    if (i % 20 != 0) {
+      continue;
+    }
+    for (size_t j = 0; j < keys.size(); j++) {
+      rids.clear();
+      index_key.SetFromInteger(keys[j]);
+      ASSERT_EQ(j > i, tree.GetValue(index_key, &rids)) << "key " << keys[j] << " after " << i + 1 << " removes";
+    }
+  }
+
+  // Scenario: the root collapsed level by level, down to an empty tree.
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_EQ(0, transaction->GetPageSet()->size());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
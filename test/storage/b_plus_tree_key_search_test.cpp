@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_search_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_key_search.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+/**
+ * Check the in-place search of n sorted random suffixes of width bytes, lying stride bytes apart, against a search with
+ * memcmp, for suffixes in and around them. The bytes of a suffix are drawn from the first num_bytes of BYTES.
+ */
+static void CheckSearch(size_t width, size_t stride, int n, size_t num_bytes) {
+  static const char BYTES[] = {'\x00', '\x7f', '\x80', '\xff', '\x01', '\x3c', '\xa5', '\xfe'};
+  std::mt19937_64 rng(n * 1000 + width * 10 + stride);
+  std::uniform_int_distribution<size_t> bytes(0, num_bytes - 1);
+  auto random_suffix = [&]() {
+    std::string suffix(width, '\0');
+    for (auto &byte : suffix) {
+      byte = BYTES[bytes(rng)];
+    }
+    return suffix;
+  };
+  std::vector<std::string> suffixes(n);
+  for (auto &suffix : suffixes) {
+    suffix = random_suffix();
+  }
+  // std::string compares its chars as unsigned, like memcmp.
+  std::sort(suffixes.begin(), suffixes.end());
+
+  // The bytes between the suffixes, and after the searched one, must not matter.
+  std::vector<char> entries(n * stride + KEY_SEARCH_SLACK, '\x5a');
+  for (int i = 0; i < n; i++) {
+    memcpy(entries.data() + i * stride, suffixes[i].data(), width);
+  }
+  std::vector<std::string> targets{std::string(width, '\x00'), std::string(width, '\xff')};
+  for (int i = 0; i < 50; i++) {
+    targets.push_back(random_suffix());
+  }
+  targets.insert(targets.end(), suffixes.begin(), suffixes.end());
+  for (const auto &target : targets) {
+    const std::string padded = target + std::string(KEY_SEARCH_SLACK, '\x5a');
+    for (bool or_equal : {false, true}) {
+      const auto bound = or_equal ? std::upper_bound(suffixes.begin(), suffixes.end(), target)
+                                  : std::lower_bound(suffixes.begin(), suffixes.end(), target);
+      const auto expected = static_cast<int>(bound - suffixes.begin());
+      ASSERT_EQ(expected, CountSuffixesBelow(entries.data(), stride, width, n, padded.data(), or_equal))
+          << n << " suffixes of " << width << " bytes" << (or_equal ? ", or equal" : "");
+      if (width <= sizeof(uint64_t)) {
+        const uint64_t mask = key_search::SuffixMask(width);
+        const uint64_t needle = key_search::LoadSuffix(padded.data()) & mask;
+        ASSERT_EQ(expected, key_search::CountBelowScalar(entries.data(), stride, n, needle, mask, or_equal));
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeySearchTest, SuffixSearchTest) {
+  // Scenario: suffixes of every width up to past a 64-bit word, at the strides of leaf and inner entries, in nodes of
+  // every size up to several windows; bytes spread wide, and bytes from few values for many equal suffixes.
+  for (size_t width = 0; width <= 12; width++) {
+    for (size_t value_size : {sizeof(page_id_t), sizeof(RID)}) {
+      for (int n = 0; n <= 80; n++) {
+        CheckSearch(width, width + value_size, n, 8);
+        CheckSearch(width, width + value_size, n, 2);
+      }
+    }
+  }
+  CheckSearch(3, 3 + sizeof(RID), 1000, 8);
+  CheckSearch(10, 10 + sizeof(RID), 1000, 2);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeySearchTest, TreeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto *transaction = new Transaction(0);
+
+  // Scenario: a tree of full-size nodes finds every key with either search, negative keys and the all-zero key
+  // included.
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  std::vector<int64_t> keys;
+  for (int64_t key = -5000; key <= 5000; key += 2) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(key), transaction));
+  }
+  for (bool simd : {false, true}) {
+    simd_key_search = simd;
+    std::vector<RID> result;
+    for (int64_t key = -5001; key <= 5001; key++) {
+      index_key.SetFromInteger(key);
+      result.clear();
+      ASSERT_EQ(key % 2 == 0, tree.GetValue(index_key, &result)) << key;
+      if (key % 2 == 0) {
+        ASSERT_EQ(RID(key), result[0]);
+      }
+    }
+  }
+  simd_key_search = true;
+
+  delete transaction;
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
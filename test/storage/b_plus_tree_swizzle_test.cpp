@@ -0,0 +1,215 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_swizzle_test.cpp
+//
+// Identification: test/storage/b_plus_tree_swizzle_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdio>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using SwizzleTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+namespace {
+
+void InsertKeys(SwizzleTree *tree, const std::vector<int64_t> &keys) {
+  GenericKey<8> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+  for (auto key : keys) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree->Insert(index_key, rid, transaction);
+  }
+  delete transaction;
+}
+
+auto LookUp(SwizzleTree *tree, int64_t key) -> bool {
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  index_key.SetFromInteger(key);
+  return tree->GetValue(index_key, &rids) && rids[0].GetSlotNum() == key;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeSwizzleTest, SkipsBufferPoolTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("swizzle_test.db");
+  auto *bpm = new BufferPoolManagerInstance(200, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  {
+    SwizzleTree tree("foo_pk", bpm, comparator, 3, 10);
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= 500; key++) {
+      keys.push_back(key);
+    }
+    InsertKeys(&tree, keys);
+    tree.EnableSwizzling(100);
+
+    // The first pass swizzles the inner pages on the way.
+    for (auto key : keys) {
+      ASSERT_TRUE(LookUp(&tree, key));
+    }
+    EXPECT_GT(tree.GetNumSwizzledPages(), 1);
+    EXPECT_LE(tree.GetNumSwizzledPages(), 100);
+
+    // Scenario: the inner pages are all swizzled, so every search only fetches its leaf from the buffer pool.
+    const auto before = bpm->GetStats();
+    for (auto key : keys) {
+      ASSERT_TRUE(LookUp(&tree, key));
+    }
+    const auto after = bpm->GetStats();
+    EXPECT_EQ(keys.size(), (after.hits_ + after.misses_) - (before.hits_ + before.misses_));
+
+    // Scenario: the swizzled pages are unpinned again, only the header page stays pinned.
+    tree.DisableSwizzling();
+    EXPECT_EQ(0, tree.GetNumSwizzledPages());
+    size_t pinned = 0;
+    for (size_t i = 0; i < bpm->GetPoolSize(); i++) {
+      pinned += bpm->GetFramePage(i)->GetPinCount() > 0 ? 1 : 0;
+    }
+    EXPECT_EQ(1, pinned);
+    for (auto key : keys) {
+      ASSERT_TRUE(LookUp(&tree, key));
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("swizzle_test.db");
+  remove("swizzle_test.log");
+  remove("swizzle_test.fsm");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeSwizzleTest, EvictAndRemoveTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("swizzle_test.db");
+  auto *bpm = new BufferPoolManagerInstance(30, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  auto count_pinned = [bpm] {
+    size_t pinned = 0;
+    for (size_t i = 0; i < bpm->GetPoolSize(); i++) {
+      pinned += bpm->GetFramePage(i)->GetPinCount() > 0 ? 1 : 0;
+    }
+    return pinned;
+  };
+
+  {
+    SwizzleTree tree("foo_pk", bpm, comparator, 3, 3);
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= 500; key++) {
+      keys.push_back(key);
+    }
+    InsertKeys(&tree, keys);
+    tree.EnableSwizzling(1000);
+
+    // Scenario: the tree has more inner pages than the pool has frames, so pages are unswizzled to make room.
+    for (int pass = 0; pass < 2; pass++) {
+      for (auto key : keys) {
+        ASSERT_TRUE(LookUp(&tree, key));
+      }
+    }
+    EXPECT_GT(tree.GetNumSwizzledPages(), 1);
+    EXPECT_LT(tree.GetNumSwizzledPages(), bpm->GetPoolSize());
+    EXPECT_EQ(1 + tree.GetNumSwizzledPages(), count_pinned());
+
+    // Scenario: the swizzled pages merged away or collapsed are unswizzled and unpinned before they are deleted.
+    GenericKey<8> index_key;
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+      if (key % 50 == 0) {
+        for (int64_t rest = key + 1; rest <= 500; rest += 7) {
+          ASSERT_TRUE(LookUp(&tree, rest));
+        }
+      }
+    }
+    EXPECT_TRUE(tree.IsEmpty());
+    EXPECT_EQ(0, tree.GetNumSwizzledPages());
+    EXPECT_EQ(1, count_pinned());
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("swizzle_test.db");
+  remove("swizzle_test.log");
+  remove("swizzle_test.fsm");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeSwizzleTest, SearchWhileInsertTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("swizzle_test.db");
+  auto *bpm = new BufferPoolManagerInstance(100, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  {
+    SwizzleTree tree("foo_pk", bpm, comparator, 16, 8);
+    std::vector<int64_t> even_keys;
+    std::vector<int64_t> odd_keys;
+    for (int64_t key = 1; key <= 4000; key++) {
+      (key % 2 == 0 ? even_keys : odd_keys).push_back(key);
+    }
+    InsertKeys(&tree, even_keys);
+    tree.EnableSwizzling(50);
+
+    // Scenario: the inner pages split under swizzled searches, which must still find every key.
+    std::atomic<bool> done{false};
+    std::atomic<int64_t> missing{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; t++) {
+      readers.emplace_back([&] {
+        while (!done) {
+          for (auto key : even_keys) {
+            missing += LookUp(&tree, key) ? 0 : 1;
+          }
+        }
+      });
+    }
+    InsertKeys(&tree, odd_keys);
+    done = true;
+    for (auto &reader : readers) {
+      reader.join();
+    }
+    EXPECT_EQ(0, missing);
+    for (int64_t key = 1; key <= 4000; key++) {
+      ASSERT_TRUE(LookUp(&tree, key));
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("swizzle_test.db");
+  remove("swizzle_test.log");
+  remove("swizzle_test.fsm");
+}
+
+}  // namespace bustub
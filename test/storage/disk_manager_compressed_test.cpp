@@ -0,0 +1,246 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed_test.cpp
+//
+// Identification: test/storage/disk_manager_compressed_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_compressed.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/util/compress_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+class DiskManagerCompressedTest : public ::testing::Test {
+ protected:
+  void SetUp() override { RemoveFiles(); }
+
+  void TearDown() override { RemoveFiles(); }
+
+  void RemoveFiles() {
+    remove("compressed_test.db");
+    remove("compressed_test.log");
+    remove("compressed_test.fsm");
+    remove("compressed_test.map");
+  }
+
+  /** Fill a page with rows of text that differ in a counter, like a table page. */
+  static void FillPage(char *data, int seed) {
+    memset(data, 0, BUSTUB_PAGE_SIZE);
+    for (int i = 0, off = 0; off + 32 < BUSTUB_PAGE_SIZE / 2; i++) {
+      off += snprintf(data + off, BUSTUB_PAGE_SIZE - off, "row %d of page %d;", i, seed);
+    }
+  }
+
+  static void FillRandom(char *data, std::mt19937 *gen) {
+    for (int i = 0; i < BUSTUB_PAGE_SIZE; i++) {
+      data[i] = static_cast<char>((*gen)());
+    }
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerCompressedTest, CompressUtilTest) {
+  std::mt19937 gen(15445);
+  char page[BUSTUB_PAGE_SIZE];
+  char compressed[BUSTUB_PAGE_SIZE * 2];
+  char copy[BUSTUB_PAGE_SIZE];
+
+  std::vector<std::string> inputs = {"", "a", "abcdabcdabcdabcdabcd", std::string(BUSTUB_PAGE_SIZE, 'x')};
+  FillPage(page, 7);
+  inputs.emplace_back(page, BUSTUB_PAGE_SIZE);
+  FillRandom(page, &gen);
+  inputs.emplace_back(page, BUSTUB_PAGE_SIZE);
+
+  for (const auto &input : inputs) {
+    size_t size = CompressUtil::Compress(input.data(), input.size(), compressed, sizeof(compressed));
+    ASSERT_GT(size, 0);
+    ASSERT_EQ(input.size(), CompressUtil::Decompress(compressed, size, copy, sizeof(copy)));
+    EXPECT_EQ(0, memcmp(input.data(), copy, input.size()));
+  }
+
+  // A run of one byte collapses into a few bytes; random data does not fit into less than its own size.
+  EXPECT_LT(CompressUtil::Compress(inputs[3].data(), BUSTUB_PAGE_SIZE, compressed, sizeof(compressed)),
+            BUSTUB_PAGE_SIZE / 64);
+  EXPECT_EQ(0, CompressUtil::Compress(inputs[5].data(), BUSTUB_PAGE_SIZE, compressed, BUSTUB_PAGE_SIZE));
+
+  // Scenario: truncated or garbage input never overruns a buffer, nor passes for a whole page.
+  size_t size = CompressUtil::Compress(inputs[4].data(), BUSTUB_PAGE_SIZE, compressed, sizeof(compressed));
+  for (size_t cut = 1; cut < size; cut++) {
+    EXPECT_NE(BUSTUB_PAGE_SIZE, CompressUtil::Decompress(compressed, cut, copy, sizeof(copy)));
+  }
+  EXPECT_EQ(-1, CompressUtil::Decompress(compressed, size, copy, BUSTUB_PAGE_SIZE / 2));
+  for (int i = 0; i < 100; i++) {
+    FillRandom(compressed, &gen);
+    int64_t result = CompressUtil::Decompress(compressed, 256, copy, sizeof(copy));
+    EXPECT_LE(result, BUSTUB_PAGE_SIZE);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerCompressedTest, ReadWriteTest) {
+  DiskManagerCompressed dm("compressed_test.db");
+  std::mt19937 gen(15445);
+  char data[BUSTUB_PAGE_SIZE];
+  char buf[BUSTUB_PAGE_SIZE];
+  const int num_pages = 20;
+
+  for (int i = 0; i < num_pages; i++) {
+    FillPage(data, i);
+    dm.WritePage(i, data);
+  }
+  // Scenario: an incompressible page is stored as is.
+  FillRandom(data, &gen);
+  dm.WritePage(num_pages, data);
+  EXPECT_EQ(num_pages + 1, dm.GetNumWrites());
+
+  dm.ReadPage(num_pages, buf);
+  EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+  for (int i = 0; i < num_pages; i++) {
+    FillPage(data, i);
+    dm.ReadPage(i, buf);
+    EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+  }
+  EXPECT_LT(dm.GetStoredBytes(), (num_pages / 2 + 1) * BUSTUB_PAGE_SIZE);
+  EXPECT_LT(dm.GetNumSlots() * COMPRESSED_SLOT_SIZE, (num_pages / 2 + 1) * BUSTUB_PAGE_SIZE);
+
+  // Scenario: a page that was never written reads as zeros.
+  memset(data, 0, BUSTUB_PAGE_SIZE);
+  dm.ReadPage(num_pages + 5, buf);
+  EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerCompressedTest, RewriteAndRestartTest) {
+  std::mt19937 gen(15445);
+  char data[BUSTUB_PAGE_SIZE];
+  char buf[BUSTUB_PAGE_SIZE];
+  size_t num_slots = 0;
+  {
+    DiskManagerCompressed dm("compressed_test.db");
+    // Scenario: pages are rewritten over and over; the released extents are reused once the page map is flushed.
+    for (int round = 0; round < 10; round++) {
+      for (int i = 0; i < 8; i++) {
+        FillPage(data, round * 8 + i);
+        dm.WritePage(i, data);
+      }
+      dm.FlushFreePageMap();
+      if (round == 1) {
+        num_slots = dm.GetNumSlots();
+      }
+    }
+    EXPECT_EQ(num_slots, dm.GetNumSlots());
+
+    // A page that stops compressing moves to a larger extent.
+    FillRandom(data, &gen);
+    dm.WritePage(3, data);
+    dm.DeallocatePage(5);
+    dm.ShutDown();
+  }
+
+  // Scenario: the page map survives a restart.
+  DiskManagerCompressed dm("compressed_test.db");
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+  for (int i = 0; i < 8; i++) {
+    if (i == 3) {
+      continue;
+    }
+    if (i == 5) {
+      memset(data, 0, BUSTUB_PAGE_SIZE);
+    } else {
+      FillPage(data, 9 * 8 + i);
+    }
+    dm.ReadPage(i, buf);
+    EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+  }
+  EXPECT_EQ(1, dm.GetNumFreePages());
+
+  // The free slots are rebuilt from the page map, so new writes do not grow the file.
+  const size_t restart_slots = dm.GetNumSlots();
+  FillPage(data, 100);
+  dm.WritePage(5, data);
+  EXPECT_EQ(restart_slots, dm.GetNumSlots());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerCompressedTest, MergeFreeSlotsTest) {
+  std::mt19937 gen(15445);
+  char data[BUSTUB_PAGE_SIZE];
+  char buf[BUSTUB_PAGE_SIZE];
+  DiskManagerCompressed dm("compressed_test.db");
+  const int num_pages = 16;
+  for (int i = 0; i < num_pages; i++) {
+    FillPage(data, i);
+    dm.WritePage(i, data);
+  }
+  dm.FlushFreePageMap();
+  const size_t num_slots = dm.GetNumSlots();
+  ASSERT_GE(num_slots * COMPRESSED_SLOT_SIZE, 2 * BUSTUB_PAGE_SIZE);
+
+  // Scenario: the extents of small pages released next to each other merge, and take whole uncompressed pages.
+  for (int i = 0; i < num_pages; i++) {
+    dm.DeallocatePage(i);
+  }
+  dm.FlushFreePageMap();
+  FillRandom(data, &gen);
+  dm.WritePage(num_pages, data);
+  dm.WritePage(num_pages + 1, data);
+  EXPECT_EQ(num_slots, dm.GetNumSlots());
+  dm.ReadPage(num_pages + 1, buf);
+  EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(2, dm.GetNumWrites() - num_pages);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerCompressedTest, BufferPoolTest) {
+  auto *dm = new DiskManagerCompressed("compressed_test.db");
+  auto *bpm = new BufferPoolManagerInstance(8, dm);
+
+  // Scenario: the buffer pool only ever sees whole pages, whatever their size on disk.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 50; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    FillPage(page->GetData(), page_id);
+    page_ids.push_back(page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  bpm->FlushAllPages();
+  delete bpm;
+  delete dm;
+
+  dm = new DiskManagerCompressed("compressed_test.db");
+  bpm = new BufferPoolManagerInstance(8, dm);
+  char data[BUSTUB_PAGE_SIZE];
+  for (auto page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    FillPage(data, page_id);
+    EXPECT_EQ(0, memcmp(data, page->GetData(), BUSTUB_PAGE_SIZE));
+    bpm->UnpinPage(page_id, false);
+  }
+  delete bpm;
+  delete dm;
+}
+
+}  // namespace bustub
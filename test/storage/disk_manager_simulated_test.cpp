@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_simulated_test.cpp
+//
+// Identification: test/storage/disk_manager_simulated_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_simulated.h"
+
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/exception.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+static auto Millis(std::chrono::steady_clock::time_point start) -> int64_t {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerSimulatedTest, ProfileTest) {
+  for (const auto *name : {"ram", "nvme", "slow-ssd", "cloud"}) {
+    auto profile = DiskProfile::FromName(name);
+    EXPECT_LE(profile.read_p50_, profile.read_p99_);
+    EXPECT_LE(profile.write_p50_, profile.write_p99_);
+  }
+  EXPECT_EQ(0, DiskProfile::FromName("ram").max_iops_);
+  EXPECT_LT(DiskProfile::FromName("cloud").max_iops_, DiskProfile::FromName("slow-ssd").max_iops_);
+  EXPECT_THROW(DiskProfile::FromName("floppy"), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerSimulatedTest, LatencyTest) {
+  DiskProfile profile;
+  profile.read_p50_ = profile.read_p99_ = std::chrono::milliseconds(5);
+  profile.write_p50_ = std::chrono::milliseconds(1);
+  profile.write_p99_ = std::chrono::milliseconds(10);
+  DiskManagerSimulated dm(profile);
+
+  // Scenario: the pages still round-trip, each I/O taking at least its latency.
+  char data[BUSTUB_PAGE_SIZE];
+  char buf[BUSTUB_PAGE_SIZE];
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 8; i++) {
+    memset(data, i, BUSTUB_PAGE_SIZE);
+    dm.WritePage(i, data);
+  }
+  for (int i = 0; i < 8; i++) {
+    dm.ReadPage(i, buf);
+    memset(data, i, BUSTUB_PAGE_SIZE);
+    EXPECT_EQ(0, memcmp(data, buf, BUSTUB_PAGE_SIZE));
+  }
+  EXPECT_GE(Millis(start), 8 * 5);
+  EXPECT_EQ(8, dm.GetStats().reads_.count_);
+
+  // Scenario: the reads of one batch overlap.
+  std::vector<std::vector<char>> buffers(8, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<DiskManager::PageIo> batch;
+  for (int i = 0; i < 8; i++) {
+    batch.push_back({i, buffers[i].data()});
+  }
+  start = std::chrono::steady_clock::now();
+  dm.ReadPages(batch);
+  const auto elapsed = Millis(start);
+  EXPECT_GE(elapsed, 5);
+  EXPECT_LT(elapsed, 8 * 5);
+  EXPECT_EQ(7, buffers[7][0]);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerSimulatedTest, ThrottleTest) {
+  char data[BUSTUB_PAGE_SIZE] = {};
+
+  // Scenario: the IOPS cap is shared by all threads.
+  DiskProfile profile;
+  profile.max_iops_ = 1000;
+  DiskManagerSimulated dm(profile);
+  dm.WritePage(0, data);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&dm] {
+      char buf[BUSTUB_PAGE_SIZE];
+      for (int i = 0; i < 25; i++) {
+        dm.ReadPage(0, buf);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_GE(Millis(start), 95);
+
+  // Scenario: so is the bandwidth cap, which also paces the pages of a batch.
+  profile = DiskProfile();
+  profile.max_bytes_per_second_ = 100 * BUSTUB_PAGE_SIZE;
+  DiskManagerSimulated throttled(profile);
+  std::vector<DiskManager::PageIo> batch;
+  for (int i = 0; i < 10; i++) {
+    batch.push_back({i, data});
+  }
+  start = std::chrono::steady_clock::now();
+  throttled.WritePages(batch);
+  throttled.WritePage(10, data);
+  EXPECT_GE(Millis(start), 95);
+
+  // Scenario: without caps or latencies, nothing waits.
+  DiskManagerSimulated ram(DiskProfile::FromName("ram"));
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 1000; i++) {
+    ram.WritePage(i, data);
+  }
+  EXPECT_LT(Millis(start), 1000);
+}
+
+}  // namespace bustub
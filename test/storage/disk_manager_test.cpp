@@ -11,10 +11,14 @@
 //===----------------------------------------------------------------------===//
 
 #include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
 
 namespace bustub {
 
@@ -72,6 +76,82 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ReadPastEndOfFileTest) {
+  char buf[BUSTUB_PAGE_SIZE];
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  auto dm = DiskManager("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+  dm.WritePage(1, data);
+
+  // A page that was never written reads back as zeros, wherever it lies.
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::string(BUSTUB_PAGE_SIZE, '\0'), std::string(buf, sizeof(buf)));
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(2, buf);
+  EXPECT_EQ(std::string(BUSTUB_PAGE_SIZE, '\0'), std::string(buf, sizeof(buf)));
+
+  // The size of the file survives a restart.
+  dm.ShutDown();
+  auto dm2 = DiskManager("test.db");
+  dm2.ReadPage(1, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  dm2.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ConcurrentReadWritePageTest) {
+  auto dm = DiskManager("test.db");
+  const int num_threads = 8;
+  const int pages_per_thread = 64;
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&dm, t] {
+      char buf[BUSTUB_PAGE_SIZE];
+      char data[BUSTUB_PAGE_SIZE];
+      for (int i = 0; i < pages_per_thread; i++) {
+        const page_id_t page_id = i * num_threads + t;
+        std::memset(data, page_id % 128, sizeof(data));
+        dm.WritePage(page_id, data);
+        dm.ReadPage(page_id, buf);
+        ASSERT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * pages_per_thread, dm.GetNumWrites());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIoTest) {
+  // Falls back to buffered I/O on file systems without O_DIRECT, so it must behave the same either way.
+  auto dm = DiskManager("test.db", true);
+
+  // Both the aligned buffer of a Page and arbitrary buffers work.
+  Page page;
+  std::strncpy(page.GetData(), "An aligned page.", BUSTUB_PAGE_SIZE);
+  dm.WritePage(0, page.GetData());
+
+  std::vector<char> unaligned(BUSTUB_PAGE_SIZE + 1, 0);
+  std::strncpy(unaligned.data() + 1, "An unaligned page.", BUSTUB_PAGE_SIZE);
+  dm.WritePage(3, unaligned.data() + 1);
+
+  std::vector<char> buf(BUSTUB_PAGE_SIZE + 1, 0);
+  dm.ReadPage(0, buf.data() + 1);
+  EXPECT_EQ(std::memcmp(buf.data() + 1, page.GetData(), BUSTUB_PAGE_SIZE), 0);
+  Page read_page;
+  dm.ReadPage(3, read_page.GetData());
+  EXPECT_EQ(std::memcmp(read_page.GetData(), unaligned.data() + 1, BUSTUB_PAGE_SIZE), 0);
+
+  dm.ShutDown();
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring_test.cpp
+//
+// Identification: test/storage/disk_manager_uring_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_uring.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+class DiskManagerUringTest : public ::testing::Test {
+ protected:
+  void SetUp() override { remove(db_file_.c_str()); }
+
+  void TearDown() override { remove(db_file_.c_str()); }
+
+  const std::string db_file_{"uring_test.db"};
+};
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerUringTest, BatchReadWriteTest) {
+  DiskManagerUring dm(db_file_, false, 8);
+  const size_t num_pages = 20;
+
+  // Scenario: a batch larger than the queue depth is submitted in chunks.
+  std::vector<Page> pages(num_pages);
+  std::vector<DiskManager::PageIo> writes;
+  for (size_t i = 0; i < num_pages; i++) {
+    snprintf(pages[i].GetData(), BUSTUB_PAGE_SIZE, "page %zu", i);
+    writes.push_back({static_cast<page_id_t>(i), pages[i].GetData()});
+  }
+  dm.WritePages(writes);
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+  std::vector<Page> copies(num_pages);
+  std::vector<DiskManager::PageIo> reads;
+  for (size_t i = 0; i < num_pages; i++) {
+    reads.push_back({static_cast<page_id_t>(num_pages - 1 - i), copies[i].GetData()});
+  }
+  dm.ReadPages(reads);
+  for (size_t i = 0; i < num_pages; i++) {
+    EXPECT_EQ(0, std::memcmp(pages[num_pages - 1 - i].GetData(), copies[i].GetData(), BUSTUB_PAGE_SIZE));
+  }
+  if (dm.IsUringAvailable()) {
+    EXPECT_EQ(6, dm.GetNumSubmissions());
+  }
+
+  // Single pages still go through the synchronous path.
+  char buf[BUSTUB_PAGE_SIZE];
+  dm.ReadPage(3, buf);
+  EXPECT_STREQ("page 3", buf);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerUringTest, ReadPastEndOfFileTest) {
+  DiskManagerUring dm(db_file_);
+  Page written;
+  std::strncpy(written.GetData(), "A test string.", BUSTUB_PAGE_SIZE);
+  dm.WritePage(1, written.GetData());
+
+  // Scenario: a batch that reads a hole, an existing page and pages past the end of the file.
+  std::vector<Page> pages(4);
+  std::vector<DiskManager::PageIo> reads;
+  for (size_t i = 0; i < pages.size(); i++) {
+    std::memset(pages[i].GetData(), 'x', BUSTUB_PAGE_SIZE);
+    reads.push_back({static_cast<page_id_t>(i), pages[i].GetData()});
+  }
+  dm.ReadPages(reads);
+
+  char zeros[BUSTUB_PAGE_SIZE] = {0};
+  EXPECT_EQ(0, std::memcmp(zeros, pages[0].GetData(), BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(written.GetData(), pages[1].GetData(), BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(zeros, pages[2].GetData(), BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(zeros, pages[3].GetData(), BUSTUB_PAGE_SIZE));
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerUringTest, BufferPoolFlushTest) {
+  auto *dm = new DiskManagerUring(db_file_);
+  auto *bpm = new BufferPoolManagerInstance(64, dm);
+
+  // Scenario: FlushAllPages() writes the dirty pages in batches, and they can be read back after a restart.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 50; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  bpm->FlushAllPages();
+  EXPECT_EQ(50, dm->GetNumWrites());
+  if (dm->IsUringAvailable()) {
+    EXPECT_EQ(2, dm->GetNumSubmissions());
+  }
+  delete bpm;
+  delete dm;
+
+  dm = new DiskManagerUring(db_file_);
+  bpm = new BufferPoolManagerInstance(8, dm);
+  for (auto page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    bpm->UnpinPage(page_id, false);
+  }
+  delete bpm;
+  delete dm;
+}
+
+}  // namespace bustub
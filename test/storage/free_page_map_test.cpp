@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map_test.cpp
+//
+// Identification: test/storage/free_page_map_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/free_page_map.h"
+
+#include <sys/stat.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+class FreePageMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override { RemoveFiles(); }
+
+  void TearDown() override { RemoveFiles(); }
+
+  void RemoveFiles() {
+    remove("fsm_test.db");
+    remove("fsm_test.log");
+    remove("fsm_test.fsm");
+  }
+
+  static auto FileSize(const std::string &file_name) -> int64_t {
+    struct stat stat_buf;
+    return stat(file_name.c_str(), &stat_buf) == 0 ? stat_buf.st_size : -1;
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(FreePageMapTest, SampleTest) {
+  FreePageMap map;
+  EXPECT_EQ(INVALID_PAGE_ID, map.Take(100, 1, 0));
+
+  map.Free(70);
+  map.Free(3);
+  map.Free(3);
+  // A page id in the second bitmap page.
+  const page_id_t far_page_id = FreePageMap::PAGES_PER_BITMAP_PAGE + 7232;
+  map.Free(far_page_id);
+  EXPECT_EQ(3, map.Size());
+  EXPECT_EQ(2, map.NumBitmapPages());
+
+  // Scenario: the lowest free page below the limit comes first.
+  EXPECT_EQ(3, map.Take(100, 1, 0));
+  EXPECT_EQ(70, map.Take(100, 1, 0));
+  EXPECT_EQ(INVALID_PAGE_ID, map.Take(100, 1, 0));
+  EXPECT_EQ(far_page_id, map.Take(far_page_id + 10000, 1, 0));
+  EXPECT_EQ(0, map.Size());
+
+  // Scenario: a parallel buffer pool instance only takes the page ids it owns.
+  map.Free(4);
+  map.Free(5);
+  map.Free(9);
+  EXPECT_EQ(5, map.Take(100, 4, 1));
+  EXPECT_EQ(9, map.Take(100, 4, 1));
+  EXPECT_EQ(INVALID_PAGE_ID, map.Take(100, 4, 1));
+  map.Use(4);
+  EXPECT_EQ(INVALID_PAGE_ID, map.Take(100, 4, 0));
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreePageMapTest, PersistTest) {
+  {
+    DiskManager dm("fsm_test.db");
+    char data[BUSTUB_PAGE_SIZE] = {0};
+    for (page_id_t page_id = 0; page_id < 10; page_id++) {
+      dm.WritePage(page_id, data);
+    }
+    dm.DeallocatePage(2);
+    dm.DeallocatePage(7);
+    dm.ShutDown();
+  }
+
+  // Scenario: the free pages survive a restart.
+  DiskManager dm("fsm_test.db");
+  EXPECT_EQ(2, dm.GetNumFreePages());
+  EXPECT_EQ(2, dm.AllocateFreePage(10, 1, 0));
+  dm.MarkPageAllocated(7);
+  EXPECT_EQ(INVALID_PAGE_ID, dm.AllocateFreePage(10, 1, 0));
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreePageMapTest, ChurnKeepsFileSizeTest) {
+  auto *disk_manager = new DiskManager("fsm_test.db");
+  auto *bpm = new ParallelBufferPoolManager(2, 8, disk_manager);
+
+  // Scenario: pages are created and deleted over and over; the file stops growing once the working set is on disk.
+  const int working_set = 64;
+  std::vector<page_id_t> page_ids;
+  int64_t file_size = 0;
+  for (int round = 0; round < 20; round++) {
+    for (int i = 0; i < working_set; i++) {
+      page_id_t page_id;
+      Page *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "round %d", round);
+      page_ids.push_back(page_id);
+      bpm->UnpinPage(page_id, true);
+    }
+    bpm->FlushAllPages();
+    for (auto page_id : page_ids) {
+      EXPECT_LT(page_id, working_set);
+      ASSERT_TRUE(bpm->DeletePage(page_id));
+    }
+    page_ids.clear();
+    if (round == 0) {
+      file_size = FileSize("fsm_test.db");
+    }
+    EXPECT_EQ(file_size, FileSize("fsm_test.db"));
+  }
+  EXPECT_EQ(working_set, disk_manager->GetNumFreePages());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
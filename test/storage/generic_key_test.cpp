@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key_test.cpp
+//
+// Identification: test/storage/generic_key_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/generic_key.h"
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+/** @return the key of `values` under `schema` */
+template <size_t KeySize = 16>
+static auto MakeKey(const std::vector<Value> &values, Schema *schema) -> GenericKey<KeySize> {
+  GenericKey<KeySize> key;
+  key.SetFromKey(Tuple(values, schema));
+  return key;
+}
+
+/** @return the order of two keys the way the comparator orders keys it can not compile */
+static auto CompareValues(const std::vector<Value> &lhs, const std::vector<Value> &rhs) -> int {
+  for (size_t i = 0; i < lhs.size(); i++) {
+    if (lhs[i].CompareLessThan(rhs[i]) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs[i].CompareGreaterThan(rhs[i]) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, CompiledComparatorTest) {
+  std::mt19937_64 rng(42);
+
+  // Scenario: integer keys of every width compare like their Values, negative ones included.
+  const std::vector<std::pair<TypeId, int64_t>> types{{TypeId::TINYINT, INT8_MAX},
+                                                      {TypeId::SMALLINT, INT16_MAX},
+                                                      {TypeId::INTEGER, INT32_MAX},
+                                                      {TypeId::BIGINT, INT64_MAX}};
+  for (auto [type, max_value] : types) {
+    Schema schema({Column("a", type)});
+    GenericComparator<16> comparator(&schema);
+    ASSERT_TRUE(comparator.IsCompiled());
+    std::uniform_int_distribution<int64_t> values(-max_value, max_value);
+    for (int i = 0; i < 1000; i++) {
+      std::vector<Value> lhs{Value(TypeId::BIGINT, values(rng)).CastAs(type)};
+      std::vector<Value> rhs{i % 10 == 0 ? lhs[0] : Value(TypeId::BIGINT, values(rng)).CastAs(type)};
+      ASSERT_EQ(CompareValues(lhs, rhs), comparator(MakeKey(lhs, &schema), MakeKey(rhs, &schema)))
+          << lhs[0].ToString() << " vs " << rhs[0].ToString();
+    }
+  }
+
+  // Scenario: a key of several integer columns is ordered by the first column that differs.
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT), Column("c", TypeId::SMALLINT)});
+  GenericComparator<16> comparator(&schema);
+  ASSERT_TRUE(comparator.IsCompiled());
+  std::uniform_int_distribution<int32_t> small_values(-2, 2);
+  for (int i = 0; i < 1000; i++) {
+    std::vector<Value> lhs{Value(TypeId::INTEGER, small_values(rng)), Value(TypeId::BIGINT, int64_t{small_values(rng)}),
+                           Value(TypeId::SMALLINT, static_cast<int16_t>(small_values(rng)))};
+    std::vector<Value> rhs{Value(TypeId::INTEGER, small_values(rng)), Value(TypeId::BIGINT, int64_t{small_values(rng)}),
+                           Value(TypeId::SMALLINT, static_cast<int16_t>(small_values(rng)))};
+    ASSERT_EQ(CompareValues(lhs, rhs), comparator(MakeKey(lhs, &schema), MakeKey(rhs, &schema)));
+  }
+
+  // Scenario: the keys of the B+ tree tests, set from a bare integer, compare as integers too.
+  auto bigint_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> bigint_comparator(bigint_schema.get());
+  GenericKey<8> lhs;
+  GenericKey<8> rhs;
+  lhs.SetFromInteger(-5);
+  rhs.SetFromInteger(3);
+  EXPECT_EQ(-1, bigint_comparator(lhs, rhs));
+  EXPECT_EQ(1, bigint_comparator(rhs, lhs));
+  EXPECT_EQ(0, bigint_comparator(lhs, lhs));
+
+  // Scenario: a key with any other column falls back to comparing Values.
+  Schema varchar_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 4)});
+  GenericComparator<32> varchar_comparator(&varchar_schema);
+  EXPECT_FALSE(varchar_comparator.IsCompiled());
+  std::vector<Value> abc{Value(TypeId::INTEGER, 1), Value(TypeId::VARCHAR, "abc")};
+  std::vector<Value> abd{Value(TypeId::INTEGER, 1), Value(TypeId::VARCHAR, "abd")};
+  EXPECT_EQ(-1, varchar_comparator(MakeKey<32>(abc, &varchar_schema), MakeKey<32>(abd, &varchar_schema)));
+}
+
+}  // namespace bustub
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// header_page_test.cpp
+//
+// Identification: test/storage/header_page_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/header_page.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(HeaderPageTest, RecordTest) {
+  HeaderPage header_page;
+  header_page.Init();
+  EXPECT_EQ(BUSTUB_PAGE_SIZE, header_page.GetPageSize());
+  EXPECT_EQ(0, header_page.GetRecordCount());
+
+  EXPECT_TRUE(header_page.InsertRecord("foo_pk", 3));
+  EXPECT_TRUE(header_page.InsertRecord("bar_pk", 5));
+  EXPECT_FALSE(header_page.InsertRecord("foo_pk", 7));
+  EXPECT_TRUE(header_page.UpdateRecord("bar_pk", 9));
+  EXPECT_TRUE(header_page.DeleteRecord("foo_pk"));
+  EXPECT_FALSE(header_page.DeleteRecord("foo_pk"));
+
+  page_id_t root_id;
+  EXPECT_EQ(1, header_page.GetRecordCount());
+  EXPECT_FALSE(header_page.GetRootId("foo_pk", &root_id));
+  EXPECT_TRUE(header_page.GetRootId("bar_pk", &root_id));
+  EXPECT_EQ(9, root_id);
+  EXPECT_EQ(BUSTUB_PAGE_SIZE, header_page.GetPageSize());
+}
+
+// NOLINTNEXTLINE
+TEST(HeaderPageTest, PageSizeTest) {
+  remove("header_page_test.db");
+  remove("header_page_test.log");
+  remove("header_page_test.fsm");
+  {
+    DiskManager disk_manager("header_page_test.db");
+    BufferPoolManagerInstance bpm(4, &disk_manager);
+
+    // Scenario: a header page that was never initialized is stamped with the page size on first use.
+    page_id_t page_id;
+    auto *header_page = static_cast<HeaderPage *>(bpm.NewPage(&page_id));
+    ASSERT_EQ(HEADER_PAGE_ID, page_id);
+    EXPECT_EQ(0, header_page->GetPageSize());
+    EXPECT_TRUE(header_page->InsertRecord("foo_pk", 1));
+    EXPECT_EQ(BUSTUB_PAGE_SIZE, header_page->GetPageSize());
+
+    // Scenario: a database created with another page size is rejected.
+    const int other_page_size = BUSTUB_PAGE_SIZE * 2;
+    memcpy(header_page->GetData() + sizeof(int), &other_page_size, sizeof(int));
+    bpm.UnpinPage(page_id, true);
+    bpm.FlushAllPages();
+  }
+
+  DiskManager disk_manager("header_page_test.db");
+  BufferPoolManagerInstance bpm(4, &disk_manager);
+  auto *header_page = static_cast<HeaderPage *>(bpm.FetchPage(HEADER_PAGE_ID));
+  ASSERT_NE(nullptr, header_page);
+  page_id_t root_id;
+  EXPECT_THROW(header_page->GetRootId("foo_pk", &root_id), Exception);
+  EXPECT_THROW(header_page->InsertRecord("bar_pk", 2), Exception);
+  bpm.UnpinPage(HEADER_PAGE_ID, false);
+  disk_manager.ShutDown();
+
+  // Scenario: opening the database fails right away, before any index reads the header page.
+  EXPECT_THROW(std::make_unique<BustubInstance>("header_page_test.db"), Exception);
+  BustubInstanceOptions read_only;
+  read_only.read_only_ = true;
+  EXPECT_THROW(std::make_unique<BustubInstance>("header_page_test.db", read_only), Exception);
+
+  remove("header_page_test.db");
+  remove("header_page_test.log");
+  remove("header_page_test.fsm");
+}
+
+// NOLINTNEXTLINE
+TEST(HeaderPageTest, LegacyHeaderPageTest) {
+  // Scenario: a header page from before the page size was recorded, its records right after RecordCount. The name of
+  // the first record is empty, so the bytes where the page size is now are all zeros.
+  HeaderPage header_page;
+  const int record_count = 2;
+  const page_id_t root_ids[] = {3, 9};
+  memcpy(header_page.GetData(), &record_count, sizeof(int));
+  memcpy(header_page.GetData() + 4 + 32, &root_ids[0], sizeof(page_id_t));
+  memcpy(header_page.GetData() + 4 + 36, "foo_pk", 7);
+  memcpy(header_page.GetData() + 4 + 36 + 32, &root_ids[1], sizeof(page_id_t));
+  EXPECT_EQ(0, header_page.GetPageSize());
+
+  page_id_t root_id;
+  if (BUSTUB_PAGE_SIZE != 4096) {
+    // Scenario: those databases used 4 KB pages, which this build cannot read.
+    EXPECT_THROW(header_page.GetRootId("foo_pk", &root_id), Exception);
+    return;
+  }
+
+  // Scenario: with 4 KB pages, the header page is moved to the current format and keeps its records.
+  EXPECT_TRUE(header_page.GetRootId("foo_pk", &root_id));
+  EXPECT_EQ(9, root_id);
+  EXPECT_TRUE(header_page.GetRootId("", &root_id));
+  EXPECT_EQ(3, root_id);
+  EXPECT_EQ(BUSTUB_PAGE_SIZE, header_page.GetPageSize());
+  EXPECT_EQ(2, header_page.GetRecordCount());
+  EXPECT_TRUE(header_page.InsertRecord("bar_pk", 4));
+  EXPECT_TRUE(header_page.GetRootId("foo_pk", &root_id));
+  EXPECT_EQ(9, root_id);
+}
+
+}  // namespace bustub
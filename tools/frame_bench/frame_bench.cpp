@@ -0,0 +1,128 @@
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/config.h"
+#include "common/exception.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+
+/**
+ * Fetch-heavy workload on a buffer pool whose pages are all resident: every operation fetches a random page, reads a
+ * word at a random offset of its data and unpins it. The cost is then dominated by the page table, the frame metadata
+ * and the TLB misses on the frame data, which is what the layout of the frames changes. Runs the workload with the
+ * frames on ordinary pages and on huge pages, for each number of threads.
+ */
+
+using bustub::BUSTUB_PAGE_SIZE;
+using bustub::page_id_t;
+
+static const size_t BUSTUB_BENCH_POOL_MB = 512;
+static const size_t BUSTUB_BENCH_OPS = 2000000;
+
+/** @return the anonymous memory of this process backed by transparent huge pages, in KB, or 0 if unknown */
+auto AnonHugePagesKb() -> size_t {
+  std::ifstream smaps("/proc/self/smaps_rollup");
+  std::string field;
+  size_t kb;
+  while (smaps >> field) {
+    if (field == "AnonHugePages:" && smaps >> kb) {
+      return kb;
+    }
+  }
+  return 0;
+}
+
+void RunFetchBench(bool huge_pages, size_t pool_size, size_t num_threads, size_t num_ops) {
+  bustub::buffer_pool_huge_pages = huge_pages;
+  bustub::DiskManagerUnlimitedMemory disk_manager;
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(pool_size, &disk_manager);
+  for (size_t i = 0; i < pool_size; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    if (page == nullptr) {
+      throw bustub::Exception("buffer pool is full");
+    }
+    page->GetData()[BUSTUB_PAGE_SIZE - 1] = 1;
+    bpm->UnpinPage(page_id, true);
+  }
+
+  std::atomic<uint64_t> checksum{0};
+  std::vector<std::thread> threads;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t thread_id = 0; thread_id < num_threads; thread_id++) {
+    threads.emplace_back([&, thread_id] {
+      std::mt19937_64 rng(thread_id);
+      uint64_t sum = 0;
+      for (size_t i = 0; i < num_ops / num_threads; i++) {
+        const uint64_t r = rng();
+        const auto page_id = static_cast<page_id_t>(r % pool_size);
+        auto *page = bpm->FetchPage(page_id);
+        sum += static_cast<unsigned char>(page->GetData()[(r >> 32) % BUSTUB_PAGE_SIZE]);
+        bpm->UnpinPage(page_id, false);
+      }
+      checksum += sum;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const auto &arena = bpm->GetFrameArena();
+  fmt::print("{:<12} {:>8} {:>14.0f} {:>14} {:>14}\n", huge_pages ? "huge" : "4k", num_threads,
+             static_cast<double>(num_ops) / seconds, arena.GetHugeTlbBytes() / 1024 / 1024, AnonHugePagesKb() / 1024);
+  if (checksum == 0) {
+    throw bustub::Exception("pages were not read");
+  }
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-frame-bench");
+  program.add_argument("--pool-mb").help("size of the buffer pool in MB");
+  program.add_argument("--ops").help("number of fetches per run");
+  program.add_argument("--threads").help("comma-separated numbers of threads").default_value(std::string("1,4"));
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t pool_mb = BUSTUB_BENCH_POOL_MB;
+  size_t num_ops = BUSTUB_BENCH_OPS;
+  if (program.present("--pool-mb")) {
+    pool_mb = std::stoul(program.get("--pool-mb"));
+  }
+  if (program.present("--ops")) {
+    num_ops = std::stoul(program.get("--ops"));
+  }
+  std::vector<size_t> thread_counts;
+  std::stringstream threads_arg(program.get("--threads"));
+  for (std::string count; std::getline(threads_arg, count, ',');) {
+    thread_counts.push_back(std::stoul(count));
+  }
+
+  const size_t pool_size = pool_mb * 1024 * 1024 / BUSTUB_PAGE_SIZE;
+  fmt::print("page size: {} bytes, pool: {} MB ({} frames), frame metadata: {} bytes\n", BUSTUB_PAGE_SIZE, pool_mb,
+             pool_size, sizeof(bustub::Page));
+  fmt::print("{:<12} {:>8} {:>14} {:>14} {:>14}\n", "frames", "threads", "fetches/s", "hugetlb MB", "thp MB");
+  for (auto num_threads : thread_counts) {
+    for (bool huge_pages : {false, true}) {
+      RunFetchBench(huge_pages, pool_size, num_threads, num_ops);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,159 @@
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/config.h"
+#include "common/exception.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/b_plus_tree_key_search.h"
+#include "test_util.h"  // NOLINT
+
+/**
+ * Compares the two searches of the keys of a B+ tree node, for GenericKey<8> keys of one BIGINT column: the search
+ * decoding each key and calling the comparator on it, and the search comparing the encoded keys in place (with AVX2
+ * when the CPU has it). Runs random searches in a single leaf page filled with as many keys as fit, then random
+ * lookups in a bulk loaded tree whose pages all stay in the buffer pool, so only the CPU cost of descending the tree
+ * is measured.
+ */
+
+using bustub::BUSTUB_PAGE_SIZE;
+using bustub::page_id_t;
+
+static const size_t BUSTUB_BENCH_KEYS = 1000000;
+static const size_t BUSTUB_BENCH_NODE_SEARCHES = 5000000;
+static const size_t BUSTUB_BENCH_LOOKUPS = 1000000;
+
+using Key = bustub::GenericKey<8>;
+using Comparator = bustub::GenericComparator<8>;
+using Tree = bustub::BPlusTree<Key, bustub::RID, Comparator>;
+using LeafPage = bustub::BPlusTreeLeafPage<Key, bustub::RID, Comparator>;
+
+auto Seconds(std::chrono::steady_clock::time_point start) -> double {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+auto SearchName(bool in_place) -> std::string {
+  if (!in_place) {
+    return "comparator";
+  }
+#ifdef BUSTUB_KEY_SEARCH_AVX2
+  if (bustub::key_search::HasAvx2()) {
+    return "in-place avx2";
+  }
+#endif
+  return "in-place scalar";
+}
+
+/** @return the searches per second in a full leaf of even keys, searched for keys in and between them */
+auto RunNodeBench(const Comparator &comparator, size_t num_searches) -> double {
+  std::vector<char> page(BUSTUB_PAGE_SIZE);
+  auto *leaf = reinterpret_cast<LeafPage *>(page.data());
+  const auto format = bustub::KeyFormat::Of(comparator);
+  leaf->Init(0, bustub::INVALID_PAGE_ID, 2 * LeafPage::GetCapacity(format), format);
+  int n = 0;
+  Key key;
+  for (key.SetFromInteger(0); leaf->HasRoomFor(key); key.SetFromInteger(2 * n)) {
+    leaf->InsertAtBack(key, bustub::RID(n));
+    n++;
+  }
+  std::vector<Key> targets(1024);
+  std::mt19937_64 rng(0);
+  for (auto &target : targets) {
+    target.SetFromInteger(static_cast<int64_t>(rng() % (2 * n)));
+  }
+
+  uint64_t checksum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_searches; i++) {
+    checksum += leaf->BinarySearchByKey(targets[i % targets.size()], comparator);
+  }
+  const double seconds = Seconds(start);
+  if (checksum == 0) {
+    throw bustub::Exception("nothing was searched");
+  }
+  return static_cast<double>(num_searches) / seconds;
+}
+
+/** @return the lookups per second of random keys in the tree */
+auto RunTreeBench(Tree *tree, size_t num_keys, size_t num_lookups) -> double {
+  bustub::Transaction txn(0);
+  std::mt19937_64 rng(0);
+  std::vector<bustub::RID> result;
+  Key index_key;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_lookups; i++) {
+    index_key.SetFromInteger(static_cast<int64_t>(rng() % num_keys));
+    result.clear();
+    if (!tree->GetValue(index_key, &result, &txn)) {
+      throw bustub::Exception("key not found");
+    }
+  }
+  return static_cast<double>(num_lookups) / Seconds(start);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-key-search-bench");
+  program.add_argument("--keys").help("number of keys in the tree");
+  program.add_argument("--searches").help("number of searches in a single node");
+  program.add_argument("--lookups").help("number of lookups in the tree");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_keys = BUSTUB_BENCH_KEYS;
+  size_t num_searches = BUSTUB_BENCH_NODE_SEARCHES;
+  size_t num_lookups = BUSTUB_BENCH_LOOKUPS;
+  if (program.present("--keys")) {
+    num_keys = std::stoul(program.get("--keys"));
+  }
+  if (program.present("--searches")) {
+    num_searches = std::stoul(program.get("--searches"));
+  }
+  if (program.present("--lookups")) {
+    num_lookups = std::stoul(program.get("--lookups"));
+  }
+
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+  Comparator comparator(key_schema.get());
+  bustub::DiskManagerUnlimitedMemory disk_manager;
+  // Room for every page of the tree, which holds 90% full nodes of a few hundred keys.
+  const size_t pool_size = num_keys / 200 + 64;
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(pool_size, &disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Tree tree("key_search_bench", bpm.get(), comparator);
+  auto sorter = tree.NewBulkLoadSorter();
+  Key index_key;
+  for (size_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(static_cast<int64_t>(key));
+    sorter->Add({index_key, bustub::RID(static_cast<int64_t>(key))});
+  }
+  tree.BulkLoad(sorter.get());
+
+  fmt::print("{} keys, {} searches in a node, {} lookups in the tree\n", num_keys, num_searches, num_lookups);
+  fmt::print("{:<18} {:>16} {:>16}\n", "search", "node searches/s", "tree lookups/s");
+  for (bool in_place : {false, true}) {
+    bustub::simd_key_search = in_place;
+    const double node_rate = RunNodeBench(comparator, num_searches);
+    const double tree_rate = RunTreeBench(&tree, num_keys, num_lookups);
+    fmt::print("{:<18} {:>16.0f} {:>16.0f}\n", SearchName(in_place), node_rate, tree_rate);
+  }
+  bustub::simd_key_search = true;
+  return 0;
+}
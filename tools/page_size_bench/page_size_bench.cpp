@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/mmap_buffer_pool_manager.h"
+#include "common/exception.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+/**
+ * Shows what the page size of the build trades: B+tree fan-out and scan bandwidth against the bytes read per random
+ * page access. The page size is fixed when configuring the build, so run this once per build:
+ *
+ *   cmake -DBUSTUB_PAGE_SIZE=16384 -DCMAKE_BUILD_TYPE=Release .. && make page-size-bench && ./bin/bustub-page-size-bench
+ *
+ * The buffer pool is sized in bytes, so every page size gets the same amount of memory.
+ */
+
+using bustub::BUSTUB_PAGE_SIZE;
+using bustub::page_id_t;
+
+static const size_t BUSTUB_BENCH_POOL_MB = 4;
+static const size_t BUSTUB_BENCH_DATA_MB = 64;
+static const size_t BUSTUB_BENCH_KEYS = 1000000;
+static const size_t BUSTUB_BENCH_LOOKUPS = 20000;
+static const size_t BUSTUB_BENCH_RANDOM_READS = 2000;
+
+using Key = bustub::GenericKey<8>;
+using Comparator = bustub::GenericComparator<8>;
+using Tree = bustub::BPlusTree<Key, bustub::RID, Comparator>;
+using InternalPage = bustub::BPlusTreeInternalPage<Key, page_id_t, Comparator>;
+
+auto Seconds(std::chrono::steady_clock::time_point start) -> double {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+auto PoolFrames(size_t pool_mb) -> size_t { return std::max<size_t>(pool_mb * 1024 * 1024 / BUSTUB_PAGE_SIZE, 16); }
+
+/** @return the number of levels from the root of the tree down to its leaves */
+auto TreeHeight(bustub::BufferPoolManager *bpm, page_id_t root_page_id) -> int {
+  int height = 1;
+  page_id_t page_id = root_page_id;
+  while (true) {
+    auto *page = bpm->FetchPage(page_id);
+    auto *node = reinterpret_cast<bustub::BPlusTreePage *>(page->GetData());
+    if (node->IsLeafPage()) {
+      bpm->UnpinPage(page_id, false);
+      return height;
+    }
+    page_id_t child = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    bpm->UnpinPage(page_id, false);
+    page_id = child;
+    height++;
+  }
+}
+
+/** Load a B+tree with random keys, then look up random keys with a buffer pool smaller than the tree. */
+void RunIndexBench(const std::string &db_file, size_t pool_mb, size_t num_keys, size_t num_lookups) {
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+  Comparator comparator(key_schema.get());
+  auto disk_manager = std::make_unique<bustub::DiskManager>(db_file);
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(PoolFrames(pool_mb), disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  std::vector<int64_t> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<int64_t>(i);
+  }
+  std::mt19937_64 rng(0);
+  std::shuffle(keys.begin(), keys.end(), rng);
+
+  Tree tree("page_size_bench", bpm.get(), comparator);
+  bustub::Transaction txn(0);
+  Key index_key;
+  auto start = std::chrono::steady_clock::now();
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, bustub::RID(static_cast<page_id_t>(key >> 32), static_cast<uint32_t>(key)), &txn);
+  }
+  const double load_seconds = Seconds(start);
+  const int height = TreeHeight(bpm.get(), tree.GetRootPageId());
+
+  const auto before = bpm->GetStats();
+  std::vector<bustub::RID> result;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_lookups; i++) {
+    index_key.SetFromInteger(static_cast<int64_t>(rng() % num_keys));
+    result.clear();
+    if (!tree.GetValue(index_key, &result, &txn)) {
+      throw bustub::Exception("key not found");
+    }
+  }
+  const double lookup_seconds = Seconds(start);
+  const auto after = bpm->GetStats();
+  const auto misses = after.misses_ - before.misses_;
+
+  // Keys are stored compressed, so how many fit depends on the keys; these are the most a node may hold.
+  fmt::print("{:<28} {:>12}\n", "max leaf fan-out", tree.GetLeafMaxSize() - 1);
+  fmt::print("{:<28} {:>12}\n", "max inner fan-out", tree.GetInternalMaxSize());
+  fmt::print("{:<28} {:>12}\n", "tree height", height);
+  fmt::print("{:<28} {:>12.0f}\n", "inserts/s", static_cast<double>(num_keys) / load_seconds);
+  fmt::print("{:<28} {:>12.0f}\n", "lookups/s", static_cast<double>(num_lookups) / lookup_seconds);
+  fmt::print("{:<28} {:>12.2f}\n", "page reads per lookup", static_cast<double>(misses) / num_lookups);
+  fmt::print("{:<28} {:>12.1f}\n", "KB read per lookup",
+             static_cast<double>(misses) * BUSTUB_PAGE_SIZE / 1024 / static_cast<double>(num_lookups));
+  bpm.reset();
+  disk_manager->ShutDown();
+}
+
+/**
+ * Write a file of pages, then read all of it sequentially and a sample of it at random through the buffer pool, and
+ * sequentially again through a read-only mapping of the file.
+ */
+void RunScanBench(const std::string &db_file, bool direct_io, size_t pool_mb, size_t data_mb, size_t num_reads) {
+  const auto num_pages = static_cast<page_id_t>(std::max<size_t>(data_mb * 1024 * 1024 / BUSTUB_PAGE_SIZE, 1));
+  auto disk_manager = std::make_unique<bustub::DiskManager>(db_file, direct_io);
+  {
+    std::vector<char> data(BUSTUB_PAGE_SIZE, 'x');
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      disk_manager->WritePage(page_id, data.data());
+    }
+  }
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(PoolFrames(pool_mb), disk_manager.get());
+  auto read = [&bpm](page_id_t page_id) {
+    if (bpm->FetchPage(page_id) == nullptr) {
+      throw bustub::Exception("buffer pool is full");
+    }
+    bpm->UnpinPage(page_id, false);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    read(page_id);
+  }
+  const double scan_seconds = Seconds(start);
+
+  std::mt19937_64 rng(0);
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_reads; i++) {
+    read(static_cast<page_id_t>(rng() % num_pages));
+  }
+  const double random_seconds = Seconds(start);
+  bpm.reset();
+
+  // The pages are served from the OS page cache; touch one word per cache line, like a scan that reads every tuple.
+  double mmap_seconds;
+  {
+    bustub::MmapBufferPoolManager mmap_bpm(db_file);
+    uint64_t sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      const char *data = mmap_bpm.FetchPage(page_id)->GetData();
+      for (int off = 0; off < BUSTUB_PAGE_SIZE; off += 64) {
+        sum += static_cast<unsigned char>(data[off]);
+      }
+      mmap_bpm.UnpinPage(page_id, false);
+    }
+    mmap_seconds = Seconds(start);
+    if (sum == 0) {
+      throw bustub::Exception("pages were not read");
+    }
+  }
+
+  const double mb = static_cast<double>(num_pages) * BUSTUB_PAGE_SIZE / 1024 / 1024;
+  fmt::print("{:<28} {:>12.1f}\n", "scan MB/s", mb / scan_seconds);
+  fmt::print("{:<28} {:>12.1f}\n", "read-only mmap scan MB/s", mb / mmap_seconds);
+  fmt::print("{:<28} {:>12.0f}\n", "scan page reads/s", num_pages / scan_seconds);
+  fmt::print("{:<28} {:>12.0f}\n", "random page reads/s", num_reads / random_seconds);
+  fmt::print("{:<28} {:>12.1f}\n", "random MB/s",
+             static_cast<double>(num_reads) * BUSTUB_PAGE_SIZE / 1024 / 1024 / random_seconds);
+  disk_manager->ShutDown();
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-page-size-bench");
+  program.add_argument("--db-file").help("database file to run on").default_value(std::string("page_size_bench.db"));
+  program.add_argument("--direct-io").help("bypass the OS page cache").default_value(false).implicit_value(true);
+  program.add_argument("--pool-mb").help("size of the buffer pool in MB");
+  program.add_argument("--data-mb").help("size of the scanned file in MB");
+  program.add_argument("--keys").help("number of keys in the B+ tree");
+  program.add_argument("--lookups").help("number of B+ tree point lookups");
+  program.add_argument("--random-reads").help("number of random page reads");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t pool_mb = BUSTUB_BENCH_POOL_MB;
+  size_t data_mb = BUSTUB_BENCH_DATA_MB;
+  size_t num_keys = BUSTUB_BENCH_KEYS;
+  size_t num_lookups = BUSTUB_BENCH_LOOKUPS;
+  size_t num_reads = BUSTUB_BENCH_RANDOM_READS;
+  if (program.present("--pool-mb")) {
+    pool_mb = std::stoul(program.get("--pool-mb"));
+  }
+  if (program.present("--data-mb")) {
+    data_mb = std::stoul(program.get("--data-mb"));
+  }
+  if (program.present("--keys")) {
+    num_keys = std::stoul(program.get("--keys"));
+  }
+  if (program.present("--lookups")) {
+    num_lookups = std::stoul(program.get("--lookups"));
+  }
+  if (program.present("--random-reads")) {
+    num_reads = std::stoul(program.get("--random-reads"));
+  }
+  const auto db_file = program.get<std::string>("--db-file");
+  const auto direct_io = program.get<bool>("--direct-io");
+
+  fmt::print("page size: {} bytes, pool: {} MB ({} frames)\n", BUSTUB_PAGE_SIZE, pool_mb, PoolFrames(pool_mb));
+  auto remove_files = [&db_file]() {
+    auto base = db_file.substr(0, db_file.rfind('.'));
+    for (const auto &file : {db_file, base + ".log", base + ".fsm"}) {
+      std::remove(file.c_str());
+    }
+  };
+  remove_files();
+  RunIndexBench(db_file, pool_mb, num_keys, num_lookups);
+  remove_files();
+  RunScanBench(db_file, direct_io, pool_mb, data_mb, num_reads);
+  remove_files();
+  return 0;
+}
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/exception.h"
+#include "common/util/string_util.h"
+#include "fmt/core.h"
+
+/**
+ * Replays a page access trace against every replacement policy and reports the hit ratio and the cost of the replacer
+ * calls per access. The buffer pool itself is simulated: a miss evicts a victim frame and loads the page into it,
+ * exactly like BufferPoolManagerInstance does, but without any disk I/O.
+ */
+
+using bustub::frame_id_t;
+using bustub::page_id_t;
+
+static const size_t BUSTUB_BENCH_POOL_SIZE = 1024;
+static const size_t BUSTUB_BENCH_NUM_PAGES = 16384;
+static const size_t BUSTUB_BENCH_NUM_ACCESSES = 1000000;
+
+/** Zipfian trace: a few pages are hot, most are cold. */
+auto GenerateZipfTrace(size_t num_pages, size_t num_accesses, double theta, std::mt19937_64 *rng)
+    -> std::vector<page_id_t> {
+  std::vector<double> cdf(num_pages);
+  double sum = 0;
+  for (size_t i = 0; i < num_pages; i++) {
+    sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+    cdf[i] = sum;
+  }
+  std::uniform_real_distribution<double> dist(0, sum);
+  std::vector<page_id_t> trace;
+  trace.reserve(num_accesses);
+  for (size_t i = 0; i < num_accesses; i++) {
+    auto rank = std::lower_bound(cdf.begin(), cdf.end(), dist(*rng)) - cdf.begin();
+    // Scatter the hot pages over the id space so that they do not share frames by accident.
+    trace.push_back(static_cast<page_id_t>((rank * 7919) % num_pages));
+  }
+  return trace;
+}
+
+/** Zipfian trace interleaved with scans of twice the pool size over pages that are never reused. */
+auto GenerateScanTrace(size_t num_pages, size_t num_accesses, double theta, size_t pool_size, std::mt19937_64 *rng)
+    -> std::vector<page_id_t> {
+  auto trace = GenerateZipfTrace(num_pages, num_accesses, theta, rng);
+  auto next_scan_page = static_cast<page_id_t>(num_pages);
+  const size_t scan_every = 10000;
+  const size_t scan_length = 2 * pool_size;
+  std::vector<page_id_t> mixed;
+  mixed.reserve(num_accesses + num_accesses / scan_every * scan_length);
+  for (size_t i = 0; i < trace.size(); i++) {
+    if (i % scan_every == 0) {
+      for (size_t j = 0; j < scan_length; j++) {
+        mixed.push_back(next_scan_page++);
+      }
+    }
+    mixed.push_back(trace[i]);
+  }
+  return mixed;
+}
+
+/** Reads whitespace-separated page ids. */
+auto ReadTrace(const std::string &path) -> std::vector<page_id_t> {
+  std::ifstream in(path);
+  if (!in) {
+    throw bustub::Exception(fmt::format("cannot open trace file: {}", path));
+  }
+  std::vector<page_id_t> trace;
+  page_id_t page_id;
+  while (in >> page_id) {
+    trace.push_back(page_id);
+  }
+  return trace;
+}
+
+struct ReplayResult {
+  size_t hits_{0};
+  size_t misses_{0};
+  double ns_per_op_{0};
+};
+
+auto Replay(bustub::ReplacerType replacer_type, size_t pool_size, size_t k, const std::vector<page_id_t> &trace)
+    -> ReplayResult {
+  auto replacer = bustub::Replacer::Create(replacer_type, pool_size, k);
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_to_page(pool_size, bustub::INVALID_PAGE_ID);
+  page_table.reserve(pool_size * 2);
+  size_t next_free_frame = 0;
+  ReplayResult result;
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto page_id : trace) {
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      result.hits_++;
+      replacer->RecordAccess(it->second);
+      replacer->SetEvictable(it->second, true);
+      continue;
+    }
+    result.misses_++;
+    frame_id_t frame_id;
+    if (next_free_frame < pool_size) {
+      frame_id = static_cast<frame_id_t>(next_free_frame++);
+    } else {
+      if (!replacer->Evict(&frame_id)) {
+        throw bustub::Exception("replacer has no victim although every frame is unpinned");
+      }
+      page_table.erase(frame_to_page[frame_id]);
+    }
+    page_table[page_id] = frame_id;
+    frame_to_page[frame_id] = page_id;
+    replacer->SetPageId(frame_id, page_id);
+    replacer->RecordAccess(frame_id);
+    replacer->SetEvictable(frame_id, true);
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  result.ns_per_op_ = trace.empty() ? 0 : elapsed / static_cast<double>(trace.size());
+  return result;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-bench");
+  program.add_argument("--trace").help("file of whitespace-separated page ids to replay");
+  program.add_argument("--workload").help("synthetic workload when no trace is given: zipf (default) or scan");
+  program.add_argument("--pool-size").help("number of frames in the simulated buffer pool");
+  program.add_argument("--pages").help("number of distinct pages in the synthetic workload");
+  program.add_argument("--accesses").help("number of accesses in the synthetic workload");
+  program.add_argument("--theta").help("skew of the synthetic workload");
+  program.add_argument("--k").help("lookback constant of the LRU-K policy");
+  program.add_argument("--policies").help("comma-separated policies to run, e.g. lru,lru-k,arc (default: all)");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t pool_size = BUSTUB_BENCH_POOL_SIZE;
+  size_t num_pages = BUSTUB_BENCH_NUM_PAGES;
+  size_t num_accesses = BUSTUB_BENCH_NUM_ACCESSES;
+  size_t k = bustub::LRUK_REPLACER_K;
+  double theta = 0.99;
+  if (program.present("--pool-size")) {
+    pool_size = std::stoul(program.get("--pool-size"));
+  }
+  if (program.present("--pages")) {
+    num_pages = std::stoul(program.get("--pages"));
+  }
+  if (program.present("--accesses")) {
+    num_accesses = std::stoul(program.get("--accesses"));
+  }
+  if (program.present("--k")) {
+    k = std::stoul(program.get("--k"));
+  }
+  if (program.present("--theta")) {
+    theta = std::stod(program.get("--theta"));
+  }
+
+  std::vector<bustub::ReplacerType> policies{bustub::ReplacerType::LRU, bustub::ReplacerType::CLOCK,
+                                             bustub::ReplacerType::LRU_K, bustub::ReplacerType::ARC,
+                                             bustub::ReplacerType::TWO_QUEUE};
+  if (program.present("--policies")) {
+    policies.clear();
+    for (const auto &name : bustub::StringUtil::Split(program.get("--policies"), ',')) {
+      policies.push_back(bustub::Replacer::ParseReplacerType(name));
+    }
+  }
+
+  std::vector<page_id_t> trace;
+  std::string trace_name;
+  std::mt19937_64 rng(0);
+  if (program.present("--trace")) {
+    trace_name = program.get("--trace");
+    trace = ReadTrace(trace_name);
+  } else {
+    std::string workload = program.present("--workload") ? program.get("--workload") : "zipf";
+    if (workload == "zipf") {
+      trace = GenerateZipfTrace(num_pages, num_accesses, theta, &rng);
+    } else if (workload == "scan") {
+      trace = GenerateScanTrace(num_pages, num_accesses, theta, pool_size, &rng);
+    } else {
+      std::cerr << "unknown workload: " << workload << std::endl;
+      return 1;
+    }
+    trace_name = fmt::format("{} (pages={}, theta={})", workload, num_pages, theta);
+  }
+
+  fmt::print("trace: {}, accesses: {}, pool size: {}\n", trace_name, trace.size(), pool_size);
+  fmt::print("{:<8} {:>10} {:>12} {:>10}\n", "policy", "hit ratio", "misses", "ns/op");
+  for (auto policy : policies) {
+    auto result = Replay(policy, pool_size, k, trace);
+    auto total = result.hits_ + result.misses_;
+    auto hit_ratio = total == 0 ? 0 : static_cast<double>(result.hits_) / static_cast<double>(total);
+    fmt::print("{:<8} {:>10.4f} {:>12} {:>10.1f}\n", bustub::Replacer::ReplacerTypeToString(policy), hit_ratio,
+               result.misses_, result.ns_per_op_);
+  }
+  return 0;
+}
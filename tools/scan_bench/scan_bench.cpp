@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/buffer_ring.h"
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_simulated.h"
+#include "storage/table/table_heap.h"
+
+/**
+ * Mixed workload: full scans of a large table interleaved with point lookups in an index that fits in the buffer
+ * pool. The index is modelled as root, inner and leaf pages that every lookup walks, like a B+tree. Runs the workload
+ * once with the scans going through the shared pool and once with a bulk read ring, and reports how many index pages
+ * had to be read back because the scans pushed them out of the pool.
+ */
+
+using bustub::page_id_t;
+
+static const size_t BUSTUB_BENCH_POOL_SIZE = 256;
+static const size_t BUSTUB_BENCH_TABLE_TUPLES = 4000;
+static const size_t BUSTUB_BENCH_INDEX_LEAVES = 128;
+static const size_t BUSTUB_BENCH_SCANS = 5;
+static const size_t BUSTUB_BENCH_LOOKUPS_PER_TUPLE = 1;
+
+/** A simulated disk that counts reads of index pages. */
+class BenchDiskManager : public bustub::DiskManagerSimulated {
+ public:
+  explicit BenchDiskManager(const bustub::DiskProfile &profile) : DiskManagerSimulated(profile) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    CountRead(page_id);
+    DiskManagerSimulated::ReadPage(page_id, page_data);
+  }
+
+  void ReadPages(const std::vector<PageIo> &pages) override {
+    for (const auto &page : pages) {
+      CountRead(page.page_id_);
+    }
+    DiskManagerSimulated::ReadPages(pages);
+  }
+
+  /** Pages below `page_id` belong to the index, the others to the table. */
+  void SetFirstTablePageId(page_id_t page_id) { first_table_page_id_ = page_id; }
+
+  void ResetCounters() {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    index_reads_ = 0;
+    table_reads_ = 0;
+  }
+
+  auto GetIndexReads() -> size_t {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return index_reads_;
+  }
+
+  auto GetTableReads() -> size_t {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return table_reads_;
+  }
+
+ private:
+  void CountRead(page_id_t page_id) {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    if (page_id < first_table_page_id_) {
+      index_reads_++;
+    } else {
+      table_reads_++;
+    }
+  }
+
+  std::mutex mutex_;
+  page_id_t first_table_page_id_{INT32_MAX};
+  size_t index_reads_{0};
+  size_t table_reads_{0};
+};
+
+struct BenchResult {
+  size_t lookups_{0};
+  size_t index_reads_{0};
+  size_t table_reads_{0};
+  double seconds_{0};
+};
+
+/** Three-level stand-in for a B+tree index: one root page, a few inner pages and many leaf pages. */
+struct IndexPages {
+  page_id_t root_;
+  std::vector<page_id_t> inner_;
+  std::vector<page_id_t> leaves_;
+};
+
+/** Fetch and unpin the root-to-leaf path of `key`, like a point lookup in a B+tree. */
+void Lookup(bustub::BufferPoolManager *bpm, const IndexPages &index, size_t key) {
+  const page_id_t leaf = index.leaves_[key % index.leaves_.size()];
+  const page_id_t inner = index.inner_[key % index.inner_.size()];
+  for (auto page_id : {index.root_, inner, leaf}) {
+    auto *page = bpm->FetchPage(page_id);
+    if (page == nullptr) {
+      throw bustub::Exception("buffer pool is full");
+    }
+    page->RLatch();
+    page->RUnlatch();
+    bpm->UnpinPage(page_id, false);
+  }
+}
+
+auto RunWorkload(bool use_ring, size_t pool_size, size_t num_tuples, size_t num_leaves, size_t num_scans,
+                 size_t lookups_per_tuple, const bustub::DiskProfile &disk_profile) -> BenchResult {
+  auto disk_manager = std::make_unique<BenchDiskManager>(disk_profile);
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(pool_size, disk_manager.get());
+  bustub::Transaction txn(0);
+
+  // The index: small enough to stay in the buffer pool when nothing else competes for it.
+  IndexPages index;
+  auto new_index_page = [&bpm]() {
+    page_id_t page_id;
+    if (bpm->NewPage(&page_id) == nullptr) {
+      throw bustub::Exception("buffer pool is full");
+    }
+    bpm->UnpinPage(page_id, true);
+    return page_id;
+  };
+  index.root_ = new_index_page();
+  for (size_t i = 0; i < std::max<size_t>(num_leaves / 64, 1); i++) {
+    index.inner_.push_back(new_index_page());
+  }
+  for (size_t i = 0; i < num_leaves; i++) {
+    index.leaves_.push_back(new_index_page());
+  }
+
+  // The table: many times larger than the buffer pool, loaded through a bulk write ring in both runs.
+  bustub::Schema schema(
+      {bustub::Column("id", bustub::TypeId::INTEGER), bustub::Column("payload", bustub::TypeId::VARCHAR, 1000)});
+  bustub::TableHeap heap(bpm.get(), nullptr, nullptr, &txn);
+  disk_manager->SetFirstTablePageId(heap.GetFirstPageId());
+  {
+    bustub::BufferRing load_ring(bpm.get(), bustub::BufferRing::RingType::BULK_WRITE);
+    const std::string payload(900, 'x');
+    for (size_t i = 0; i < num_tuples; i++) {
+      bustub::Tuple tuple({bustub::Value(bustub::TypeId::INTEGER, static_cast<int32_t>(i)),
+                           bustub::Value(bustub::TypeId::VARCHAR, payload)},
+                          &schema);
+      bustub::RID rid;
+      heap.InsertTuple(tuple, &rid, &txn, &load_ring);
+    }
+  }
+  txn.GetWriteSet()->clear();
+
+  // Warm up the index so that both runs start with it fully resident.
+  for (size_t key = 0; key < num_leaves; key++) {
+    Lookup(bpm.get(), index, key);
+  }
+  disk_manager->ResetCounters();
+
+  BenchResult result;
+  std::mt19937_64 rng(0);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t scan = 0; scan < num_scans; scan++) {
+    bustub::BufferRing scan_ring(bpm.get(), bustub::BufferRing::RingType::BULK_READ);
+    for (auto it = heap.Begin(&txn, use_ring ? &scan_ring : nullptr); it != heap.End(); ++it) {
+      for (size_t i = 0; i < lookups_per_tuple; i++) {
+        Lookup(bpm.get(), index, rng());
+        result.lookups_++;
+      }
+    }
+  }
+  result.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  result.index_reads_ = disk_manager->GetIndexReads();
+  result.table_reads_ = disk_manager->GetTableReads();
+  return result;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-scan-bench");
+  program.add_argument("--pool-size").help("number of frames in the buffer pool");
+  program.add_argument("--tuples").help("number of tuples in the scanned table, about 4 per page");
+  program.add_argument("--leaves").help("number of leaf pages in the index");
+  program.add_argument("--scans").help("number of full table scans");
+  program.add_argument("--lookups-per-tuple").help("index lookups between two tuples of a scan");
+  program.add_argument("--disk").help("simulated disk: ram, nvme, slow-ssd or cloud").default_value(std::string("ram"));
+  program.add_argument("--read-latency-us").help("constant latency of a page read in microseconds, overrides --disk");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t pool_size = BUSTUB_BENCH_POOL_SIZE;
+  size_t num_tuples = BUSTUB_BENCH_TABLE_TUPLES;
+  size_t num_leaves = BUSTUB_BENCH_INDEX_LEAVES;
+  size_t num_scans = BUSTUB_BENCH_SCANS;
+  size_t lookups_per_tuple = BUSTUB_BENCH_LOOKUPS_PER_TUPLE;
+  if (program.present("--pool-size")) {
+    pool_size = std::stoul(program.get("--pool-size"));
+  }
+  if (program.present("--tuples")) {
+    num_tuples = std::stoul(program.get("--tuples"));
+  }
+  if (program.present("--leaves")) {
+    num_leaves = std::stoul(program.get("--leaves"));
+  }
+  if (program.present("--scans")) {
+    num_scans = std::stoul(program.get("--scans"));
+  }
+  if (program.present("--lookups-per-tuple")) {
+    lookups_per_tuple = std::stoul(program.get("--lookups-per-tuple"));
+  }
+  auto disk_profile = bustub::DiskProfile::FromName(program.get("--disk"));
+  if (program.present("--read-latency-us")) {
+    disk_profile.read_p50_ = disk_profile.read_p99_ =
+        std::chrono::microseconds(std::stoul(program.get("--read-latency-us")));
+  }
+
+  fmt::print("pool size: {}, table tuples: {}, index leaves: {}, scans: {}, disk: {}\n", pool_size, num_tuples,
+             num_leaves, num_scans, program.get("--disk"));
+  fmt::print("{:<12} {:>10} {:>12} {:>12} {:>14}\n", "scan mode", "lookups", "index reads", "table reads",
+             "lookups/s");
+  for (bool use_ring : {false, true}) {
+    auto result =
+        RunWorkload(use_ring, pool_size, num_tuples, num_leaves, num_scans, lookups_per_tuple, disk_profile);
+    fmt::print("{:<12} {:>10} {:>12} {:>12} {:>14.0f}\n", use_ring ? "bulk ring" : "shared pool", result.lookups_,
+               result.index_reads_, result.table_reads_, static_cast<double>(result.lookups_) / result.seconds_);
+  }
+  return 0;
+}
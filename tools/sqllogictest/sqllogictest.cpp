@@ -147,6 +147,8 @@ auto main(int argc, char **argv) -> int {  // NOLINT
   program.add_argument("--verbose").help("increase output verbosity").default_value(false).implicit_value(true);
   program.add_argument("-d", "--diff").help("write diff file").default_value(false).implicit_value(true);
   program.add_argument("--in-memory").help("use in-memory backend").default_value(false).implicit_value(true);
+  program.add_argument("--io-uring").help("batch disk I/O through io_uring").default_value(false).implicit_value(true);
+  program.add_argument("--compress").help("store compressed pages").default_value(false).implicit_value(true);
 
   try {
     program.parse_args(argc, argv);
@@ -176,7 +178,10 @@ auto main(int argc, char **argv) -> int {  // NOLINT
   if (program.get<bool>("--in-memory")) {
     bustub = std::make_unique<bustub::BustubInstance>();
   } else {
-    bustub = std::make_unique<bustub::BustubInstance>("test.db");
+    bustub::BustubInstanceOptions options;
+    options.use_io_uring_ = program.get<bool>("--io-uring");
+    options.compress_pages_ = program.get<bool>("--compress");
+    bustub = std::make_unique<bustub::BustubInstance>("test.db", options);
   }
 
   bustub->GenerateMockTable();
@@ -120,6 +120,9 @@ auto main(int argc, char **argv) -> int {
   program.add_argument("--duration").help("run terrier bench for n milliseconds");
   program.add_argument("--force-create-index").help("create index in terrier bench");
   program.add_argument("--force-enable-update").help("use update statement in terrier bench");
+  program.add_argument("--db-file").help("run terrier bench on a database file instead of in memory");
+  program.add_argument("--io-uring").help("batch the disk I/O of --db-file through io_uring");
+  program.add_argument("--compress").help("store the pages of --db-file compressed");
 
   try {
     program.parse_args(argc, argv);
@@ -129,7 +132,15 @@ auto main(int argc, char **argv) -> int {
     return 1;
   }
 
-  auto bustub = std::make_unique<bustub::BustubInstance>();
+  std::unique_ptr<bustub::BustubInstance> bustub;
+  if (program.present("--db-file")) {
+    bustub::BustubInstanceOptions options;
+    options.use_io_uring_ = program.present("--io-uring") && ParseBool(program.get("--io-uring"));
+    options.compress_pages_ = program.present("--compress") && ParseBool(program.get("--compress"));
+    bustub = std::make_unique<bustub::BustubInstance>(program.get("--db-file"), options);
+  } else {
+    bustub = std::make_unique<bustub::BustubInstance>();
+  }
   auto writer = bustub::SimpleStreamWriter(std::cerr);
 
   // create schema